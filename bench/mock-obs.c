@@ -0,0 +1,2051 @@
+#include "mock-obs.h"
+
+#include <obs-module.h>
+#include <graphics/image-file.h>
+#include <util/darray.h>
+#include <util/dstr.h>
+#include <util/platform.h>
+#include <util/profiler.h>
+#include <util/threading.h>
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef MOCK_OBS_DATA_DIR
+#define MOCK_OBS_DATA_DIR "data"
+#endif
+
+#define VIEWPORT_STACK_SIZE 16
+
+static struct mock_gs_stats stats;
+static long live_resources = 0;  // Graphics thread only, like every gs_* call
+static volatile uint64_t allocations;
+static int log_level = LOG_WARNING;
+
+static uint32_t video_width = 1920;
+static uint32_t video_height = 1080;
+static uint64_t frame_time = 0;
+
+#define RECORD() (stats.calls++)
+
+// ============================================================================
+// Memory and logging
+// ============================================================================
+
+void *bmalloc(size_t size)
+{
+    __atomic_fetch_add(&allocations, 1, __ATOMIC_RELAXED);
+    void *ptr = malloc(size ? size : 1);
+    if (!ptr) abort();
+    return ptr;
+}
+
+void *brealloc(void *ptr, size_t size)
+{
+    __atomic_fetch_add(&allocations, 1, __ATOMIC_RELAXED);
+    ptr = realloc(ptr, size ? size : 1);
+    if (!ptr) abort();
+    return ptr;
+}
+
+void bfree(void *ptr)
+{
+    free(ptr);
+}
+
+void blog(int level, const char *format, ...)
+{
+    if (level > log_level) return;
+    
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+void profile_start(const char *name)
+{
+    UNUSED_PARAMETER(name);
+}
+
+void profile_end(const char *name)
+{
+    UNUSED_PARAMETER(name);
+}
+
+// ============================================================================
+// darray / dstr
+// ============================================================================
+
+void darray_reserve(const size_t element_size, struct darray *dst, const size_t capacity)
+{
+    if (capacity <= dst->capacity) return;
+    
+    dst->array = brealloc(dst->array, element_size * capacity);
+    dst->capacity = capacity;
+}
+
+static void darray_grow(const size_t element_size, struct darray *dst, const size_t needed)
+{
+    if (needed <= dst->capacity) return;
+    
+    size_t capacity = dst->capacity ? dst->capacity * 2 : 16;
+    while (capacity < needed) capacity *= 2;
+    darray_reserve(element_size, dst, capacity);
+}
+
+void darray_resize(const size_t element_size, struct darray *dst, const size_t size)
+{
+    if (size > dst->num) {
+        darray_grow(element_size, dst, size);
+        memset((uint8_t *)dst->array + dst->num * element_size, 0, (size - dst->num) * element_size);
+    }
+    dst->num = size;
+}
+
+size_t darray_push_back(const size_t element_size, struct darray *dst, const void *item)
+{
+    darray_grow(element_size, dst, dst->num + 1);
+    memcpy((uint8_t *)dst->array + dst->num * element_size, item, element_size);
+    return dst->num++;
+}
+
+void *darray_push_back_new(const size_t element_size, struct darray *dst)
+{
+    darray_grow(element_size, dst, dst->num + 1);
+    void *item = (uint8_t *)dst->array + dst->num * element_size;
+    memset(item, 0, element_size);
+    dst->num++;
+    return item;
+}
+
+size_t darray_push_back_array(const size_t element_size, struct darray *dst, const void *array, const size_t num)
+{
+    const size_t index = dst->num;
+    if (!array || !num) return index;
+    
+    darray_grow(element_size, dst, dst->num + num);
+    memcpy((uint8_t *)dst->array + dst->num * element_size, array, num * element_size);
+    dst->num += num;
+    return index;
+}
+
+void darray_free(struct darray *da)
+{
+    bfree(da->array);
+    da->array = NULL;
+    da->num = 0;
+    da->capacity = 0;
+}
+
+void darray_erase(const size_t element_size, struct darray *dst, const size_t idx)
+{
+    if (idx >= dst->num) return;
+    
+    uint8_t *array = dst->array;
+    memmove(array + idx * element_size, array + (idx + 1) * element_size, (dst->num - idx - 1) * element_size);
+    dst->num--;
+}
+
+// Grows the buffer to hold at least size bytes, terminator included
+static void dstr_reserve(struct dstr *dst, size_t size)
+{
+    if (size <= dst->capacity) return;
+    
+    size_t capacity = dst->capacity ? dst->capacity * 2 : 64;
+    while (capacity < size) capacity *= 2;
+    dst->array = brealloc(dst->array, capacity);
+    dst->capacity = capacity;
+}
+
+void dstr_free(struct dstr *dst)
+{
+    bfree(dst->array);
+    dstr_init(dst);
+}
+
+void dstr_copy(struct dstr *dst, const char *array)
+{
+    if (!array || !*array) {
+        dstr_free(dst);
+        return;
+    }
+    
+    const size_t len = strlen(array);
+    dstr_reserve(dst, len + 1);
+    memcpy(dst->array, array, len + 1);
+    dst->len = len;
+}
+
+void dstr_ncat(struct dstr *dst, const char *array, const size_t len)
+{
+    if (!array || !len) return;
+    
+    const size_t size = dst->len + len + 1;
+    dstr_reserve(dst, size);
+    if (dst->capacity < size) return;
+    
+    memcpy(dst->array + dst->len, array, len);
+    dst->len += len;
+    dst->array[dst->len] = 0;
+}
+
+void dstr_cat(struct dstr *dst, const char *array)
+{
+    if (array) dstr_ncat(dst, array, strlen(array));
+}
+
+static void dstr_vcatf(struct dstr *dst, const char *format, va_list args)
+{
+    va_list copy;
+    va_copy(copy, args);
+    const int len = vsnprintf(NULL, 0, format, copy);
+    va_end(copy);
+    if (len <= 0) return;
+    
+    dstr_reserve(dst, dst->len + (size_t)len + 1);
+    vsnprintf(dst->array + dst->len, (size_t)len + 1, format, args);
+    dst->len += (size_t)len;
+}
+
+void dstr_printf(struct dstr *dst, const char *format, ...)
+{
+    dst->len = 0;
+    if (dst->array) dst->array[0] = 0;
+    
+    va_list args;
+    va_start(args, format);
+    dstr_vcatf(dst, format, args);
+    va_end(args);
+}
+
+void dstr_catf(struct dstr *dst, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    dstr_vcatf(dst, format, args);
+    va_end(args);
+}
+
+void dstr_copy_dstr(struct dstr *dst, const struct dstr *src)
+{
+    dstr_copy(dst, src->array);
+}
+
+void dstr_cat_ch(struct dstr *dst, char ch)
+{
+    dstr_ncat(dst, &ch, 1);
+}
+
+void dstr_init_copy(struct dstr *dst, const char *src)
+{
+    dstr_init(dst);
+    dstr_copy(dst, src);
+}
+
+// ============================================================================
+// Platform and threading
+// ============================================================================
+
+uint64_t os_gettime_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+char *os_generate_formatted_filename(const char *extension, bool space, const char *format)
+{
+    UNUSED_PARAMETER(space);
+    UNUSED_PARAMETER(format);
+    
+    struct dstr name;
+    dstr_init(&name);
+    dstr_printf(&name, "overlay-bench.%s", extension);
+    return name.array;
+}
+
+int os_mkdirs(const char *path)
+{
+    if (os_file_exists(path)) return MKDIR_EXISTS;
+    
+    struct dstr parent;
+    dstr_init_copy(&parent, path);
+    char *slash = parent.array ? strrchr(parent.array, '/') : NULL;
+    if (slash && slash != parent.array) {
+        *slash = 0;
+        os_mkdirs(parent.array);
+    }
+    dstr_free(&parent);
+    
+    return mkdir(path, 0755) == 0 || errno == EEXIST ? MKDIR_SUCCESS : MKDIR_ERROR;
+}
+
+bool os_file_exists(const char *path)
+{
+    return path && access(path, F_OK) == 0;
+}
+
+int64_t os_get_file_size(const char *path)
+{
+    struct stat st;
+    return stat(path, &st) == 0 ? (int64_t)st.st_size : -1;
+}
+
+void os_sleep_ms(uint32_t duration)
+{
+    const struct timespec ts = {duration / 1000, (long)(duration % 1000) * 1000000L};
+    nanosleep(&ts, NULL);
+}
+
+char *os_get_config_path_ptr(const char *name)
+{
+    const char *tmp = getenv("TMPDIR");
+    struct dstr path;
+    dstr_init(&path);
+    dstr_printf(&path, "%s/overlay-bench/%s", tmp && *tmp ? tmp : "/tmp", name ? name : "");
+    return path.array;
+}
+
+FILE *os_fopen(const char *path, const char *mode)
+{
+    return fopen(path, mode);
+}
+
+void os_set_thread_name(const char *name)
+{
+    UNUSED_PARAMETER(name);
+}
+
+char *os_quick_read_utf8_file(const char *path)
+{
+    FILE *file = path ? fopen(path, "rb") : NULL;
+    if (!file) return NULL;
+    
+    struct dstr text;
+    dstr_init(&text);
+    char chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) dstr_ncat(&text, chunk, n);
+    fclose(file);
+    
+    if (!text.array) return bzalloc(1);
+    if (text.len >= 3 && memcmp(text.array, "\xEF\xBB\xBF", 3) == 0) {
+        memmove(text.array, text.array + 3, text.len - 2);
+    }
+    return text.array;
+}
+
+int os_rename(const char *old_path, const char *new_path)
+{
+    return rename(old_path, new_path);
+}
+
+int os_unlink(const char *path)
+{
+    return unlink(path);
+}
+
+size_t os_utf8_to_wcs_ptr(const char *str, size_t len, wchar_t **pstr)
+{
+    if (!str) return 0;
+    
+    struct dstr copy;
+    dstr_init(&copy);
+    dstr_ncat(&copy, str, len ? len : strlen(str));
+    
+    const size_t count = copy.array ? mbstowcs(NULL, copy.array, 0) : 0;
+    *pstr = bzalloc((count + 1) * sizeof(wchar_t));
+    if (count != (size_t)-1 && count) mbstowcs(*pstr, copy.array, count + 1);
+    
+    dstr_free(&copy);
+    return count == (size_t)-1 ? 0 : count;
+}
+
+int os_stat(const char *file, struct stat *st)
+{
+    return stat(file, st);
+}
+
+struct os_event_data {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool signalled;
+    bool manual;
+};
+
+int os_event_init(os_event_t **event, enum os_event_type type)
+{
+    os_event_t *data = bzalloc(sizeof(os_event_t));
+    pthread_mutex_init(&data->mutex, NULL);
+    pthread_cond_init(&data->cond, NULL);
+    data->manual = type == OS_EVENT_TYPE_MANUAL;
+    *event = data;
+    return 0;
+}
+
+void os_event_destroy(os_event_t *event)
+{
+    if (!event) return;
+    
+    pthread_cond_destroy(&event->cond);
+    pthread_mutex_destroy(&event->mutex);
+    bfree(event);
+}
+
+int os_event_wait(os_event_t *event)
+{
+    pthread_mutex_lock(&event->mutex);
+    while (!event->signalled) pthread_cond_wait(&event->cond, &event->mutex);
+    if (!event->manual) event->signalled = false;
+    pthread_mutex_unlock(&event->mutex);
+    return 0;
+}
+
+int os_event_timedwait(os_event_t *event, unsigned long milliseconds)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += (time_t)(milliseconds / 1000);
+    deadline.tv_nsec += (long)(milliseconds % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    
+    int result = 0;
+    pthread_mutex_lock(&event->mutex);
+    while (!event->signalled && result == 0) result = pthread_cond_timedwait(&event->cond, &event->mutex, &deadline);
+    if (event->signalled) {
+        if (!event->manual) event->signalled = false;
+        result = 0;
+    }
+    pthread_mutex_unlock(&event->mutex);
+    return result;
+}
+
+int os_event_try(os_event_t *event)
+{
+    int result = EAGAIN;
+    pthread_mutex_lock(&event->mutex);
+    if (event->signalled) {
+        if (!event->manual) event->signalled = false;
+        result = 0;
+    }
+    pthread_mutex_unlock(&event->mutex);
+    return result;
+}
+
+int os_event_signal(os_event_t *event)
+{
+    pthread_mutex_lock(&event->mutex);
+    event->signalled = true;
+    pthread_cond_broadcast(&event->cond);
+    pthread_mutex_unlock(&event->mutex);
+    return 0;
+}
+
+void os_event_reset(os_event_t *event)
+{
+    pthread_mutex_lock(&event->mutex);
+    event->signalled = false;
+    pthread_mutex_unlock(&event->mutex);
+}
+
+long os_atomic_inc_long(volatile long *val)
+{
+    return __atomic_add_fetch(val, 1, __ATOMIC_SEQ_CST);
+}
+
+long os_atomic_dec_long(volatile long *val)
+{
+    return __atomic_sub_fetch(val, 1, __ATOMIC_SEQ_CST);
+}
+
+void os_atomic_store_long(volatile long *ptr, long val)
+{
+    __atomic_store_n(ptr, val, __ATOMIC_SEQ_CST);
+}
+
+long os_atomic_set_long(volatile long *ptr, long val)
+{
+    return __atomic_exchange_n(ptr, val, __ATOMIC_SEQ_CST);
+}
+
+long os_atomic_exchange_long(volatile long *ptr, long val)
+{
+    return __atomic_exchange_n(ptr, val, __ATOMIC_SEQ_CST);
+}
+
+long os_atomic_load_long(const volatile long *ptr)
+{
+    return __atomic_load_n(ptr, __ATOMIC_SEQ_CST);
+}
+
+bool os_atomic_compare_swap_long(volatile long *val, long old_val, long new_val)
+{
+    return __atomic_compare_exchange_n(val, &old_val, new_val, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+void os_atomic_store_bool(volatile bool *ptr, bool val)
+{
+    __atomic_store_n(ptr, val, __ATOMIC_SEQ_CST);
+}
+
+bool os_atomic_set_bool(volatile bool *ptr, bool val)
+{
+    return __atomic_exchange_n(ptr, val, __ATOMIC_SEQ_CST);
+}
+
+bool os_atomic_exchange_bool(volatile bool *ptr, bool val)
+{
+    return __atomic_exchange_n(ptr, val, __ATOMIC_SEQ_CST);
+}
+
+bool os_atomic_load_bool(const volatile bool *ptr)
+{
+    return __atomic_load_n(ptr, __ATOMIC_SEQ_CST);
+}
+
+// ============================================================================
+// Graphics recorder
+// ============================================================================
+
+struct gs_texture {
+    uint32_t width;
+    uint32_t height;
+    enum gs_color_format format;
+};
+
+struct gs_texture_render {
+    gs_texture_t *texture;
+    enum gs_color_format format;
+    bool rendered;
+};
+
+struct gs_stage_surface {
+    uint32_t width;
+    uint32_t height;
+    uint8_t *data;
+};
+
+struct gs_vertex_buffer {
+    struct gs_vb_data *data;
+};
+
+struct gs_index_buffer {
+    void *indices;
+    size_t num;
+};
+
+struct gs_sampler_state {
+    struct gs_sampler_info info;
+};
+
+struct gs_effect_param {
+    int unused;
+};
+
+struct gs_effect_technique {
+    int unused;
+};
+
+struct gs_effect {
+    struct gs_effect_param param;
+    struct gs_effect_technique technique;
+    bool looping;
+};
+
+static struct gs_effect base_effects[OBS_EFFECT_AREA + 1];
+static gs_texture_t main_texture;
+
+static gs_vertbuffer_t *current_vb;
+static gs_indexbuffer_t *current_ib;
+static uint64_t immediate_vertices;
+static bool framebuffer_srgb;
+static enum gs_cull_mode cull_mode = GS_BACK;
+
+static struct gs_rect viewport;
+static struct gs_rect viewport_stack[VIEWPORT_STACK_SIZE];
+static size_t viewport_depth;
+
+void gs_vbdata_destroy(struct gs_vb_data *data)
+{
+    if (!data) return;
+    
+    bfree(data->points);
+    bfree(data->normals);
+    bfree(data->tangents);
+    bfree(data->colors);
+    if (data->tvarray) {
+        for (size_t i = 0; i < data->num_tex; i++) bfree(data->tvarray[i].array);
+        bfree(data->tvarray);
+    }
+    bfree(data);
+}
+
+gs_vertbuffer_t *gs_vertexbuffer_create(struct gs_vb_data *data, uint32_t flags)
+{
+    UNUSED_PARAMETER(flags);
+    RECORD();
+    stats.resources++;
+    live_resources++;
+    
+    gs_vertbuffer_t *vertbuffer = bzalloc(sizeof(gs_vertbuffer_t));
+    vertbuffer->data = data;
+    return vertbuffer;
+}
+
+void gs_vertexbuffer_destroy(gs_vertbuffer_t *vertbuffer)
+{
+    RECORD();
+    if (!vertbuffer) return;
+    
+    live_resources--;
+    if (current_vb == vertbuffer) current_vb = NULL;
+    gs_vbdata_destroy(vertbuffer->data);
+    bfree(vertbuffer);
+}
+
+void gs_vertexbuffer_flush(gs_vertbuffer_t *vertbuffer)
+{
+    UNUSED_PARAMETER(vertbuffer);
+    RECORD();
+}
+
+struct gs_vb_data *gs_vertexbuffer_get_data(const gs_vertbuffer_t *vertbuffer)
+{
+    return vertbuffer ? vertbuffer->data : NULL;
+}
+
+void gs_load_vertexbuffer(gs_vertbuffer_t *vertbuffer)
+{
+    RECORD();
+    current_vb = vertbuffer;
+}
+
+void gs_load_indexbuffer(gs_indexbuffer_t *indexbuffer)
+{
+    RECORD();
+    current_ib = indexbuffer;
+}
+
+void gs_draw(enum gs_draw_mode draw_mode, uint32_t start_vert, uint32_t num_verts)
+{
+    UNUSED_PARAMETER(draw_mode);
+    UNUSED_PARAMETER(start_vert);
+    RECORD();
+    stats.draws++;
+    
+    if (num_verts) {
+        stats.vertices += num_verts;
+    } else if (current_ib) {
+        stats.vertices += current_ib->num;
+    } else if (current_vb && current_vb->data) {
+        stats.vertices += current_vb->data->num;
+    }
+}
+
+void gs_render_start(bool b_new)
+{
+    UNUSED_PARAMETER(b_new);
+    RECORD();
+    immediate_vertices = 0;
+}
+
+void gs_render_stop(enum gs_draw_mode mode)
+{
+    UNUSED_PARAMETER(mode);
+    RECORD();
+    stats.draws++;
+    stats.vertices += immediate_vertices;
+}
+
+void gs_vertex2f(float x, float y)
+{
+    UNUSED_PARAMETER(x);
+    UNUSED_PARAMETER(y);
+    RECORD();
+    immediate_vertices++;
+}
+
+void gs_vertex3f(float x, float y, float z)
+{
+    UNUSED_PARAMETER(x);
+    UNUSED_PARAMETER(y);
+    UNUSED_PARAMETER(z);
+    RECORD();
+    immediate_vertices++;
+}
+
+void gs_color(uint32_t color)
+{
+    UNUSED_PARAMETER(color);
+    RECORD();
+}
+
+void gs_texcoord(float x, float y, int unit)
+{
+    UNUSED_PARAMETER(x);
+    UNUSED_PARAMETER(y);
+    UNUSED_PARAMETER(unit);
+    RECORD();
+}
+
+gs_eparam_t *gs_effect_get_param_by_name(const gs_effect_t *effect, const char *name)
+{
+    UNUSED_PARAMETER(name);
+    RECORD();
+    return effect ? (gs_eparam_t *)&effect->param : NULL;
+}
+
+gs_technique_t *gs_effect_get_technique(const gs_effect_t *effect, const char *name)
+{
+    UNUSED_PARAMETER(name);
+    RECORD();
+    return effect ? (gs_technique_t *)&effect->technique : NULL;
+}
+
+size_t gs_technique_begin(gs_technique_t *technique)
+{
+    RECORD();
+    return technique ? 1 : 0;
+}
+
+void gs_technique_end(gs_technique_t *technique)
+{
+    UNUSED_PARAMETER(technique);
+    RECORD();
+}
+
+bool gs_technique_begin_pass(gs_technique_t *technique, size_t pass)
+{
+    RECORD();
+    return technique && pass == 0;
+}
+
+void gs_technique_end_pass(gs_technique_t *technique)
+{
+    UNUSED_PARAMETER(technique);
+    RECORD();
+}
+
+// One pass per technique: true on the first call, false on the next
+bool gs_effect_loop(gs_effect_t *effect, const char *name)
+{
+    UNUSED_PARAMETER(name);
+    RECORD();
+    if (!effect) return false;
+    
+    effect->looping = !effect->looping;
+    return effect->looping;
+}
+
+#define RECORD_UNIFORM()  \
+    do {                  \
+        RECORD();         \
+        stats.uniforms++; \
+    } while (false)
+
+void gs_effect_set_vec4(gs_eparam_t *param, const struct vec4 *val)
+{
+    UNUSED_PARAMETER(param);
+    UNUSED_PARAMETER(val);
+    RECORD_UNIFORM();
+}
+
+void gs_effect_set_vec2(gs_eparam_t *param, const struct vec2 *val)
+{
+    UNUSED_PARAMETER(param);
+    UNUSED_PARAMETER(val);
+    RECORD_UNIFORM();
+}
+
+void gs_effect_set_float(gs_eparam_t *param, float val)
+{
+    UNUSED_PARAMETER(param);
+    UNUSED_PARAMETER(val);
+    RECORD_UNIFORM();
+}
+
+void gs_effect_set_int(gs_eparam_t *param, int val)
+{
+    UNUSED_PARAMETER(param);
+    UNUSED_PARAMETER(val);
+    RECORD_UNIFORM();
+}
+
+void gs_effect_set_bool(gs_eparam_t *param, bool val)
+{
+    UNUSED_PARAMETER(param);
+    UNUSED_PARAMETER(val);
+    RECORD_UNIFORM();
+}
+
+void gs_effect_set_texture(gs_eparam_t *param, gs_texture_t *val)
+{
+    UNUSED_PARAMETER(param);
+    UNUSED_PARAMETER(val);
+    RECORD_UNIFORM();
+}
+
+void gs_effect_set_next_sampler(gs_eparam_t *param, gs_samplerstate_t *sampler)
+{
+    UNUSED_PARAMETER(param);
+    UNUSED_PARAMETER(sampler);
+    RECORD();
+}
+
+// Any existing file "compiles"; the bench exercises the shader grid path
+gs_effect_t *gs_effect_create_from_file(const char *file, char **error_string)
+{
+    RECORD();
+    if (error_string) *error_string = NULL;
+    if (!os_file_exists(file)) return NULL;
+    
+    stats.resources++;
+    return bzalloc(sizeof(gs_effect_t));
+}
+
+void gs_effect_destroy(gs_effect_t *effect)
+{
+    RECORD();
+    if (effect < base_effects || effect > &base_effects[OBS_EFFECT_AREA]) bfree(effect);
+}
+
+void gs_blend_state_push(void)
+{
+    RECORD();
+}
+
+void gs_blend_state_pop(void)
+{
+    RECORD();
+}
+
+void gs_reset_blend_state(void)
+{
+    RECORD();
+}
+
+void gs_enable_blending(bool enable)
+{
+    UNUSED_PARAMETER(enable);
+    RECORD();
+}
+
+void gs_blend_function(enum gs_blend_type src, enum gs_blend_type dest)
+{
+    UNUSED_PARAMETER(src);
+    UNUSED_PARAMETER(dest);
+    RECORD();
+}
+
+void gs_blend_function_separate(enum gs_blend_type src_c, enum gs_blend_type dest_c, enum gs_blend_type src_a,
+                                enum gs_blend_type dest_a)
+{
+    UNUSED_PARAMETER(src_c);
+    UNUSED_PARAMETER(dest_c);
+    UNUSED_PARAMETER(src_a);
+    UNUSED_PARAMETER(dest_a);
+    RECORD();
+}
+
+gs_texrender_t *gs_texrender_create(enum gs_color_format format, enum gs_zstencil_format zsformat)
+{
+    UNUSED_PARAMETER(zsformat);
+    RECORD();
+    
+    live_resources++;
+    gs_texrender_t *texrender = bzalloc(sizeof(gs_texrender_t));
+    texrender->format = format;
+    return texrender;
+}
+
+void gs_texrender_destroy(gs_texrender_t *texrender)
+{
+    RECORD();
+    if (!texrender) return;
+    
+    live_resources--;
+    bfree(texrender->texture);
+    bfree(texrender);
+}
+
+// Like libobs, a texrender accepts one begin per reset
+bool gs_texrender_begin(gs_texrender_t *texrender, uint32_t cx, uint32_t cy)
+{
+    RECORD();
+    if (!texrender || texrender->rendered || !cx || !cy) return false;
+    
+    stats.render_targets++;
+    gs_texture_t *texture = texrender->texture;
+    if (!texture || texture->width != cx || texture->height != cy) {
+        bfree(texture);
+        texture = bzalloc(sizeof(gs_texture_t));
+        texture->width = cx;
+        texture->height = cy;
+        texture->format = texrender->format;
+        texrender->texture = texture;
+        stats.resources++;
+    }
+    
+    if (viewport_depth < VIEWPORT_STACK_SIZE) viewport_stack[viewport_depth] = viewport;
+    viewport_depth++;
+    viewport = (struct gs_rect){0, 0, (int)cx, (int)cy};
+    return true;
+}
+
+void gs_texrender_end(gs_texrender_t *texrender)
+{
+    RECORD();
+    if (!texrender) return;
+    
+    texrender->rendered = true;
+    if (viewport_depth && --viewport_depth < VIEWPORT_STACK_SIZE) viewport = viewport_stack[viewport_depth];
+}
+
+void gs_texrender_reset(gs_texrender_t *texrender)
+{
+    RECORD();
+    if (texrender) texrender->rendered = false;
+}
+
+gs_texture_t *gs_texrender_get_texture(const gs_texrender_t *texrender)
+{
+    return texrender ? texrender->texture : NULL;
+}
+
+void gs_ortho(float left, float right, float top, float bottom, float znear, float zfar)
+{
+    UNUSED_PARAMETER(left);
+    UNUSED_PARAMETER(right);
+    UNUSED_PARAMETER(top);
+    UNUSED_PARAMETER(bottom);
+    UNUSED_PARAMETER(znear);
+    UNUSED_PARAMETER(zfar);
+    RECORD();
+}
+
+void gs_clear(uint32_t clear_flags, const struct vec4 *color, float depth, uint8_t stencil)
+{
+    UNUSED_PARAMETER(clear_flags);
+    UNUSED_PARAMETER(color);
+    UNUSED_PARAMETER(depth);
+    UNUSED_PARAMETER(stencil);
+    RECORD();
+}
+
+void gs_draw_sprite(gs_texture_t *tex, uint32_t flip, uint32_t width, uint32_t height)
+{
+    UNUSED_PARAMETER(tex);
+    UNUSED_PARAMETER(flip);
+    UNUSED_PARAMETER(width);
+    UNUSED_PARAMETER(height);
+    RECORD();
+    stats.draws++;
+    stats.vertices += 4;
+}
+
+void gs_draw_sprite_subregion(gs_texture_t *tex, uint32_t flip, uint32_t x, uint32_t y, uint32_t cx, uint32_t cy)
+{
+    UNUSED_PARAMETER(tex);
+    UNUSED_PARAMETER(flip);
+    UNUSED_PARAMETER(x);
+    UNUSED_PARAMETER(y);
+    UNUSED_PARAMETER(cx);
+    UNUSED_PARAMETER(cy);
+    RECORD();
+    stats.draws++;
+    stats.vertices += 4;
+}
+
+void gs_projection_push(void)
+{
+    RECORD();
+}
+
+void gs_projection_pop(void)
+{
+    RECORD();
+}
+
+void gs_viewport_push(void)
+{
+    RECORD();
+    if (viewport_depth < VIEWPORT_STACK_SIZE) viewport_stack[viewport_depth] = viewport;
+    viewport_depth++;
+}
+
+void gs_viewport_pop(void)
+{
+    RECORD();
+    if (!viewport_depth) return;
+    
+    viewport_depth--;
+    if (viewport_depth < VIEWPORT_STACK_SIZE) viewport = viewport_stack[viewport_depth];
+}
+
+void gs_set_viewport(int x, int y, int width, int height)
+{
+    RECORD();
+    viewport = (struct gs_rect){x, y, width, height};
+}
+
+void gs_get_viewport(struct gs_rect *rect)
+{
+    RECORD();
+    *rect = viewport;
+}
+
+void gs_matrix_push(void)
+{
+    RECORD();
+}
+
+void gs_matrix_pop(void)
+{
+    RECORD();
+}
+
+void gs_matrix_identity(void)
+{
+    RECORD();
+}
+
+void gs_matrix_translate3f(float x, float y, float z)
+{
+    UNUSED_PARAMETER(x);
+    UNUSED_PARAMETER(y);
+    UNUSED_PARAMETER(z);
+    RECORD();
+}
+
+void gs_matrix_scale3f(float x, float y, float z)
+{
+    UNUSED_PARAMETER(x);
+    UNUSED_PARAMETER(y);
+    UNUSED_PARAMETER(z);
+    RECORD();
+}
+
+// Sources render unscaled in the benchmark
+void gs_matrix_get(struct matrix4 *dst)
+{
+    RECORD();
+    memset(dst, 0, sizeof(*dst));
+    dst->x.x = 1.0f;
+    dst->y.y = 1.0f;
+    dst->z.z = 1.0f;
+    dst->t.w = 1.0f;
+}
+
+uint32_t gs_texture_get_width(const gs_texture_t *tex)
+{
+    return tex ? tex->width : 0;
+}
+
+uint32_t gs_texture_get_height(const gs_texture_t *tex)
+{
+    return tex ? tex->height : 0;
+}
+
+gs_texture_t *gs_texture_create(uint32_t width, uint32_t height, enum gs_color_format color_format, uint32_t levels,
+                                const uint8_t **data, uint32_t flags)
+{
+    UNUSED_PARAMETER(levels);
+    UNUSED_PARAMETER(data);
+    UNUSED_PARAMETER(flags);
+    RECORD();
+    stats.resources++;
+    live_resources++;
+    
+    gs_texture_t *tex = bzalloc(sizeof(gs_texture_t));
+    tex->width = width;
+    tex->height = height;
+    tex->format = color_format;
+    return tex;
+}
+
+void gs_texture_destroy(gs_texture_t *tex)
+{
+    RECORD();
+    if (!tex || tex == &main_texture) return;
+    
+    live_resources--;
+    bfree(tex);
+}
+
+void gs_copy_texture_region(gs_texture_t *dst, uint32_t dst_x, uint32_t dst_y, gs_texture_t *src, uint32_t src_x,
+                            uint32_t src_y, uint32_t src_w, uint32_t src_h)
+{
+    UNUSED_PARAMETER(dst);
+    UNUSED_PARAMETER(dst_x);
+    UNUSED_PARAMETER(dst_y);
+    UNUSED_PARAMETER(src);
+    UNUSED_PARAMETER(src_x);
+    UNUSED_PARAMETER(src_y);
+    UNUSED_PARAMETER(src_w);
+    UNUSED_PARAMETER(src_h);
+    RECORD();
+}
+
+gs_stagesurf_t *gs_stagesurface_create(uint32_t width, uint32_t height, enum gs_color_format color_format)
+{
+    UNUSED_PARAMETER(color_format);
+    RECORD();
+    stats.resources++;
+    live_resources++;
+    
+    gs_stagesurf_t *surface = bzalloc(sizeof(gs_stagesurf_t));
+    surface->width = width;
+    surface->height = height;
+    surface->data = bzalloc((size_t)width * height * 4);
+    return surface;
+}
+
+void gs_stagesurface_destroy(gs_stagesurf_t *stagesurf)
+{
+    RECORD();
+    if (!stagesurf) return;
+    
+    live_resources--;
+    bfree(stagesurf->data);
+    bfree(stagesurf);
+}
+
+// Staged pixels read back as transparent black
+bool gs_stagesurface_map(gs_stagesurf_t *stagesurf, uint8_t **data, uint32_t *linesize)
+{
+    RECORD();
+    if (!stagesurf) return false;
+    
+    *data = stagesurf->data;
+    *linesize = stagesurf->width * 4;
+    return true;
+}
+
+void gs_stagesurface_unmap(gs_stagesurf_t *stagesurf)
+{
+    UNUSED_PARAMETER(stagesurf);
+    RECORD();
+}
+
+void gs_stage_texture(gs_stagesurf_t *dst, gs_texture_t *src)
+{
+    UNUSED_PARAMETER(dst);
+    UNUSED_PARAMETER(src);
+    RECORD();
+}
+
+gs_samplerstate_t *gs_samplerstate_create(const struct gs_sampler_info *info)
+{
+    RECORD();
+    stats.resources++;
+    
+    gs_samplerstate_t *sampler = bzalloc(sizeof(gs_samplerstate_t));
+    sampler->info = *info;
+    return sampler;
+}
+
+void gs_samplerstate_destroy(gs_samplerstate_t *samplerstate)
+{
+    RECORD();
+    bfree(samplerstate);
+}
+
+bool gs_framebuffer_srgb_enabled(void)
+{
+    RECORD();
+    return framebuffer_srgb;
+}
+
+void gs_enable_framebuffer_srgb(bool enable)
+{
+    RECORD();
+    framebuffer_srgb = enable;
+}
+
+// Takes ownership of indices, like libobs
+gs_indexbuffer_t *gs_indexbuffer_create(enum gs_index_type type, void *indices, size_t num, uint32_t flags)
+{
+    UNUSED_PARAMETER(type);
+    UNUSED_PARAMETER(flags);
+    RECORD();
+    stats.resources++;
+    live_resources++;
+    
+    gs_indexbuffer_t *indexbuffer = bzalloc(sizeof(gs_indexbuffer_t));
+    indexbuffer->indices = indices;
+    indexbuffer->num = num;
+    return indexbuffer;
+}
+
+void gs_indexbuffer_destroy(gs_indexbuffer_t *indexbuffer)
+{
+    RECORD();
+    if (!indexbuffer) return;
+    
+    live_resources--;
+    if (current_ib == indexbuffer) current_ib = NULL;
+    bfree(indexbuffer->indices);
+    bfree(indexbuffer);
+}
+
+void gs_set_cull_mode(enum gs_cull_mode mode)
+{
+    RECORD();
+    cull_mode = mode;
+}
+
+enum gs_cull_mode gs_get_cull_mode(void)
+{
+    RECORD();
+    return cull_mode;
+}
+
+// No image decoder: every reference image fails to load
+void gs_image_file_init(gs_image_file_t *image, const char *file)
+{
+    UNUSED_PARAMETER(file);
+    memset(image, 0, sizeof(*image));
+}
+
+void gs_image_file_free(gs_image_file_t *image)
+{
+    gs_texture_destroy(image->texture);
+    bfree(image->texture_data);
+    memset(image, 0, sizeof(*image));
+}
+
+void gs_image_file_init_texture(gs_image_file_t *image)
+{
+    UNUSED_PARAMETER(image);
+}
+
+// ============================================================================
+// obs_data
+// ============================================================================
+
+enum data_type {
+    DATA_BOOL,
+    DATA_INT,
+    DATA_DOUBLE,
+    DATA_STRING,
+    DATA_OBJ,
+    DATA_ARRAY
+};
+
+struct data_item {
+    char *name;
+    enum data_type type;
+    union {
+        bool b;
+        long long i;
+        double d;
+        char *s;
+        obs_data_t *obj;
+        obs_data_array_t *array;
+    };
+};
+
+struct obs_data {
+    volatile long refs;
+    DARRAY(struct data_item) values;
+    DARRAY(struct data_item) defaults;
+};
+
+struct obs_data_array {
+    volatile long refs;
+    DARRAY(obs_data_t *) items;
+};
+
+static void data_item_clear(struct data_item *item)
+{
+    if (item->type == DATA_STRING) bfree(item->s);
+    if (item->type == DATA_OBJ) obs_data_release(item->obj);
+    if (item->type == DATA_ARRAY) obs_data_array_release(item->array);
+    item->i = 0;
+}
+
+static struct data_item *data_find(struct darray *list, const char *name)
+{
+    struct data_item *items = list->array;
+    for (size_t i = 0; i < list->num; i++) {
+        if (strcmp(items[i].name, name) == 0) return &items[i];
+    }
+    return NULL;
+}
+
+static struct data_item *data_set(struct darray *list, const char *name, enum data_type type)
+{
+    struct data_item *item = data_find(list, name);
+    if (item) {
+        data_item_clear(item);
+    } else {
+        item = darray_push_back_new(sizeof(struct data_item), list);
+        item->name = bstrdup(name);
+    }
+    item->type = type;
+    return item;
+}
+
+static const struct data_item *data_get(obs_data_t *data, const char *name)
+{
+    if (!data || !name) return NULL;
+    
+    const struct data_item *item = data_find(&data->values.da, name);
+    return item ? item : data_find(&data->defaults.da, name);
+}
+
+static void data_copy_item(struct darray *list, const struct data_item *src)
+{
+    struct data_item *item = data_set(list, src->name, src->type);
+    switch (src->type) {
+        case DATA_STRING:
+            item->s = bstrdup(src->s);
+            break;
+        case DATA_OBJ:
+            item->obj = src->obj;
+            if (item->obj) os_atomic_inc_long(&item->obj->refs);
+            break;
+        case DATA_ARRAY:
+            item->array = src->array;
+            if (item->array) os_atomic_inc_long(&item->array->refs);
+            break;
+        default: {
+            char *name = item->name;
+            *item = *src;
+            item->name = name;
+            break;
+        }
+    }
+}
+
+obs_data_t *obs_data_create(void)
+{
+    obs_data_t *data = bzalloc(sizeof(obs_data_t));
+    data->refs = 1;
+    return data;
+}
+
+// No JSON parser in the mock: layout files and presets fail to load
+obs_data_t *obs_data_create_from_json_file(const char *json_file)
+{
+    UNUSED_PARAMETER(json_file);
+    return NULL;
+}
+
+obs_data_t *obs_data_create_from_json(const char *json_string)
+{
+    UNUSED_PARAMETER(json_string);
+    return NULL;
+}
+
+void obs_data_release(obs_data_t *data)
+{
+    if (!data || os_atomic_dec_long(&data->refs) > 0) return;
+    
+    for (size_t i = 0; i < data->values.num; i++) {
+        data_item_clear(&data->values.array[i]);
+        bfree(data->values.array[i].name);
+    }
+    for (size_t i = 0; i < data->defaults.num; i++) {
+        data_item_clear(&data->defaults.array[i]);
+        bfree(data->defaults.array[i].name);
+    }
+    da_free(data->values);
+    da_free(data->defaults);
+    bfree(data);
+}
+
+bool obs_data_save_json(obs_data_t *data, const char *file)
+{
+    UNUSED_PARAMETER(data);
+    UNUSED_PARAMETER(file);
+    return false;
+}
+
+bool obs_data_save_json_safe(obs_data_t *data, const char *file, const char *temp_ext, const char *backup_ext)
+{
+    UNUSED_PARAMETER(temp_ext);
+    UNUSED_PARAMETER(backup_ext);
+    return obs_data_save_json(data, file);
+}
+
+bool obs_data_get_bool(obs_data_t *data, const char *name)
+{
+    const struct data_item *item = data_get(data, name);
+    return item && item->type == DATA_BOOL ? item->b : false;
+}
+
+long long obs_data_get_int(obs_data_t *data, const char *name)
+{
+    const struct data_item *item = data_get(data, name);
+    if (!item) return 0;
+    
+    if (item->type == DATA_INT) return item->i;
+    return item->type == DATA_DOUBLE ? (long long)item->d : 0;
+}
+
+double obs_data_get_double(obs_data_t *data, const char *name)
+{
+    const struct data_item *item = data_get(data, name);
+    if (!item) return 0.0;
+    
+    if (item->type == DATA_DOUBLE) return item->d;
+    return item->type == DATA_INT ? (double)item->i : 0.0;
+}
+
+const char *obs_data_get_string(obs_data_t *data, const char *name)
+{
+    const struct data_item *item = data_get(data, name);
+    return item && item->type == DATA_STRING && item->s ? item->s : "";
+}
+
+obs_data_t *obs_data_get_obj(obs_data_t *data, const char *name)
+{
+    const struct data_item *item = data_get(data, name);
+    if (!item || item->type != DATA_OBJ || !item->obj) return NULL;
+    
+    os_atomic_inc_long(&item->obj->refs);
+    return item->obj;
+}
+
+obs_data_array_t *obs_data_get_array(obs_data_t *data, const char *name)
+{
+    const struct data_item *item = data_get(data, name);
+    if (!item || item->type != DATA_ARRAY || !item->array) return NULL;
+    
+    os_atomic_inc_long(&item->array->refs);
+    return item->array;
+}
+
+bool obs_data_has_user_value(obs_data_t *data, const char *name)
+{
+    return data && name && data_find(&data->values.da, name) != NULL;
+}
+
+void obs_data_set_bool(obs_data_t *data, const char *name, bool val)
+{
+    if (data && name) data_set(&data->values.da, name, DATA_BOOL)->b = val;
+}
+
+void obs_data_set_int(obs_data_t *data, const char *name, long long val)
+{
+    if (data && name) data_set(&data->values.da, name, DATA_INT)->i = val;
+}
+
+void obs_data_set_double(obs_data_t *data, const char *name, double val)
+{
+    if (data && name) data_set(&data->values.da, name, DATA_DOUBLE)->d = val;
+}
+
+void obs_data_set_string(obs_data_t *data, const char *name, const char *val)
+{
+    if (data && name) data_set(&data->values.da, name, DATA_STRING)->s = bstrdup(val ? val : "");
+}
+
+void obs_data_set_obj(obs_data_t *data, const char *name, obs_data_t *obj)
+{
+    if (!data || !name) return;
+    
+    if (obj) os_atomic_inc_long(&obj->refs);
+    data_set(&data->values.da, name, DATA_OBJ)->obj = obj;
+}
+
+void obs_data_set_array(obs_data_t *data, const char *name, obs_data_array_t *array)
+{
+    if (!data || !name) return;
+    
+    if (array) os_atomic_inc_long(&array->refs);
+    data_set(&data->values.da, name, DATA_ARRAY)->array = array;
+}
+
+void obs_data_set_default_bool(obs_data_t *data, const char *name, bool val)
+{
+    if (data && name) data_set(&data->defaults.da, name, DATA_BOOL)->b = val;
+}
+
+void obs_data_set_default_int(obs_data_t *data, const char *name, long long val)
+{
+    if (data && name) data_set(&data->defaults.da, name, DATA_INT)->i = val;
+}
+
+void obs_data_set_default_double(obs_data_t *data, const char *name, double val)
+{
+    if (data && name) data_set(&data->defaults.da, name, DATA_DOUBLE)->d = val;
+}
+
+void obs_data_set_default_string(obs_data_t *data, const char *name, const char *val)
+{
+    if (data && name) data_set(&data->defaults.da, name, DATA_STRING)->s = bstrdup(val ? val : "");
+}
+
+// User values of src override dst, as obs_data_apply() does
+static void data_apply(obs_data_t *dst, obs_data_t *src)
+{
+    for (size_t i = 0; i < src->values.num; i++) data_copy_item(&dst->values.da, &src->values.array[i]);
+}
+
+obs_data_array_t *obs_data_array_create(void)
+{
+    obs_data_array_t *array = bzalloc(sizeof(obs_data_array_t));
+    array->refs = 1;
+    return array;
+}
+
+void obs_data_array_release(obs_data_array_t *array)
+{
+    if (!array || os_atomic_dec_long(&array->refs) > 0) return;
+    
+    for (size_t i = 0; i < array->items.num; i++) obs_data_release(array->items.array[i]);
+    da_free(array->items);
+    bfree(array);
+}
+
+size_t obs_data_array_count(obs_data_array_t *array)
+{
+    return array ? array->items.num : 0;
+}
+
+obs_data_t *obs_data_array_item(obs_data_array_t *array, size_t idx)
+{
+    if (!array || idx >= array->items.num) return NULL;
+    
+    obs_data_t *item = array->items.array[idx];
+    os_atomic_inc_long(&item->refs);
+    return item;
+}
+
+size_t obs_data_array_push_back(obs_data_array_t *array, obs_data_t *obj)
+{
+    if (!array || !obj) return 0;
+    
+    os_atomic_inc_long(&obj->refs);
+    return da_push_back(array->items, &obj);
+}
+
+// ============================================================================
+// Properties and hotkeys (recorded, never shown)
+// ============================================================================
+
+struct obs_property {
+    char *name;
+    obs_property_t *next;
+};
+
+struct obs_properties {
+    obs_property_t *first;
+};
+
+static obs_property_t *property_add(obs_properties_t *props, const char *name)
+{
+    obs_property_t *property = bzalloc(sizeof(obs_property_t));
+    property->name = bstrdup(name);
+    
+    obs_property_t **last = &props->first;
+    while (*last) last = &(*last)->next;
+    *last = property;
+    return property;
+}
+
+obs_properties_t *obs_properties_create(void)
+{
+    return bzalloc(sizeof(obs_properties_t));
+}
+
+obs_property_t *obs_properties_get(obs_properties_t *props, const char *property)
+{
+    for (obs_property_t *p = props ? props->first : NULL; p; p = p->next) {
+        if (strcmp(p->name, property) == 0) return p;
+    }
+    return NULL;
+}
+
+void obs_properties_remove_by_name(obs_properties_t *props, const char *property)
+{
+    for (obs_property_t **p = props ? &props->first : NULL; p && *p; p = &(*p)->next) {
+        if (strcmp((*p)->name, property) != 0) continue;
+        
+        obs_property_t *removed = *p;
+        *p = removed->next;
+        bfree(removed->name);
+        bfree(removed);
+        return;
+    }
+}
+
+obs_property_t *obs_properties_add_bool(obs_properties_t *props, const char *name, const char *description)
+{
+    UNUSED_PARAMETER(description);
+    return property_add(props, name);
+}
+
+obs_property_t *obs_properties_add_int(obs_properties_t *props, const char *name, const char *description, int min,
+                                       int max, int step)
+{
+    UNUSED_PARAMETER(description);
+    UNUSED_PARAMETER(min);
+    UNUSED_PARAMETER(max);
+    UNUSED_PARAMETER(step);
+    return property_add(props, name);
+}
+
+obs_property_t *obs_properties_add_int_slider(obs_properties_t *props, const char *name, const char *description,
+                                              int min, int max, int step)
+{
+    return obs_properties_add_int(props, name, description, min, max, step);
+}
+
+obs_property_t *obs_properties_add_float(obs_properties_t *props, const char *name, const char *description,
+                                         double min, double max, double step)
+{
+    UNUSED_PARAMETER(description);
+    UNUSED_PARAMETER(min);
+    UNUSED_PARAMETER(max);
+    UNUSED_PARAMETER(step);
+    return property_add(props, name);
+}
+
+obs_property_t *obs_properties_add_float_slider(obs_properties_t *props, const char *name, const char *description,
+                                                double min, double max, double step)
+{
+    return obs_properties_add_float(props, name, description, min, max, step);
+}
+
+obs_property_t *obs_properties_add_text(obs_properties_t *props, const char *name, const char *description,
+                                        enum obs_text_type type)
+{
+    UNUSED_PARAMETER(description);
+    UNUSED_PARAMETER(type);
+    return property_add(props, name);
+}
+
+obs_property_t *obs_properties_add_path(obs_properties_t *props, const char *name, const char *description,
+                                        enum obs_path_type type, const char *filter, const char *default_path)
+{
+    UNUSED_PARAMETER(description);
+    UNUSED_PARAMETER(type);
+    UNUSED_PARAMETER(filter);
+    UNUSED_PARAMETER(default_path);
+    return property_add(props, name);
+}
+
+obs_property_t *obs_properties_add_list(obs_properties_t *props, const char *name, const char *description,
+                                        enum obs_combo_type type, enum obs_combo_format format)
+{
+    UNUSED_PARAMETER(description);
+    UNUSED_PARAMETER(type);
+    UNUSED_PARAMETER(format);
+    return property_add(props, name);
+}
+
+obs_property_t *obs_properties_add_color(obs_properties_t *props, const char *name, const char *description)
+{
+    UNUSED_PARAMETER(description);
+    return property_add(props, name);
+}
+
+obs_property_t *obs_properties_add_button(obs_properties_t *props, const char *name, const char *text,
+                                          obs_property_clicked_t callback)
+{
+    UNUSED_PARAMETER(text);
+    UNUSED_PARAMETER(callback);
+    return property_add(props, name);
+}
+
+size_t obs_property_list_add_int(obs_property_t *p, const char *name, long long val)
+{
+    UNUSED_PARAMETER(p);
+    UNUSED_PARAMETER(name);
+    UNUSED_PARAMETER(val);
+    return 0;
+}
+
+size_t obs_property_list_add_string(obs_property_t *p, const char *name, const char *val)
+{
+    UNUSED_PARAMETER(p);
+    UNUSED_PARAMETER(name);
+    UNUSED_PARAMETER(val);
+    return 0;
+}
+
+void obs_property_set_visible(obs_property_t *p, bool visible)
+{
+    UNUSED_PARAMETER(p);
+    UNUSED_PARAMETER(visible);
+}
+
+void obs_property_set_long_description(obs_property_t *p, const char *long_description)
+{
+    UNUSED_PARAMETER(p);
+    UNUSED_PARAMETER(long_description);
+}
+
+void obs_property_set_modified_callback(obs_property_t *p, obs_property_modified_t modified)
+{
+    UNUSED_PARAMETER(p);
+    UNUSED_PARAMETER(modified);
+}
+
+static obs_hotkey_id next_hotkey = 0;
+
+obs_hotkey_id obs_hotkey_register_source(obs_source_t *source, const char *name, const char *description,
+                                         obs_hotkey_func func, void *data)
+{
+    UNUSED_PARAMETER(source);
+    UNUSED_PARAMETER(name);
+    UNUSED_PARAMETER(description);
+    UNUSED_PARAMETER(func);
+    UNUSED_PARAMETER(data);
+    return next_hotkey++;
+}
+
+void obs_hotkey_unregister(obs_hotkey_id id)
+{
+    UNUSED_PARAMETER(id);
+}
+
+// ============================================================================
+// Core, sources and module
+// ============================================================================
+
+struct obs_source {
+    volatile long refs;
+    char *name;
+    const struct obs_source_info *info;  // NULL for the program scene
+    obs_data_t *settings;
+    void *data;
+    obs_source_t *parent;
+};
+
+struct main_render_callback {
+    void (*draw)(void *param, uint32_t cx, uint32_t cy);
+    void *param;
+};
+
+static DARRAY(struct obs_source_info) source_infos;
+static DARRAY(struct main_render_callback) main_render_callbacks;
+static struct obs_source program_scene = {1, "Program", NULL, NULL, NULL, NULL};
+
+void obs_register_source_s(const struct obs_source_info *info, size_t size)
+{
+    struct obs_source_info *copy = da_push_back_new(source_infos);
+    memcpy(copy, info, size < sizeof(*copy) ? size : sizeof(*copy));
+}
+
+gs_effect_t *obs_get_base_effect(enum obs_base_effect effect)
+{
+    return effect <= OBS_EFFECT_AREA ? &base_effects[effect] : NULL;
+}
+
+uint64_t obs_get_video_frame_time(void)
+{
+    return frame_time;
+}
+
+bool obs_get_video_info(struct obs_video_info *ovi)
+{
+    memset(ovi, 0, sizeof(*ovi));
+    ovi->graphics_module = "mock";
+    ovi->fps_num = 60;
+    ovi->fps_den = 1;
+    ovi->base_width = video_width;
+    ovi->base_height = video_height;
+    ovi->output_width = video_width;
+    ovi->output_height = video_height;
+    return true;
+}
+
+gs_texture_t *obs_get_main_texture(void)
+{
+    main_texture.width = video_width;
+    main_texture.height = video_height;
+    main_texture.format = GS_RGBA;
+    return &main_texture;
+}
+
+void obs_enter_graphics(void)
+{
+}
+
+void obs_leave_graphics(void)
+{
+}
+
+obs_source_t *obs_get_output_source(uint32_t channel)
+{
+    if (channel != 0) return NULL;
+    
+    os_atomic_inc_long(&program_scene.refs);
+    return &program_scene;
+}
+
+// Sources are owned by the benchmark (mock_obs_source_destroy), never freed here
+void obs_source_release(obs_source_t *source)
+{
+    if (source) os_atomic_dec_long(&source->refs);
+}
+
+// The program scene costs one full-canvas sprite
+void obs_source_video_render(obs_source_t *source)
+{
+    if (!source) return;
+    
+    if (source->info && source->info->video_render) {
+        source->info->video_render(source->data, NULL);
+    } else {
+        gs_draw_sprite(NULL, 0, video_width, video_height);
+    }
+}
+
+enum obs_source_type obs_source_get_type(const obs_source_t *source)
+{
+    return source && source->info ? source->info->type : OBS_SOURCE_TYPE_SCENE;
+}
+
+obs_source_t *obs_filter_get_target(const obs_source_t *filter)
+{
+    return filter ? filter->parent : NULL;
+}
+
+obs_source_t *obs_filter_get_parent(const obs_source_t *filter)
+{
+    return filter ? filter->parent : NULL;
+}
+
+void obs_source_skip_video_filter(obs_source_t *filter)
+{
+    if (filter) obs_source_video_render(filter->parent);
+}
+
+bool obs_source_process_filter_begin(obs_source_t *filter, enum gs_color_format format,
+                                     enum obs_allow_direct_render allow_direct)
+{
+    UNUSED_PARAMETER(format);
+    UNUSED_PARAMETER(allow_direct);
+    RECORD();
+    if (!filter) return false;
+    
+    stats.render_targets++;
+    obs_source_video_render(filter->parent);
+    return true;
+}
+
+void obs_source_process_filter_end(obs_source_t *filter, gs_effect_t *effect, uint32_t width, uint32_t height)
+{
+    UNUSED_PARAMETER(filter);
+    UNUSED_PARAMETER(effect);
+    gs_draw_sprite(NULL, 0, width, height);
+}
+
+uint32_t obs_source_get_width(obs_source_t *source)
+{
+    if (!source) return 0;
+    
+    if (source->info && source->info->get_width) return source->info->get_width(source->data);
+    return source->info && source->parent ? obs_source_get_width(source->parent) : video_width;
+}
+
+uint32_t obs_source_get_height(obs_source_t *source)
+{
+    if (!source) return 0;
+    
+    if (source->info && source->info->get_height) return source->info->get_height(source->data);
+    return source->info && source->parent ? obs_source_get_height(source->parent) : video_height;
+}
+
+uint32_t obs_source_get_base_width(obs_source_t *source)
+{
+    return obs_source_get_width(source);
+}
+
+uint32_t obs_source_get_base_height(obs_source_t *source)
+{
+    return obs_source_get_height(source);
+}
+
+const char *obs_source_get_name(const obs_source_t *source)
+{
+    return source ? source->name : NULL;
+}
+
+obs_data_t *obs_source_get_settings(const obs_source_t *source)
+{
+    if (!source || !source->settings) return NULL;
+    
+    os_atomic_inc_long(&source->settings->refs);
+    return source->settings;
+}
+
+bool obs_source_active(const obs_source_t *source)
+{
+    return source != NULL;
+}
+
+bool obs_source_showing(const obs_source_t *source)
+{
+    return source != NULL;
+}
+
+void obs_source_update(obs_source_t *source, obs_data_t *settings)
+{
+    if (!source || !source->settings) return;
+    
+    if (settings) data_apply(source->settings, settings);
+    if (source->info && source->info->update) source->info->update(source->data, source->settings);
+}
+
+void obs_add_main_render_callback(void (*draw)(void *param, uint32_t cx, uint32_t cy), void *param)
+{
+    struct main_render_callback callback = {draw, param};
+    da_push_back(main_render_callbacks, &callback);
+}
+
+void obs_remove_main_render_callback(void (*draw)(void *param, uint32_t cx, uint32_t cy), void *param)
+{
+    for (size_t i = 0; i < main_render_callbacks.num; i++) {
+        if (main_render_callbacks.array[i].draw == draw && main_render_callbacks.array[i].param == param) {
+            da_erase(main_render_callbacks, i);
+            return;
+        }
+    }
+}
+
+char *obs_module_file(const char *file)
+{
+    struct dstr path;
+    dstr_init(&path);
+    dstr_printf(&path, "%s/%s", MOCK_OBS_DATA_DIR, file);
+    return path.array;
+}
+
+char *obs_module_config_path(const char *file)
+{
+    return os_get_config_path_ptr(file);
+}
+
+const char *obs_module_text(const char *lookup_string)
+{
+    return lookup_string;
+}
+
+// ============================================================================
+// Benchmark controls
+// ============================================================================
+
+void mock_gs_stats_reset(void)
+{
+    memset(&stats, 0, sizeof(stats));
+    __atomic_store_n(&allocations, 0, __ATOMIC_RELAXED);
+}
+
+void mock_gs_stats_get(struct mock_gs_stats *out)
+{
+    *out = stats;
+    out->allocations = __atomic_load_n(&allocations, __ATOMIC_RELAXED);
+}
+
+long mock_gs_live_resources(void)
+{
+    return live_resources;
+}
+
+void mock_obs_set_log_level(int max_level)
+{
+    log_level = max_level;
+}
+
+void mock_obs_set_video(uint32_t base_width, uint32_t base_height)
+{
+    video_width = base_width;
+    video_height = base_height;
+    viewport = (struct gs_rect){0, 0, (int)base_width, (int)base_height};
+}
+
+void mock_obs_begin_frame(uint64_t interval_ns)
+{
+    frame_time += interval_ns;
+    
+    for (size_t i = 0; i < main_render_callbacks.num; i++) {
+        const struct main_render_callback callback = main_render_callbacks.array[i];
+        callback.draw(callback.param, video_width, video_height);
+    }
+}
+
+const struct obs_source_info *mock_obs_find_source_info(const char *id)
+{
+    for (size_t i = 0; i < source_infos.num; i++) {
+        if (strcmp(source_infos.array[i].id, id) == 0) return &source_infos.array[i];
+    }
+    return NULL;
+}
+
+obs_source_t *mock_obs_source_create(const char *id, const char *name, obs_data_t *settings, obs_source_t *parent)
+{
+    const struct obs_source_info *info = mock_obs_find_source_info(id);
+    if (!info || !info->create) return NULL;
+    
+    obs_source_t *source = bzalloc(sizeof(obs_source_t));
+    source->refs = 1;
+    source->name = bstrdup(name);
+    source->info = info;
+    source->parent = parent;
+    source->settings = obs_data_create();
+    if (info->get_defaults) info->get_defaults(source->settings);
+    if (settings) data_apply(source->settings, settings);
+    
+    source->data = info->create(source->settings, source);
+    if (!source->data) {
+        mock_obs_source_destroy(source);
+        return NULL;
+    }
+    
+    // Live on program and visible in the preview
+    if (info->activate) info->activate(source->data);
+    if (info->show) info->show(source->data);
+    return source;
+}
+
+void mock_obs_source_destroy(obs_source_t *source)
+{
+    if (!source) return;
+    
+    if (source->data) {
+        if (source->info->hide) source->info->hide(source->data);
+        if (source->info->deactivate) source->info->deactivate(source->data);
+        if (source->info->destroy) source->info->destroy(source->data);
+    }
+    obs_data_release(source->settings);
+    bfree(source->name);
+    bfree(source);
+}
+
+void mock_obs_source_set_visible(obs_source_t *source, bool visible)
+{
+    if (!source || !source->data) return;
+    
+    if (visible) {
+        if (source->info->activate) source->info->activate(source->data);
+        if (source->info->show) source->info->show(source->data);
+    } else {
+        if (source->info->deactivate) source->info->deactivate(source->data);
+        if (source->info->hide) source->info->hide(source->data);
+    }
+}
+
+void mock_obs_source_tick(obs_source_t *source, float seconds)
+{
+    if (source && source->info->video_tick) source->info->video_tick(source->data, seconds);
+}
+
+void mock_obs_source_render(obs_source_t *source)
+{
+    obs_source_video_render(source);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+// Controls for the mock libobs the benchmark links against.
+// The mock runs sources on the calling thread, records every graphics call
+// instead of drawing, and counts allocations, so a frame's CPU cost and its
+// draw/vertex/uniform traffic can be measured without OBS or a GPU.
+
+#include <obs.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct mock_gs_stats {
+    uint64_t calls;           // Every gs_* entry point
+    uint64_t draws;           // gs_draw, sprites, immediate-mode batches
+    uint64_t vertices;        // Vertices submitted by those draws
+    uint64_t uniforms;        // gs_effect_set_* uploads
+    uint64_t render_targets;  // gs_texrender_begin
+    uint64_t resources;       // Buffers, textures and surfaces created
+    uint64_t allocations;     // bmalloc/brealloc
+};
+
+void mock_gs_stats_reset(void);
+void mock_gs_stats_get(struct mock_gs_stats *stats);
+
+// Textures, render targets, buffers and staging surfaces not destroyed yet
+long mock_gs_live_resources(void);
+
+void mock_obs_set_log_level(int max_level);  // blog() levels up to this are printed
+void mock_obs_set_video(uint32_t base_width, uint32_t base_height);
+
+// Advances obs_get_video_frame_time() and runs the main render callbacks, like
+// the start of an OBS frame
+void mock_obs_begin_frame(uint64_t interval_ns);
+
+const struct obs_source_info *mock_obs_find_source_info(const char *id);
+
+// Applies get_defaults, then settings, then create, activate and show; parent is
+// the filter target
+obs_source_t *mock_obs_source_create(const char *id, const char *name, obs_data_t *settings,
+                                     obs_source_t *parent);
+void mock_obs_source_destroy(obs_source_t *source);
+// Activate and show, or deactivate and hide, like adding the source to or
+// removing it from the program scene
+void mock_obs_source_set_visible(obs_source_t *source, bool visible);
+void mock_obs_source_tick(obs_source_t *source, float seconds);
+void mock_obs_source_render(obs_source_t *source);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,113 @@
+#pragma once
+
+// Benchmark mock of the libobs header of the same name: just the subset the plugin uses,
+// implemented by bench/mock-obs.c.
+
+#include "../util/bmem.h"
+#include "vec2.h"
+#include "vec3.h"
+#include "vec4.h"
+#include "matrix4.h"
+enum gs_draw_mode { GS_POINTS, GS_LINES, GS_LINESTRIP, GS_TRIS, GS_TRISTRIP };
+enum gs_color_format { GS_UNKNOWN, GS_A8, GS_R8, GS_RGBA, GS_BGRX, GS_BGRA, GS_R10G10B10A2, GS_RGBA16, GS_R16, GS_RGBA16F, GS_RGBA32F, GS_RG16F, GS_RG32F, GS_R16F, GS_R32F, GS_DXT1, GS_DXT3, GS_DXT5, GS_R8G8, GS_RGBA_UNORM, GS_BGRX_UNORM, GS_BGRA_UNORM, GS_RG16 };
+enum gs_zstencil_format { GS_ZS_NONE, GS_Z16, GS_Z24_S8, GS_Z32F, GS_Z32F_S8X24 };
+enum gs_blend_type { GS_BLEND_ZERO, GS_BLEND_ONE, GS_BLEND_SRCCOLOR, GS_BLEND_INVSRCCOLOR, GS_BLEND_SRCALPHA, GS_BLEND_INVSRCALPHA, GS_BLEND_DSTCOLOR, GS_BLEND_INVDSTCOLOR, GS_BLEND_DSTALPHA, GS_BLEND_INVDSTALPHA, GS_BLEND_SRCALPHASAT };
+enum gs_sample_filter { GS_FILTER_POINT, GS_FILTER_LINEAR };
+enum gs_address_mode { GS_ADDRESS_CLAMP, GS_ADDRESS_WRAP };
+#define GS_CLEAR_COLOR (1 << 0)
+#define GS_CLEAR_DEPTH (1 << 1)
+#define GS_CLEAR_STENCIL (1 << 2)
+#define GS_DYNAMIC (1 << 1)
+#define GS_RENDER_TARGET (1 << 2)
+struct gs_tvertarray { size_t width; void *array; };
+struct gs_vb_data { size_t num; struct vec3 *points; struct vec3 *normals; struct vec3 *tangents; uint32_t *colors; size_t num_tex; struct gs_tvertarray *tvarray; };
+struct gs_sampler_info { enum gs_sample_filter filter; enum gs_address_mode address_u, address_v, address_w; int max_anisotropy; uint32_t border_color; };
+struct gs_rect { int x, y, cx, cy; };
+typedef struct gs_effect gs_effect_t;
+typedef struct gs_effect_technique gs_technique_t;
+typedef struct gs_effect_param gs_eparam_t;
+typedef struct gs_vertex_buffer gs_vertbuffer_t;
+typedef struct gs_index_buffer gs_indexbuffer_t;
+typedef struct gs_texture gs_texture_t;
+typedef struct gs_stage_surface gs_stagesurf_t;
+typedef struct gs_sampler_state gs_samplerstate_t;
+typedef struct gs_texture_render gs_texrender_t;
+static inline struct gs_vb_data *gs_vbdata_create(void) { return (struct gs_vb_data *)bzalloc(sizeof(struct gs_vb_data)); }
+void gs_vbdata_destroy(struct gs_vb_data *data);
+gs_vertbuffer_t *gs_vertexbuffer_create(struct gs_vb_data *data, uint32_t flags);
+void gs_vertexbuffer_destroy(gs_vertbuffer_t *vertbuffer);
+void gs_vertexbuffer_flush(gs_vertbuffer_t *vertbuffer);
+struct gs_vb_data *gs_vertexbuffer_get_data(const gs_vertbuffer_t *vertbuffer);
+void gs_load_vertexbuffer(gs_vertbuffer_t *vertbuffer);
+void gs_load_indexbuffer(gs_indexbuffer_t *indexbuffer);
+void gs_draw(enum gs_draw_mode draw_mode, uint32_t start_vert, uint32_t num_verts);
+void gs_render_start(bool b_new);
+void gs_render_stop(enum gs_draw_mode mode);
+void gs_vertex2f(float x, float y);
+void gs_vertex3f(float x, float y, float z);
+void gs_color(uint32_t color);
+void gs_texcoord(float x, float y, int unit);
+gs_eparam_t *gs_effect_get_param_by_name(const gs_effect_t *effect, const char *name);
+gs_technique_t *gs_effect_get_technique(const gs_effect_t *effect, const char *name);
+size_t gs_technique_begin(gs_technique_t *technique);
+void gs_technique_end(gs_technique_t *technique);
+bool gs_technique_begin_pass(gs_technique_t *technique, size_t pass);
+void gs_technique_end_pass(gs_technique_t *technique);
+bool gs_effect_loop(gs_effect_t *effect, const char *name);
+void gs_effect_set_vec4(gs_eparam_t *param, const struct vec4 *val);
+void gs_effect_set_vec2(gs_eparam_t *param, const struct vec2 *val);
+void gs_effect_set_float(gs_eparam_t *param, float val);
+void gs_effect_set_int(gs_eparam_t *param, int val);
+void gs_effect_set_bool(gs_eparam_t *param, bool val);
+void gs_effect_set_texture(gs_eparam_t *param, gs_texture_t *val);
+void gs_effect_set_next_sampler(gs_eparam_t *param, gs_samplerstate_t *sampler);
+gs_effect_t *gs_effect_create_from_file(const char *file, char **error_string);
+void gs_effect_destroy(gs_effect_t *effect);
+void gs_blend_state_push(void);
+void gs_blend_state_pop(void);
+void gs_reset_blend_state(void);
+void gs_enable_blending(bool enable);
+void gs_blend_function(enum gs_blend_type src, enum gs_blend_type dest);
+void gs_blend_function_separate(enum gs_blend_type src_c, enum gs_blend_type dest_c, enum gs_blend_type src_a, enum gs_blend_type dest_a);
+gs_texrender_t *gs_texrender_create(enum gs_color_format format, enum gs_zstencil_format zsformat);
+void gs_texrender_destroy(gs_texrender_t *texrender);
+bool gs_texrender_begin(gs_texrender_t *texrender, uint32_t cx, uint32_t cy);
+void gs_texrender_end(gs_texrender_t *texrender);
+void gs_texrender_reset(gs_texrender_t *texrender);
+gs_texture_t *gs_texrender_get_texture(const gs_texrender_t *texrender);
+void gs_ortho(float left, float right, float top, float bottom, float znear, float zfar);
+void gs_clear(uint32_t clear_flags, const struct vec4 *color, float depth, uint8_t stencil);
+void gs_draw_sprite(gs_texture_t *tex, uint32_t flip, uint32_t width, uint32_t height);
+void gs_draw_sprite_subregion(gs_texture_t *tex, uint32_t flip, uint32_t x, uint32_t y, uint32_t cx, uint32_t cy);
+void gs_projection_push(void);
+void gs_projection_pop(void);
+void gs_viewport_push(void);
+void gs_viewport_pop(void);
+void gs_set_viewport(int x, int y, int width, int height);
+void gs_get_viewport(struct gs_rect *rect);
+void gs_matrix_push(void);
+void gs_matrix_pop(void);
+void gs_matrix_identity(void);
+void gs_matrix_translate3f(float x, float y, float z);
+void gs_matrix_scale3f(float x, float y, float z);
+void gs_matrix_get(struct matrix4 *dst);
+uint32_t gs_texture_get_width(const gs_texture_t *tex);
+uint32_t gs_texture_get_height(const gs_texture_t *tex);
+gs_texture_t *gs_texture_create(uint32_t width, uint32_t height, enum gs_color_format color_format, uint32_t levels, const uint8_t **data, uint32_t flags);
+void gs_texture_destroy(gs_texture_t *tex);
+void gs_copy_texture_region(gs_texture_t *dst, uint32_t dst_x, uint32_t dst_y, gs_texture_t *src, uint32_t src_x, uint32_t src_y, uint32_t src_w, uint32_t src_h);
+gs_stagesurf_t *gs_stagesurface_create(uint32_t width, uint32_t height, enum gs_color_format color_format);
+void gs_stagesurface_destroy(gs_stagesurf_t *stagesurf);
+bool gs_stagesurface_map(gs_stagesurf_t *stagesurf, uint8_t **data, uint32_t *linesize);
+void gs_stagesurface_unmap(gs_stagesurf_t *stagesurf);
+void gs_stage_texture(gs_stagesurf_t *dst, gs_texture_t *src);
+gs_samplerstate_t *gs_samplerstate_create(const struct gs_sampler_info *info);
+void gs_samplerstate_destroy(gs_samplerstate_t *samplerstate);
+bool gs_framebuffer_srgb_enabled(void);
+void gs_enable_framebuffer_srgb(bool enable);
+enum gs_index_type { GS_UNSIGNED_SHORT, GS_UNSIGNED_LONG };
+enum gs_cull_mode { GS_BACK, GS_FRONT, GS_NEITHER };
+gs_indexbuffer_t *gs_indexbuffer_create(enum gs_index_type type, void *indices, size_t num, uint32_t flags);
+void gs_indexbuffer_destroy(gs_indexbuffer_t *indexbuffer);
+void gs_set_cull_mode(enum gs_cull_mode mode);
+enum gs_cull_mode gs_get_cull_mode(void);
@@ -0,0 +1,11 @@
+#pragma once
+
+// Benchmark mock of the libobs header of the same name: just the subset the plugin uses,
+// implemented by bench/mock-obs.c.
+
+#include "graphics.h"
+struct gs_image_file { gs_texture_t *texture; enum gs_color_format format; uint32_t cx; uint32_t cy; bool is_animated_gif; bool loaded; uint8_t *texture_data; };
+typedef struct gs_image_file gs_image_file_t;
+void gs_image_file_init(gs_image_file_t *image, const char *file);
+void gs_image_file_free(gs_image_file_t *image);
+void gs_image_file_init_texture(gs_image_file_t *image);
@@ -0,0 +1,7 @@
+#pragma once
+
+// Benchmark mock of the libobs header of the same name: just the subset the plugin uses,
+// implemented by bench/mock-obs.c.
+
+#include "vec4.h"
+struct matrix4 { struct vec4 x, y, z, t; };
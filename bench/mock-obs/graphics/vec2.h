@@ -0,0 +1,9 @@
+#pragma once
+
+// Benchmark mock of the libobs header of the same name: just the subset the plugin uses,
+// implemented by bench/mock-obs.c.
+
+#include "../util/c99defs.h"
+struct vec2 { union { struct { float x, y; }; float ptr[2]; }; };
+static inline void vec2_set(struct vec2 *dst, float x, float y) { dst->x = x; dst->y = y; }
+static inline void vec2_zero(struct vec2 *v) { vec2_set(v, 0, 0); }
@@ -0,0 +1,9 @@
+#pragma once
+
+// Benchmark mock of the libobs header of the same name: just the subset the plugin uses,
+// implemented by bench/mock-obs.c.
+
+#include "../util/c99defs.h"
+struct vec3 { union { struct { float x, y, z, w; }; float ptr[4]; }; };
+static inline void vec3_set(struct vec3 *dst, float x, float y, float z) { dst->x = x; dst->y = y; dst->z = z; dst->w = 0.0f; }
+static inline void vec3_zero(struct vec3 *v) { vec3_set(v, 0, 0, 0); }
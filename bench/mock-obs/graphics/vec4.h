@@ -0,0 +1,10 @@
+#pragma once
+
+// Benchmark mock of the libobs header of the same name: just the subset the plugin uses,
+// implemented by bench/mock-obs.c.
+
+#include "../util/c99defs.h"
+struct vec4 { union { struct { float x, y, z, w; }; float ptr[4]; }; };
+static inline void vec4_set(struct vec4 *dst, float x, float y, float z, float w) { dst->x = x; dst->y = y; dst->z = z; dst->w = w; }
+static inline void vec4_zero(struct vec4 *v) { vec4_set(v, 0, 0, 0, 0); }
+static inline void vec4_from_rgba(struct vec4 *dst, uint32_t rgba) { dst->x = (rgba & 0xFF) / 255.0f; dst->y = ((rgba >> 8) & 0xFF) / 255.0f; dst->z = ((rgba >> 16) & 0xFF) / 255.0f; dst->w = ((rgba >> 24) & 0xFF) / 255.0f; }
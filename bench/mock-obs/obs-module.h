@@ -0,0 +1,14 @@
+#pragma once
+
+// Benchmark mock of the libobs header of the same name: just the subset the plugin uses,
+// implemented by bench/mock-obs.c.
+
+#include "obs.h"
+#define OBS_DECLARE_MODULE() obs_module_t *obs_current_module(void); void obs_module_set_pointer(obs_module_t *module);
+#define OBS_MODULE_USE_DEFAULT_LOCALE(a, b) const char *obs_module_text(const char *lookup_string);
+char *obs_module_file(const char *file);
+char *obs_module_config_path(const char *file);
+bool obs_module_load(void);
+void obs_module_unload(void);
+const char *obs_module_description(void);
+const char *obs_module_name(void);
@@ -0,0 +1,127 @@
+#pragma once
+
+// Benchmark mock of the libobs header of the same name: just the subset the plugin uses,
+// implemented by bench/mock-obs.c.
+
+#include "util/c99defs.h"
+#include "util/bmem.h"
+#include "util/base.h"
+#include "graphics/graphics.h"
+typedef struct obs_source obs_source_t;
+typedef struct obs_data obs_data_t;
+typedef struct obs_data_array obs_data_array_t;
+typedef struct obs_properties obs_properties_t;
+typedef struct obs_property obs_property_t;
+typedef struct obs_module obs_module_t;
+typedef size_t obs_hotkey_id;
+typedef struct obs_hotkey obs_hotkey_t;
+#define OBS_INVALID_HOTKEY_ID (~(obs_hotkey_id)0)
+enum obs_source_type { OBS_SOURCE_TYPE_INPUT, OBS_SOURCE_TYPE_FILTER, OBS_SOURCE_TYPE_TRANSITION, OBS_SOURCE_TYPE_SCENE };
+enum obs_base_effect { OBS_EFFECT_DEFAULT, OBS_EFFECT_DEFAULT_RECT, OBS_EFFECT_OPAQUE, OBS_EFFECT_SOLID, OBS_EFFECT_BICUBIC, OBS_EFFECT_LANCZOS, OBS_EFFECT_BILINEAR_LOWRES, OBS_EFFECT_PREMULTIPLIED_ALPHA, OBS_EFFECT_REPEAT, OBS_EFFECT_AREA };
+enum obs_icon_type { OBS_ICON_TYPE_UNKNOWN, OBS_ICON_TYPE_IMAGE, OBS_ICON_TYPE_COLOR, OBS_ICON_TYPE_SLIDESHOW, OBS_ICON_TYPE_AUDIO_INPUT, OBS_ICON_TYPE_AUDIO_OUTPUT, OBS_ICON_TYPE_DESKTOP_CAPTURE };
+enum obs_text_type { OBS_TEXT_DEFAULT, OBS_TEXT_PASSWORD, OBS_TEXT_MULTILINE, OBS_TEXT_INFO };
+enum obs_combo_type { OBS_COMBO_TYPE_INVALID, OBS_COMBO_TYPE_EDITABLE, OBS_COMBO_TYPE_LIST, OBS_COMBO_TYPE_RADIO };
+enum obs_combo_format { OBS_COMBO_FORMAT_INVALID, OBS_COMBO_FORMAT_INT, OBS_COMBO_FORMAT_FLOAT, OBS_COMBO_FORMAT_STRING, OBS_COMBO_FORMAT_BOOL };
+enum obs_path_type { OBS_PATH_FILE, OBS_PATH_FILE_SAVE, OBS_PATH_DIRECTORY };
+enum obs_allow_direct_render { OBS_NO_DIRECT_RENDERING, OBS_ALLOW_DIRECT_RENDERING };
+#define OBS_SOURCE_VIDEO (1 << 0)
+#define OBS_SOURCE_CUSTOM_DRAW (1 << 3)
+#define OBS_SOURCE_SRGB (1 << 15)
+struct obs_video_info { const char *graphics_module; uint32_t fps_num, fps_den, base_width, base_height, output_width, output_height; int output_format; uint32_t adapter; bool gpu_conversion; int colorspace; int range; int scale_type; };
+struct obs_source_info {
+	const char *id; enum obs_source_type type; uint32_t output_flags;
+	const char *(*get_name)(void *type_data);
+	void *(*create)(obs_data_t *settings, obs_source_t *source);
+	void (*destroy)(void *data);
+	uint32_t (*get_width)(void *data);
+	uint32_t (*get_height)(void *data);
+	void (*get_defaults)(obs_data_t *settings);
+	obs_properties_t *(*get_properties)(void *data);
+	void (*update)(void *data, obs_data_t *settings);
+	void (*activate)(void *data);
+	void (*deactivate)(void *data);
+	void (*show)(void *data);
+	void (*hide)(void *data);
+	void (*video_tick)(void *data, float seconds);
+	void (*video_render)(void *data, gs_effect_t *effect);
+	enum obs_icon_type icon_type;
+};
+typedef bool (*obs_property_clicked_t)(obs_properties_t *props, obs_property_t *property, void *data);
+typedef bool (*obs_property_modified_t)(obs_properties_t *props, obs_property_t *property, obs_data_t *settings);
+typedef void (*obs_hotkey_func)(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed);
+void obs_register_source_s(const struct obs_source_info *info, size_t size);
+#define obs_register_source(info) obs_register_source_s(info, sizeof(struct obs_source_info))
+gs_effect_t *obs_get_base_effect(enum obs_base_effect effect);
+uint64_t obs_get_video_frame_time(void);
+bool obs_get_video_info(struct obs_video_info *ovi);
+gs_texture_t *obs_get_main_texture(void);
+void obs_enter_graphics(void);
+void obs_leave_graphics(void);
+obs_source_t *obs_get_output_source(uint32_t channel);
+void obs_source_release(obs_source_t *source);
+void obs_source_video_render(obs_source_t *source);
+enum obs_source_type obs_source_get_type(const obs_source_t *source);
+obs_source_t *obs_filter_get_target(const obs_source_t *filter);
+obs_source_t *obs_filter_get_parent(const obs_source_t *filter);
+void obs_source_skip_video_filter(obs_source_t *filter);
+bool obs_source_process_filter_begin(obs_source_t *filter, enum gs_color_format format, enum obs_allow_direct_render allow_direct);
+void obs_source_process_filter_end(obs_source_t *filter, gs_effect_t *effect, uint32_t width, uint32_t height);
+uint32_t obs_source_get_base_width(obs_source_t *source);
+uint32_t obs_source_get_base_height(obs_source_t *source);
+uint32_t obs_source_get_width(obs_source_t *source);
+uint32_t obs_source_get_height(obs_source_t *source);
+const char *obs_source_get_name(const obs_source_t *source);
+void obs_properties_remove_by_name(obs_properties_t *props, const char *property);
+obs_data_t *obs_source_get_settings(const obs_source_t *source);
+bool obs_source_active(const obs_source_t *source);
+bool obs_source_showing(const obs_source_t *source);
+obs_data_t *obs_data_create(void);
+obs_data_t *obs_data_create_from_json_file(const char *json_file);
+obs_data_t *obs_data_create_from_json(const char *json_string);
+void obs_source_update(obs_source_t *source, obs_data_t *settings);
+void obs_data_release(obs_data_t *data);
+bool obs_data_save_json(obs_data_t *data, const char *file);
+bool obs_data_save_json_safe(obs_data_t *data, const char *file, const char *temp_ext, const char *backup_ext);
+bool obs_data_get_bool(obs_data_t *data, const char *name);
+long long obs_data_get_int(obs_data_t *data, const char *name);
+double obs_data_get_double(obs_data_t *data, const char *name);
+const char *obs_data_get_string(obs_data_t *data, const char *name);
+obs_data_t *obs_data_get_obj(obs_data_t *data, const char *name);
+obs_data_array_t *obs_data_get_array(obs_data_t *data, const char *name);
+bool obs_data_has_user_value(obs_data_t *data, const char *name);
+void obs_data_set_bool(obs_data_t *data, const char *name, bool val);
+void obs_data_set_int(obs_data_t *data, const char *name, long long val);
+void obs_data_set_double(obs_data_t *data, const char *name, double val);
+void obs_data_set_string(obs_data_t *data, const char *name, const char *val);
+void obs_data_set_obj(obs_data_t *data, const char *name, obs_data_t *obj);
+void obs_data_set_array(obs_data_t *data, const char *name, obs_data_array_t *array);
+void obs_data_set_default_bool(obs_data_t *data, const char *name, bool val);
+void obs_data_set_default_int(obs_data_t *data, const char *name, long long val);
+void obs_data_set_default_double(obs_data_t *data, const char *name, double val);
+void obs_data_set_default_string(obs_data_t *data, const char *name, const char *val);
+obs_data_array_t *obs_data_array_create(void);
+void obs_data_array_release(obs_data_array_t *array);
+size_t obs_data_array_count(obs_data_array_t *array);
+obs_data_t *obs_data_array_item(obs_data_array_t *array, size_t idx);
+size_t obs_data_array_push_back(obs_data_array_t *array, obs_data_t *obj);
+obs_properties_t *obs_properties_create(void);
+obs_property_t *obs_properties_get(obs_properties_t *props, const char *property);
+obs_property_t *obs_properties_add_bool(obs_properties_t *props, const char *name, const char *description);
+obs_property_t *obs_properties_add_int(obs_properties_t *props, const char *name, const char *description, int min, int max, int step);
+obs_property_t *obs_properties_add_int_slider(obs_properties_t *props, const char *name, const char *description, int min, int max, int step);
+obs_property_t *obs_properties_add_float(obs_properties_t *props, const char *name, const char *description, double min, double max, double step);
+obs_property_t *obs_properties_add_float_slider(obs_properties_t *props, const char *name, const char *description, double min, double max, double step);
+obs_property_t *obs_properties_add_text(obs_properties_t *props, const char *name, const char *description, enum obs_text_type type);
+obs_property_t *obs_properties_add_path(obs_properties_t *props, const char *name, const char *description, enum obs_path_type type, const char *filter, const char *default_path);
+obs_property_t *obs_properties_add_list(obs_properties_t *props, const char *name, const char *description, enum obs_combo_type type, enum obs_combo_format format);
+obs_property_t *obs_properties_add_color(obs_properties_t *props, const char *name, const char *description);
+obs_property_t *obs_properties_add_button(obs_properties_t *props, const char *name, const char *text, obs_property_clicked_t callback);
+size_t obs_property_list_add_int(obs_property_t *p, const char *name, long long val);
+size_t obs_property_list_add_string(obs_property_t *p, const char *name, const char *val);
+void obs_property_set_visible(obs_property_t *p, bool visible);
+void obs_property_set_long_description(obs_property_t *p, const char *long_description);
+void obs_property_set_modified_callback(obs_property_t *p, obs_property_modified_t modified);
+obs_hotkey_id obs_hotkey_register_source(obs_source_t *source, const char *name, const char *description, obs_hotkey_func func, void *data);
+void obs_hotkey_unregister(obs_hotkey_id id);
+void obs_add_main_render_callback(void (*draw)(void *param, uint32_t cx, uint32_t cy), void *param);
+void obs_remove_main_render_callback(void (*draw)(void *param, uint32_t cx, uint32_t cy), void *param);
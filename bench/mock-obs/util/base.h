@@ -0,0 +1,8 @@
+#pragma once
+
+// Benchmark mock of the libobs header of the same name: just the subset the plugin uses,
+// implemented by bench/mock-obs.c.
+
+#include "c99defs.h"
+enum { LOG_ERROR = 100, LOG_WARNING = 200, LOG_INFO = 300, LOG_DEBUG = 400 };
+void blog(int log_level, const char *format, ...) PRINTFATTR(2, 3);
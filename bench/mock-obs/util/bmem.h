@@ -0,0 +1,13 @@
+#pragma once
+
+// Benchmark mock of the libobs header of the same name: just the subset the plugin uses,
+// implemented by bench/mock-obs.c.
+
+#include "c99defs.h"
+#include <string.h>
+void *bmalloc(size_t size);
+void *brealloc(void *ptr, size_t size);
+void bfree(void *ptr);
+static inline void *bzalloc(size_t size) { void *m = bmalloc(size); if (m) memset(m, 0, size); return m; }
+static inline char *bstrdup(const char *str) { return str ? strcpy(bmalloc(strlen(str) + 1), str) : NULL; }
+static inline void *bmemdup(const void *ptr, size_t size) { void *out = bmalloc(size); if (size) memcpy(out, ptr, size); return out; }
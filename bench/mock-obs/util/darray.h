@@ -0,0 +1,24 @@
+#pragma once
+
+// Benchmark mock of the libobs header of the same name: just the subset the plugin uses,
+// implemented by bench/mock-obs.c.
+
+#include "bmem.h"
+struct darray { void *array; size_t num; size_t capacity; };
+#define DARRAY(type) union { struct darray da; struct { type *array; size_t num; size_t capacity; }; }
+void darray_reserve(const size_t element_size, struct darray *dst, const size_t capacity);
+void darray_resize(const size_t element_size, struct darray *dst, const size_t size);
+size_t darray_push_back(const size_t element_size, struct darray *dst, const void *item);
+void *darray_push_back_new(const size_t element_size, struct darray *dst);
+size_t darray_push_back_array(const size_t element_size, struct darray *dst, const void *array, const size_t num);
+void darray_free(struct darray *da);
+void darray_erase(const size_t element_size, struct darray *dst, const size_t idx);
+#define da_init(v) memset(&(v), 0, sizeof(v))
+#define da_free(v) darray_free(&(v).da)
+#define da_reserve(v, capacity) darray_reserve(sizeof(*(v).array), &(v).da, capacity)
+#define da_resize(v, size) darray_resize(sizeof(*(v).array), &(v).da, size)
+#define da_push_back(v, item) darray_push_back(sizeof(*(v).array), &(v).da, item)
+#define da_push_back_new(v) darray_push_back_new(sizeof(*(v).array), &(v).da)
+#define da_push_back_array(dst, src_array, n) darray_push_back_array(sizeof(*(dst).array), &(dst).da, src_array, n)
+#define da_erase(dst, idx) darray_erase(sizeof(*(dst).array), &(dst).da, idx)
+#define da_clear(v) ((v).num = 0)
@@ -0,0 +1,17 @@
+#pragma once
+
+// Benchmark mock of the libobs header of the same name: just the subset the plugin uses,
+// implemented by bench/mock-obs.c.
+
+#include "c99defs.h"
+struct dstr { char *array; size_t len; size_t capacity; };
+static inline void dstr_init(struct dstr *dst) { dst->array = NULL; dst->len = 0; dst->capacity = 0; }
+void dstr_free(struct dstr *dst);
+void dstr_copy(struct dstr *dst, const char *array);
+void dstr_cat(struct dstr *dst, const char *array);
+void dstr_printf(struct dstr *dst, const char *format, ...);
+void dstr_catf(struct dstr *dst, const char *format, ...);
+void dstr_ncat(struct dstr *dst, const char *array, const size_t len);
+void dstr_copy_dstr(struct dstr *dst, const struct dstr *src);
+void dstr_cat_ch(struct dstr *dst, char ch);
+void dstr_init_copy(struct dstr *dst, const char *src);
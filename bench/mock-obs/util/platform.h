@@ -0,0 +1,26 @@
+#pragma once
+
+// Benchmark mock of the libobs header of the same name: just the subset the plugin uses,
+// implemented by bench/mock-obs.c.
+
+#include "c99defs.h"
+#include <wchar.h>
+uint64_t os_gettime_ns(void);
+char *os_generate_formatted_filename(const char *extension, bool space, const char *format);
+int os_mkdirs(const char *path);
+bool os_file_exists(const char *path);
+int64_t os_get_file_size(const char *path);
+void os_sleep_ms(uint32_t duration);
+char *os_get_config_path_ptr(const char *name);
+#include <stdio.h>
+FILE *os_fopen(const char *path, const char *mode);
+void os_set_thread_name(const char *name);
+#define MKDIR_EXISTS 1
+#define MKDIR_SUCCESS 0
+#define MKDIR_ERROR -1
+char *os_quick_read_utf8_file(const char *path);
+int os_rename(const char *old_path, const char *new_path);
+int os_unlink(const char *path);
+size_t os_utf8_to_wcs_ptr(const char *str, size_t len, wchar_t **pstr);
+#include <sys/stat.h>
+int os_stat(const char *file, struct stat *st);
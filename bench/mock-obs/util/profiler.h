@@ -0,0 +1,8 @@
+#pragma once
+
+// Benchmark mock of the libobs header of the same name: just the subset the plugin uses,
+// implemented by bench/mock-obs.c.
+
+#include "c99defs.h"
+void profile_start(const char *name);
+void profile_end(const char *name);
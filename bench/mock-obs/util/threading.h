@@ -0,0 +1,28 @@
+#pragma once
+
+// Benchmark mock of the libobs header of the same name: just the subset the plugin uses,
+// implemented by bench/mock-obs.c.
+
+#include "c99defs.h"
+#include <pthread.h>
+typedef struct os_event_data os_event_t;
+enum os_event_type { OS_EVENT_TYPE_AUTO, OS_EVENT_TYPE_MANUAL };
+int os_event_init(os_event_t **event, enum os_event_type type);
+void os_event_destroy(os_event_t *event);
+int os_event_wait(os_event_t *event);
+int os_event_timedwait(os_event_t *event, unsigned long milliseconds);
+int os_event_try(os_event_t *event);
+int os_event_signal(os_event_t *event);
+void os_event_reset(os_event_t *event);
+long os_atomic_inc_long(volatile long *val);
+long os_atomic_dec_long(volatile long *val);
+void os_atomic_store_long(volatile long *ptr, long val);
+long os_atomic_set_long(volatile long *ptr, long val);
+long os_atomic_exchange_long(volatile long *ptr, long val);
+long os_atomic_load_long(const volatile long *ptr);
+bool os_atomic_compare_swap_long(volatile long *val, long old_val, long new_val);
+void os_atomic_store_bool(volatile bool *ptr, bool val);
+bool os_atomic_set_bool(volatile bool *ptr, bool val);
+bool os_atomic_exchange_bool(volatile bool *ptr, bool val);
+bool os_atomic_load_bool(const volatile bool *ptr);
+void os_set_thread_name(const char *name);
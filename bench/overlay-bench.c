@@ -0,0 +1,238 @@
+// Overlay benchmark: loads the plugin against the mock libobs (mock-obs.c) and
+// drives a Design Overlay source through create, update, tick and render for
+// every canvas size, layer set and render mode below. For each configuration it
+// prints the CPU time of those entry points and the graphics traffic of one
+// steady-state frame: draws, vertices, uniform uploads, gs_* calls and heap
+// allocations.
+//
+//     overlay-bench [--frames N] [--match <text>] [--verbose]
+
+#include "mock-obs.h"
+
+#include <obs-module.h>
+#include <util/platform.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FRAME_INTERVAL_NS 16666667ULL
+#define FRAME_SECONDS     (1.0f / 60.0f)
+#define WARMUP_FRAMES     3
+#define CREATE_REPEATS    3
+
+// Same values as the plugin's settings lists
+#define RENDER_MODE_DIRECT   0
+#define RENDER_MODE_TEXTURE  1
+#define GRID_ENGINE_GEOMETRY 0
+#define GRID_ENGINE_SHADER   1
+
+struct bench_size {
+    const char *name;
+    uint32_t width;
+    uint32_t height;
+};
+
+struct bench_layers {
+    const char *name;
+    const char *const *enabled;  // show_* keys switched on, NULL keeps the plugin defaults
+    int grid_engine;
+};
+
+struct bench_result {
+    double create_ms;
+    double update_us;
+    double rebuild_us;  // First render after an update
+    double tick_us;
+    double render_us;
+    struct mock_gs_stats frame;  // Per steady-state frame (tick + render)
+};
+
+static const char *const show_keys[] = {
+    "show_material_grid", "show_bootstrap_grid", "show_safe_zones", "show_crosshair", "show_rule_of_thirds",
+    "show_center_guides", "show_branding", "show_color_picker", "show_grid_analyzer", "show_palette",
+    "show_contrast", "show_loupe", "show_reference", "show_scopes", "show_breakpoints", "show_custom_layout",
+    "show_measurements", NULL,
+};
+
+static const char *const safe_zones_only[] = {"show_safe_zones", NULL};
+static const char *const all_grids[] = {
+    "show_material_grid", "show_bootstrap_grid", "show_safe_zones", "show_crosshair", "show_rule_of_thirds",
+    "show_center_guides", "show_branding", "show_measurements", NULL,
+};
+static const char *const grids_and_tools[] = {
+    "show_material_grid", "show_safe_zones", "show_crosshair", "show_branding", "show_measurements",
+    "show_color_picker", "show_grid_analyzer", "show_palette", "show_contrast", "show_loupe", "show_scopes", NULL,
+};
+static const char *const breakpoints[] = {"show_breakpoints", "show_material_grid", "show_safe_zones", NULL};
+
+static const struct bench_size sizes[] = {
+    {"1080p", 1920, 1080},
+    {"1440p", 2560, 1440},
+    {"2160p", 3840, 2160},
+};
+
+static const struct bench_layers layer_sets[] = {
+    {"safe-zones", safe_zones_only, GRID_ENGINE_SHADER},
+    {"defaults", NULL, GRID_ENGINE_SHADER},
+    {"grids-shader", all_grids, GRID_ENGINE_SHADER},
+    {"grids-geometry", all_grids, GRID_ENGINE_GEOMETRY},
+    {"tools", grids_and_tools, GRID_ENGINE_SHADER},
+    {"breakpoints", breakpoints, GRID_ENGINE_GEOMETRY},
+};
+
+static const struct {
+    const char *name;
+    int mode;
+} render_modes[] = {
+    {"direct", RENDER_MODE_DIRECT},
+    {"texture", RENDER_MODE_TEXTURE},
+};
+
+static double elapsed_us(uint64_t start)
+{
+    return (double)(os_gettime_ns() - start) / 1000.0;
+}
+
+static obs_data_t *bench_settings(const struct bench_size *size, const struct bench_layers *layers, int render_mode)
+{
+    obs_data_t *settings = obs_data_create();
+    obs_data_set_int(settings, "canvas_width", size->width);
+    obs_data_set_int(settings, "canvas_height", size->height);
+    obs_data_set_int(settings, "render_mode", render_mode);
+    obs_data_set_int(settings, "grid_engine", layers->grid_engine);
+    
+    if (layers->enabled) {
+        for (const char *const *key = show_keys; *key; key++) obs_data_set_bool(settings, *key, false);
+        for (const char *const *key = layers->enabled; *key; key++) obs_data_set_bool(settings, *key, true);
+    }
+    return settings;
+}
+
+static void run_frame(obs_source_t *source, double *tick_us, double *render_us)
+{
+    mock_obs_begin_frame(FRAME_INTERVAL_NS);
+    
+    uint64_t start = os_gettime_ns();
+    mock_obs_source_tick(source, FRAME_SECONDS);
+    if (tick_us) *tick_us += elapsed_us(start);
+    
+    start = os_gettime_ns();
+    mock_obs_source_render(source);
+    if (render_us) *render_us += elapsed_us(start);
+}
+
+static bool run_config(const struct bench_size *size, const struct bench_layers *layers, int render_mode,
+                       int frames, struct bench_result *result)
+{
+    memset(result, 0, sizeof(*result));
+    mock_obs_set_video(size->width, size->height);
+    obs_data_t *settings = bench_settings(size, layers, render_mode);
+    
+    // Create: settings parsing, first snapshot and GPU resources
+    obs_source_t *source = NULL;
+    for (int i = 0; i < CREATE_REPEATS; i++) {
+        mock_obs_source_destroy(source);
+        const uint64_t start = os_gettime_ns();
+        source = mock_obs_source_create("design_overlay_source", "Design Overlay", settings, NULL);
+        result->create_ms += elapsed_us(start) / 1000.0 / CREATE_REPEATS;
+        if (!source) {
+            obs_data_release(settings);
+            return false;
+        }
+    }
+    
+    for (int i = 0; i < WARMUP_FRAMES; i++) run_frame(source, NULL, NULL);
+    
+    // Steady state: nothing changes between frames
+    mock_gs_stats_reset();
+    for (int i = 0; i < frames; i++) run_frame(source, &result->tick_us, &result->render_us);
+    
+    struct mock_gs_stats steady;
+    mock_gs_stats_get(&steady);
+    result->tick_us /= frames;
+    result->render_us /= frames;
+    result->frame.calls = steady.calls / (uint64_t)frames;
+    result->frame.draws = steady.draws / (uint64_t)frames;
+    result->frame.vertices = steady.vertices / (uint64_t)frames;
+    result->frame.uniforms = steady.uniforms / (uint64_t)frames;
+    result->frame.render_targets = steady.render_targets / (uint64_t)frames;
+    result->frame.resources = steady.resources / (uint64_t)frames;
+    result->frame.allocations = steady.allocations / (uint64_t)frames;
+    
+    // Updates: a property edit per frame, so every render rebuilds
+    obs_data_t *edit = obs_data_create();
+    for (int i = 0; i < frames; i++) {
+        obs_data_set_double(edit, "grid_opacity", i & 1 ? 31.0 : 30.0);
+        
+        const uint64_t start = os_gettime_ns();
+        obs_source_update(source, edit);
+        result->update_us += elapsed_us(start);
+        
+        run_frame(source, NULL, &result->rebuild_us);
+    }
+    result->update_us /= frames;
+    result->rebuild_us /= frames;
+    
+    obs_data_release(edit);
+    mock_obs_source_destroy(source);
+    obs_data_release(settings);
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    int frames = 200;
+    const char *match = NULL;
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--match") == 0 && i + 1 < argc) {
+            match = argv[++i];
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            mock_obs_set_log_level(LOG_DEBUG);
+        } else {
+            fprintf(stderr, "usage: %s [--frames N] [--match <text>] [--verbose]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (frames < 1) frames = 1;
+    
+    if (!obs_module_load() || !mock_obs_find_source_info("design_overlay_source")) {
+        fprintf(stderr, "plugin did not register design_overlay_source\n");
+        return 1;
+    }
+    
+    printf("%d frames per configuration, times are CPU time per call, counts are per steady-state frame\n\n",
+           frames);
+    printf("%-36s %9s %9s %9s %9s %9s %7s %9s %8s %8s %7s\n", "configuration", "create ms", "update us",
+           "rebuild us", "tick us", "render us", "draws", "vertices", "uniforms", "gs calls", "allocs");
+    
+    int failed = 0;
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        for (size_t l = 0; l < sizeof(layer_sets) / sizeof(layer_sets[0]); l++) {
+            for (size_t m = 0; m < sizeof(render_modes) / sizeof(render_modes[0]); m++) {
+                char name[64];
+                snprintf(name, sizeof(name), "%s/%s/%s", sizes[s].name, layer_sets[l].name, render_modes[m].name);
+                if (match && !strstr(name, match)) continue;
+                
+                struct bench_result result;
+                if (!run_config(&sizes[s], &layer_sets[l], render_modes[m].mode, frames, &result)) {
+                    fprintf(stderr, "%s: source creation failed\n", name);
+                    failed++;
+                    continue;
+                }
+                
+                printf("%-36s %9.3f %9.2f %10.2f %9.2f %9.2f %7llu %9llu %8llu %8llu %7llu\n", name,
+                       result.create_ms, result.update_us, result.rebuild_us, result.tick_us, result.render_us,
+                       (unsigned long long)result.frame.draws, (unsigned long long)result.frame.vertices,
+                       (unsigned long long)result.frame.uniforms, (unsigned long long)result.frame.calls,
+                       (unsigned long long)result.frame.allocations);
+            }
+        }
+    }
+    
+    obs_module_unload();
+    return failed ? 1 : 0;
+}
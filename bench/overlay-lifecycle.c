@@ -0,0 +1,159 @@
+// Lifecycle checks against the mock libobs (mock-obs.c): a source or filter is
+// created and rendered, then removed from the scene, and the next frame must
+// give back every texture, render target and buffer it held. Module-wide
+// resources (the shared program frame) are warmed up by a throwaway instance
+// of the same configuration first.
+//
+//     overlay-lifecycle-tests [<case> ...]
+
+#include "mock-obs.h"
+
+#include <obs-module.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define FRAME_INTERVAL_NS 16666667ULL
+#define FRAME_SECONDS     (1.0f / 60.0f)
+#define FRAMES            3
+
+// Same values as the plugin's settings list
+#define RENDER_MODE_TEXTURE 1
+
+struct lifecycle_case {
+    const char *name;
+    bool filter;
+    bool breakpoints;
+    int render_mode;
+};
+
+static const struct lifecycle_case lifecycle_cases[] = {
+    {"hide.source", false, false, 0},
+    {"hide.source_texture", false, false, RENDER_MODE_TEXTURE},
+    {"hide.breakpoints", false, true, 0},
+    {"hide.filter", true, false, 0},
+    {"hide.filter_breakpoints", true, true, 0},
+};
+
+static void run_frames(obs_source_t *source, int frames)
+{
+    for (int i = 0; i < frames; i++) {
+        mock_obs_begin_frame(FRAME_INTERVAL_NS);
+        mock_obs_source_tick(source, FRAME_SECONDS);
+        mock_obs_source_render(source);
+    }
+}
+
+// The parent of the filter cases: an overlay with every layer off
+static obs_source_t *create_parent(void)
+{
+    obs_data_t *settings = obs_data_create();
+    obs_data_set_bool(settings, "enabled", false);
+    obs_source_t *parent = mock_obs_source_create("design_overlay_source", "Parent", settings, NULL);
+    obs_data_release(settings);
+    return parent;
+}
+
+static obs_source_t *create_overlay(const struct lifecycle_case *lc, obs_source_t *parent)
+{
+    obs_data_t *settings = obs_data_create();
+    obs_data_set_int(settings, "render_mode", lc->render_mode);
+    obs_data_set_bool(settings, "show_breakpoints", lc->breakpoints);
+    obs_source_t *source = lc->filter
+        ? mock_obs_source_create("design_overlay_filter", "Overlay", settings, parent)
+        : mock_obs_source_create("design_overlay_source", "Overlay", settings, NULL);
+    obs_data_release(settings);
+    return source;
+}
+
+static bool run_case(const struct lifecycle_case *lc)
+{
+    obs_source_t *parent = lc->filter ? create_parent() : NULL;
+    if (lc->filter && !parent) {
+        fprintf(stderr, "%s: parent creation failed\n", lc->name);
+        return false;
+    }
+    if (parent) run_frames(parent, FRAMES);
+    
+    obs_source_t *warmup = create_overlay(lc, parent);
+    run_frames(warmup, FRAMES);
+    mock_obs_source_destroy(warmup);
+    const long baseline = mock_gs_live_resources();
+    
+    obs_source_t *source = create_overlay(lc, parent);
+    if (!source) {
+        fprintf(stderr, "%s: source creation failed\n", lc->name);
+        mock_obs_source_destroy(parent);
+        return false;
+    }
+    
+    run_frames(source, FRAMES);
+    const long shown = mock_gs_live_resources();
+    
+    // Out of the scene: only the tick and the main render callbacks run
+    mock_obs_source_set_visible(source, false);
+    mock_obs_begin_frame(FRAME_INTERVAL_NS);
+    mock_obs_source_tick(source, FRAME_SECONDS);
+    const long hidden = mock_gs_live_resources();
+    
+    bool ok = true;
+    if (shown <= baseline) {
+        fprintf(stderr, "%s: rendering created no resources, nothing to check\n", lc->name);
+        ok = false;
+    } else if (hidden != baseline) {
+        fprintf(stderr, "%s: %ld resources still held after hiding (%ld while shown)\n", lc->name,
+                hidden - baseline, shown - baseline);
+        ok = false;
+    }
+    
+    // Showing again must rebuild what was released
+    mock_obs_source_set_visible(source, true);
+    run_frames(source, FRAMES);
+    if (ok && mock_gs_live_resources() != shown) {
+        fprintf(stderr, "%s: %ld resources after showing again, %ld before hiding\n", lc->name,
+                mock_gs_live_resources() - baseline, shown - baseline);
+        ok = false;
+    }
+    
+    printf("%-32s %s\n", lc->name, ok ? "ok" : "FAILED");
+    
+    mock_obs_source_destroy(source);
+    mock_obs_source_destroy(parent);
+    return ok;
+}
+
+static bool selected(const char *name, int argc, char **argv)
+{
+    if (argc < 2) return true;
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], name) == 0) return true;
+    }
+    return false;
+}
+
+int main(int argc, char **argv)
+{
+    if (!obs_module_load() || !mock_obs_find_source_info("design_overlay_filter")) {
+        fprintf(stderr, "plugin did not register its sources\n");
+        return 1;
+    }
+    
+    int run = 0;
+    int failed = 0;
+    for (size_t c = 0; c < sizeof(lifecycle_cases) / sizeof(lifecycle_cases[0]); c++) {
+        if (!selected(lifecycle_cases[c].name, argc, argv)) continue;
+        
+        run++;
+        if (!run_case(&lifecycle_cases[c])) failed++;
+    }
+    
+    obs_module_unload();
+    
+    if (!run) {
+        fprintf(stderr, "no matching cases\n");
+        return 2;
+    }
+    printf("%d of %d cases passed\n", run - failed, run);
+    return failed ? 1 : 0;
+}
@@ -1,7 +1,25 @@
 #include <obs-module.h>
 #include <graphics/graphics.h>
 #include <util/bmem.h>
+#include <util/platform.h>
+#include <util/profiler.h>
+#include <util/threading.h>
+#include <util/dstr.h>
 #include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "overlay-analyzer.h"
+#include "overlay-palette.h"
+#include "overlay-reference.h"
+#include "overlay-atomic.h"
+#include "overlay-cache.h"
+#include "overlay-capture.h"
+#include "overlay-export.h"
+#include "overlay-geometry.h"
+#include "overlay-layout-file.h"
+#include "overlay-shm.h"
+#include "overlay-text.h"
 
 OBS_DECLARE_MODULE()
 OBS_MODULE_USE_DEFAULT_LOCALE("design-overlay", "en-US")
@@ -9,16 +27,178 @@ OBS_MODULE_USE_DEFAULT_LOCALE("design-overlay", "en-US")
 #define PLUGIN_VERSION "1.0.0"
 #define PLUGIN_NAME "Design Overlay"
 
-// Professional color constants
-#define COLOR_GRID_BLUE       0xFF0096FF  // Material Design Blue
-#define COLOR_BOOTSTRAP_PINK  0xFFFF0096  // Bootstrap Pink
-#define COLOR_SAFE_ORANGE     0xFFFF6B35  // Safe Zone Orange
-#define COLOR_SAFE_GREEN      0xFF4CAF50  // Desktop Safe Green
-#define COLOR_CROSSHAIR_YELLOW 0xFFFFFF00 // Bright Yellow
-#define COLOR_BRAND_BLUE      0xFF00D4FF  // Brand Blue
+// Render modes
+#define RENDER_MODE_DIRECT    0  // Draw cached vertex buffer every frame
+#define RENDER_MODE_TEXTURE   1  // Draw into a texture on change, blit it every frame
 
-struct design_overlay_data {
-    obs_source_t *source;
+// Grid engines
+#define GRID_ENGINE_GEOMETRY  0  // One line primitive per grid step
+#define GRID_ENGINE_SHADER    1  // Procedural grid in design-overlay.effect
+
+// WCAG contrast levels
+#define CONTRAST_LEVEL_AA     0  // 4.5:1 for body text
+#define CONTRAST_LEVEL_AAA    1  // 7:1 for body text
+
+#define CONTRAST_OPACITY      0.45f
+
+// Reference mockup blend modes
+#define REFERENCE_MODE_ONION       0  // Mockup drawn over the canvas
+#define REFERENCE_MODE_DIFFERENCE  1  // |canvas - mockup|
+
+// Mismatch scoring starts at the tile grid times 2^passes and halves once per pass
+#define REFERENCE_TILES_X          16
+#define REFERENCE_TILES_Y          9
+#define REFERENCE_REDUCE_PASSES    6
+#define REFERENCE_TILE_THRESHOLD   0.02f  // Mean channel difference worth highlighting
+
+// The canvas copy re-renders the program scene, so it is refreshed at 10 Hz
+#define CANVAS_COPY_REFRESH_NS     100000000ULL
+
+// Scopes. The canvas is downscaled to one sample grid on the GPU; the samples
+// become point colors and are scattered into small float targets by the
+// WaveformScatter and VectorscopeScatter techniques.
+#define SCOPE_WAVEFORM             1
+#define SCOPE_VECTORSCOPE          2
+#define SCOPE_BOTH                 (SCOPE_WAVEFORM | SCOPE_VECTORSCOPE)
+
+#define SCOPE_SAMPLES_X            256   // Also the waveform width: one column per sample column
+#define SCOPE_SAMPLES_Y            144
+#define SCOPE_WAVEFORM_LEVELS      256
+#define SCOPE_VECTOR_SIZE          256
+#define SCOPE_CHROMA_SCALE         0.9f  // Full Cb/Cr swing (+-0.5) reaches 45% of the vectorscope
+#define SCOPE_WAVEFORM_GAIN        0.25f // Trace brightness per hit: 1 - exp(-hits * gain)
+#define SCOPE_VECTOR_GAIN          0.05f
+#define SCOPE_PANEL_SIZE           192.0f  // Panel height in canvas pixels at 1080p
+#define SCOPE_REFRESH_NS           CANVAS_COPY_REFRESH_NS
+
+// Loupe nudges, one canvas pixel per hotkey press
+#define LOUPE_MOVE_COUNT 4
+
+static const struct {
+    const char *name;
+    const char *description;
+    int dx;
+    int dy;
+} loupe_moves[LOUPE_MOVE_COUNT] = {
+    {"design_overlay.loupe_left", "Move Loupe Left", -1, 0},
+    {"design_overlay.loupe_right", "Move Loupe Right", 1, 0},
+    {"design_overlay.loupe_up", "Move Loupe Up", 0, -1},
+    {"design_overlay.loupe_down", "Move Loupe Down", 0, 1},
+};
+
+// Layer visibility hotkeys, in enum overlay_layer order
+static const struct {
+    const char *name;
+    const char *description;
+} layer_hotkey_names[OVERLAY_LAYER_COUNT] = {
+    {"design_overlay.toggle_center_guides", "Toggle Center Guides"},
+    {"design_overlay.toggle_rule_of_thirds", "Toggle Rule of Thirds"},
+    {"design_overlay.toggle_material_grid", "Toggle Material Grid"},
+    {"design_overlay.toggle_bootstrap_grid", "Toggle Bootstrap Grid"},
+    {"design_overlay.toggle_safe_zones", "Toggle Safe Zones"},
+    {"design_overlay.toggle_custom_layout", "Toggle Custom Layout"},
+    {"design_overlay.toggle_crosshair", "Toggle Crosshair"},
+    {"design_overlay.toggle_branding", "Toggle Branding"},
+};
+
+// Responsive preview viewports, tiled left to right, each with its own grid
+#define BREAKPOINT_COUNT 3
+
+static const struct {
+    uint32_t width;   // Viewport in CSS pixels
+    uint32_t height;
+    int columns;
+    float gutter;
+} breakpoints[BREAKPOINT_COUNT] = {
+    {390, 844, 4, 16.0f},    // Mobile
+    {820, 1180, 8, 24.0f},   // Tablet
+    {1440, 900, 12, 24.0f},  // Desktop
+};
+
+// One viewport of the responsive preview, placed on the overlay canvas
+struct breakpoint_tile {
+    struct overlay_params params;  // Viewport-sized; the geometry is shared like any other instance's
+    float x;
+    float y;
+    float scale;                   // Canvas pixels per viewport pixel
+};
+
+// Material grid level of detail of one geometry: renders record the level they
+// need, the tick settles on the finest one and rebuilds
+struct grid_lod_state {
+    int lod;            // Level the geometry is built for
+    bool halfway;       // The geometry also draws the faded halfway lines
+    int seen;           // Finest level any render needed since the last tick, 0 = none
+    bool halfway_seen;  // Some render at that level had room for the halfway lines
+};
+
+// Shared procedural effect, loaded once per module
+static gs_effect_t *overlay_effect = NULL;
+
+// Label font, baked once per module
+static gs_texture_t *glyph_atlas = NULL;
+
+// Immediate-mode draws are split to stay below the libobs immediate vertex limit.
+// One label (OVERLAY_LABEL_MAX characters, two quads each) always fits one draw.
+#define IMMEDIATE_LINES_PER_DRAW 256
+
+// Rolling render-time window for percentiles
+#define STATS_WINDOW 600
+
+static const char *layer_names[OVERLAY_LAYER_COUNT] = {
+    "Center guides",
+    "Rule of thirds",
+    "Material grid",
+    "Bootstrap grid",
+    "Safe zones",
+    "Custom layout",
+    "Crosshair",
+    "Branding",
+};
+
+// Profiler scope names must stay valid for the process lifetime
+static const char *layer_profile_names[OVERLAY_LAYER_COUNT] = {
+    "render_center_guides",
+    "render_rule_of_thirds",
+    "render_material_grid",
+    "render_bootstrap_grid",
+    "render_safe_zones",
+    "render_custom_layout",
+    "render_crosshair",
+    "render_branding",
+};
+
+// Accumulated render cost, reported on destroy
+struct render_cost {
+    uint64_t renders;
+    uint64_t render_ns;
+    uint64_t draw_calls;
+    uint64_t vertices;
+    uint64_t uniform_uploads;
+};
+
+// Rolling statistics, written on the graphics thread and read by the properties panel
+struct render_stats {
+    pthread_mutex_t mutex;
+    uint64_t frame_ns[STATS_WINDOW];
+    size_t next;
+    size_t count;
+    
+    // Last render
+    uint64_t draw_calls;
+    uint64_t vertices;
+    uint64_t uniform_uploads;
+    
+    // Last geometry build
+    uint32_t layer_vertices[OVERLAY_LAYER_COUNT];
+    uint64_t layer_build_ns[OVERLAY_LAYER_COUNT];
+};
+
+// Immutable settings snapshot. design_overlay_update builds a new one and
+// publishes it with an atomic pointer swap; the graphics thread picks up the
+// latest snapshot once per frame and frees replaced ones after that.
+struct overlay_settings {
+    struct overlay_settings *retired_next;
     
     // Enable/disable flags
     bool enabled;
@@ -29,6 +209,16 @@ struct design_overlay_data {
     bool show_rule_of_thirds;
     bool show_center_guides;
     bool show_branding;
+    bool show_color_picker;
+    bool show_grid_analyzer;
+    bool show_palette;
+    bool show_contrast;
+    bool show_loupe;
+    bool show_reference;
+    bool show_scopes;
+    bool show_breakpoints;
+    bool show_custom_layout;
+    bool show_measurements;
     
     // Appearance settings
     float grid_opacity;
@@ -37,6 +227,7 @@ struct design_overlay_data {
     uint32_t grid_color;
     uint32_t safe_zone_color;
     uint32_t crosshair_color;
+    float line_width;            // Screen pixels, 0 = hairlines
     
     // Configuration
     uint32_t canvas_width;
@@ -46,10 +237,178 @@ struct design_overlay_data {
     float bootstrap_gutter;
     int safe_zone_type;
     float custom_safe_zone_percent;
+    int render_mode;
+    int grid_engine;
+    
+    // Color picker (canvas pixels)
+    int picker_x;
+    int picker_y;
+    int picker_size;
+    
+    // Grid analyzer
+    int analyzer_scale;          // Canvas pixels per analysis pixel
+    int analyzer_interval_ms;
+    int analyzer_threshold;
+    
+    // Palette extraction
+    int palette_colors;
+    int palette_interval_ms;
+    
+    // Contrast heatmap
+    int contrast_level;
+    int contrast_radius;         // Canvas pixels between a pixel and its neighbors
+    
+    // Scopes
+    int scope_type;              // SCOPE_WAVEFORM | SCOPE_VECTORSCOPE
     
-    // Runtime state
+    // Loupe (canvas pixels; the position lives on the context so hotkeys can move it)
+    int loupe_size;              // Canvas pixels across the sampled region
+    int loupe_zoom;              // Screen pixels per canvas pixel
+    
+    // Reference mockup
+    int reference_mode;
+    float reference_opacity;
+    
+    // Export folder, empty = module config dir
+    char *export_path;
+    
+    // Compiled layout file, NULL when disabled or unreadable (referenced)
+    struct layout_file *custom_layout;
+    
+    // Decoded mockup, NULL when disabled or unreadable (referenced)
+    struct reference_image *reference;
+    
+    // Derived once per snapshot
+    struct overlay_params params;
+    struct overlay_layout layout;
+    uint32_t layer_mask;   // Layers enabled in the properties
+    uint32_t build_mask;   // Layers compiled into the geometry, shown or not
+    struct breakpoint_tile tiles[BREAKPOINT_COUNT];  // Only with show_breakpoints
+};
+
+struct design_overlay_data {
+    obs_source_t *source;
+    bool is_filter;  // Composited onto the parent, canvas follows the parent size
+    
+    // Settings snapshots
+    struct overlay_settings *volatile latest;   // Last published snapshot
+    struct overlay_settings *volatile retired;  // Replaced snapshots, freed by the graphics thread
+    const struct overlay_settings *cfg;         // Snapshot of the current frame (graphics thread only)
+    volatile long width;                        // Canvas of the latest snapshot, for get_width/height
+    volatile long height;
+    volatile long filter_width;                 // Parent size last seen by the filter tick
+    volatile long filter_height;
+    
+    // Runtime state (graphics thread only)
     bool needs_redraw;
-    uint64_t last_render_time;
+    float output_ratio;  // Output pixels per base canvas pixel
+    struct grid_lod_state grid_lod;  // Of the geometry grid
+    uint32_t layers;     // Layers drawn this frame: the settings with the hotkey toggles applied
+    
+    // Lifecycle, set by the show/hide and activate/deactivate callbacks
+    volatile bool showing;  // Drawn somewhere: preview, program or a projector
+    volatile bool active;   // Part of the program output
+    
+    // Geometry and texture cache, shared with matching instances (graphics thread
+    // only, except the counters, which the properties dialog reads)
+    struct shared_geometry *geometry;
+    struct shared_geometry *breakpoint_geometry[BREAKPOINT_COUNT];  // Responsive preview tiles
+    struct grid_lod_state breakpoint_lod[BREAKPOINT_COUNT];
+    volatile long cache_hits;
+    volatile long cache_rebuilds;
+    
+    // Color picker sampling (graphics thread only, except picked_color and pick_requested).
+    // The program is only captured when the sampled region moves or a pick is requested.
+    gs_texture_t *picker_texture;  // Sampled region, copied from the shared program frame
+    struct readback_ring picker_ring;
+    struct overlay_prim_list picker_prims;
+    volatile long picked_color;  // 0x00RRGGBB, -1 until the first sample arrives
+    obs_hotkey_id picker_hotkey;
+    volatile bool pick_requested;  // Hotkey or button: sample the same region again
+    bool picker_sampled;           // picker_region holds the last sampled region
+    int picker_region[4];          // Program pixels: x, y, width, height
+    
+    // Grid analyzer (graphics thread only, analysis runs on the analyzer worker)
+    struct overlay_analyzer *analyzer;
+    gs_texrender_t *analyzer_texrender;
+    struct readback_ring analyzer_ring;
+    struct analyzer_config analyzer_config;  // Config of the frames in analyzer_ring
+    uint64_t analyzer_last_ns;
+    struct analyzer_result analyzer_results[ANALYZER_MAX_RESULTS];
+    size_t analyzer_result_count;
+    struct overlay_prim_list analyzer_prims;
+    
+    // Palette extraction (graphics thread only, clustering runs on the palette worker)
+    struct overlay_palette *palette;
+    gs_texrender_t *palette_texrender;
+    struct readback_ring palette_ring;
+    int palette_colors;  // Cluster count of the frames in palette_ring
+    uint64_t palette_last_ns;
+    struct palette_swatch swatches[PALETTE_MAX_COLORS];
+    size_t swatch_count;
+    struct overlay_prim_list palette_prims;
+    
+    // Program canvas at overlay canvas size for the contrast and reference
+    // layers; sampled by their techniques, never read back
+    gs_texrender_t *canvas_texrender;
+    uint64_t canvas_copy_ns;
+    bool canvas_copy_ready;
+    
+    // Reference mismatch: only the reduced tile grid is read back
+    gs_texrender_t *reference_reduce[REFERENCE_REDUCE_PASSES + 1];
+    struct readback_ring reference_ring;
+    float reference_tiles[REFERENCE_TILES_X * REFERENCE_TILES_Y];  // Mean channel difference, 0-1
+    bool reference_scored;
+    volatile long reference_mismatch;  // Canvas average in 0.01 %, -1 until scored
+    struct overlay_prim_list reference_prims;
+    
+    // Layout and sampled colors for external tools. Only opened while publish_layout
+    // is on; NULL otherwise or if the region could not be created.
+    struct overlay_shm *shm;
+    pthread_mutex_t publish_mutex;  // Guards shm, and keeps the snapshot a layout write reads alive
+    
+    // Responsive preview content: the filter's parent, rendered once per frame for all tiles
+    gs_texrender_t *parent_texrender;
+    struct overlay_prim_list breakpoint_prims;
+    
+    // Scopes: only the sample grid is read back, accumulation stays on the GPU
+    gs_texrender_t *scope_texrender;
+    struct readback_ring scope_ring;
+    gs_vertbuffer_t *scope_points;  // One point per sample, colors replaced by each readback
+    bool scope_points_dirty;
+    uint64_t scope_last_ns;
+    gs_texrender_t *waveform_texrender;
+    gs_texrender_t *vectorscope_texrender;
+    bool scopes_ready;
+    struct overlay_prim_list scope_prims;
+    
+    // Layer hotkeys flip bits of layer_toggles; the geometry holds every layer, so nothing is rebuilt
+    obs_hotkey_id layer_hotkeys[OVERLAY_LAYER_COUNT];
+    volatile long layer_toggles;
+    
+    // Loupe: region copy drawn enlarged by the Loupe technique, never read back
+    obs_hotkey_id loupe_hotkeys[LOUPE_MOVE_COUNT];
+    volatile long loupe_x;        // Canvas pixels, set by updates and moved by the hotkeys
+    volatile long loupe_y;
+    gs_texture_t *loupe_texture;  // Program pixels under the loupe, cropped from the shared frame
+    bool loupe_ready;
+    struct overlay_prim_list loupe_prims;
+    
+    // Screenshot export (requested from any thread, captured on the graphics thread)
+    obs_hotkey_id export_hotkey;
+    volatile bool export_requested;
+    struct overlay_exporter *exporter;
+    gs_texrender_t *export_texrender;
+    struct readback_ring export_ring;
+    struct export_request export_request;  // Request of the frame in export_ring
+    char *export_directory;                // Owned by export_request
+    struct layout_file *export_layout;     // Keeps export_request's custom lines alive
+    bool export_waiting;
+    int export_wait_frames;
+    
+    // Cost accounting (graphics thread only)
+    struct render_cost cost;
+    struct render_stats stats;
 };
 
 // Forward declarations
@@ -63,289 +422,371 @@ static uint32_t design_overlay_get_width(void *data);
 static uint32_t design_overlay_get_height(void *data);
 static void design_overlay_video_render(void *data, gs_effect_t *effect);
 static void design_overlay_video_tick(void *data, float seconds);
+static void design_overlay_show(void *data);
+static void design_overlay_hide(void *data);
+static void design_overlay_activate(void *data);
+static void design_overlay_deactivate(void *data);
+static void design_overlay_main_render(void *data, uint32_t cx, uint32_t cy);
+static void export_hotkey_pressed(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed);
+static void loupe_hotkey_pressed(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed);
+static void layer_hotkey_pressed(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed);
+static bool export_button_clicked(obs_properties_t *props, obs_property_t *property, void *data);
+static void picker_hotkey_pressed(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed);
+static bool pick_button_clicked(obs_properties_t *props, obs_property_t *property, void *data);
+static bool reload_layout_clicked(obs_properties_t *props, obs_property_t *property, void *data);
+static void *design_overlay_filter_create(obs_data_t *settings, obs_source_t *source);
+static obs_properties_t *design_overlay_filter_get_properties(void *data);
+static void design_overlay_filter_render(void *data, gs_effect_t *effect);
+static void design_overlay_filter_tick(void *data, float seconds);
 
 // ============================================================================
 // Utility functions
 // ============================================================================
 
-static void set_shader_color(gs_eparam_t *color_param, uint32_t color, float opacity)
+static uint32_t to_vertex_color(uint32_t color, float opacity)
 {
-    if (!color_param) return;
-    
+    // Constants are 0xAARRGGBB, vertex colors are packed RGBA (0xAABBGGRR)
     float a = ((color >> 24) & 0xFF) / 255.0f;
-    float r = ((color >> 16) & 0xFF) / 255.0f;
-    float g = ((color >> 8) & 0xFF) / 255.0f;
-    float b = (color & 0xFF) / 255.0f;
+    const uint32_t r = (color >> 16) & 0xFF;
+    const uint32_t g = (color >> 8) & 0xFF;
+    const uint32_t b = color & 0xFF;
     
     a *= opacity;
     a = fmaxf(0.0f, fminf(1.0f, a));
     
-    struct vec4 color_vec = {r, g, b, a};
-    gs_effect_set_vec4(color_param, &color_vec);
+    const uint32_t alpha = (uint32_t)(a * 255.0f + 0.5f);
+    return (alpha << 24) | (b << 16) | (g << 8) | r;
 }
 
-static void draw_simple_line(float x1, float y1, float x2, float y2,
-                            uint32_t color, float opacity,
-                            gs_effect_t *effect, gs_eparam_t *color_param)
+static void color_to_vec4(struct vec4 *dst, uint32_t color, float opacity)
 {
-    if (!effect || !color_param) return;
-    
-    set_shader_color(color_param, color, opacity);
+    float a = ((color >> 24) & 0xFF) / 255.0f;
+    a *= opacity;
+    a = fmaxf(0.0f, fminf(1.0f, a));
     
-    gs_render_start(true);
-    gs_vertex2f(x1, y1);
-    gs_vertex2f(x2, y2);
-    gs_render_stop(GS_LINES);
+    vec4_set(dst, ((color >> 16) & 0xFF) / 255.0f, ((color >> 8) & 0xFF) / 255.0f,
+             (color & 0xFF) / 255.0f, a);
 }
 
-// ============================================================================
-// Rendering functions
-// ============================================================================
+static inline void count_draw(struct design_overlay_data *ctx, uint32_t vertices)
+{
+    ctx->cost.draw_calls++;
+    ctx->cost.vertices += vertices;
+}
+
+static inline void count_uniform(struct design_overlay_data *ctx)
+{
+    ctx->cost.uniform_uploads++;
+}
+
+static void log_render_cost(const struct design_overlay_data *ctx)
+{
+    const struct render_cost *cost = &ctx->cost;
+    if (!cost->renders) return;
+    
+    const double renders = (double)cost->renders;
+    blog(LOG_INFO, "[Design Overlay] Render cost over %llu renders: %.1f us, %.1f draw calls, "
+         "%.0f vertices, %.1f uniform uploads per render",
+         (unsigned long long)cost->renders, (double)cost->render_ns / renders / 1000.0,
+         (double)cost->draw_calls / renders, (double)cost->vertices / renders,
+         (double)cost->uniform_uploads / renders);
+}
 
-static void render_material_grid(struct design_overlay_data *ctx, gs_effect_t *effect, gs_eparam_t *color_param)
+static void stats_record_render(struct design_overlay_data *ctx, uint64_t render_ns,
+                                const struct render_cost *before)
 {
-    const int size = ctx->material_grid_size;
-    if (size <= 0) return;
+    struct render_stats *stats = &ctx->stats;
     
-    const uint32_t color = ctx->grid_color;
-    const float opacity = ctx->grid_opacity;
+    pthread_mutex_lock(&stats->mutex);
+    stats->frame_ns[stats->next] = render_ns;
+    stats->next = (stats->next + 1) % STATS_WINDOW;
+    if (stats->count < STATS_WINDOW) stats->count++;
     
-    // Vertical lines
-    for (int x = 0; x <= (int)ctx->canvas_width; x += size) {
-        draw_simple_line((float)x, 0.0f, (float)x, (float)ctx->canvas_height,
-                        color, opacity, effect, color_param);
+    stats->draw_calls = ctx->cost.draw_calls - before->draw_calls;
+    stats->vertices = ctx->cost.vertices - before->vertices;
+    stats->uniform_uploads = ctx->cost.uniform_uploads - before->uniform_uploads;
+    pthread_mutex_unlock(&stats->mutex);
+}
+
+static int compare_u64(const void *a, const void *b)
+{
+    const uint64_t va = *(const uint64_t *)a;
+    const uint64_t vb = *(const uint64_t *)b;
+    return (va > vb) - (va < vb);
+}
+
+// Appends the statistics summary, one line per entry, to out
+static void stats_format(struct design_overlay_data *ctx, struct dstr *out)
+{
+    struct render_stats *stats = &ctx->stats;
+    uint64_t sorted[STATS_WINDOW];
+    
+    pthread_mutex_lock(&stats->mutex);
+    const size_t count = stats->count;
+    memcpy(sorted, stats->frame_ns, sizeof(uint64_t) * count);
+    const uint64_t draw_calls = stats->draw_calls;
+    const uint64_t vertices = stats->vertices;
+    const uint64_t uniform_uploads = stats->uniform_uploads;
+    uint32_t layer_vertices[OVERLAY_LAYER_COUNT];
+    uint64_t layer_build_ns[OVERLAY_LAYER_COUNT];
+    memcpy(layer_vertices, stats->layer_vertices, sizeof(layer_vertices));
+    memcpy(layer_build_ns, stats->layer_build_ns, sizeof(layer_build_ns));
+    pthread_mutex_unlock(&stats->mutex);
+    
+    if (!count) {
+        dstr_cat(out, "No renders yet\n");
+        return;
     }
     
-    // Horizontal lines
-    for (int y = 0; y <= (int)ctx->canvas_height; y += size) {
-        draw_simple_line(0.0f, (float)y, (float)ctx->canvas_width, (float)y,
-                        color, opacity, effect, color_param);
+    qsort(sorted, count, sizeof(uint64_t), compare_u64);
+    dstr_catf(out, "Render time: p50 %.1f us, p95 %.1f us, p99 %.1f us (%zu renders)\n",
+              sorted[count / 2] / 1000.0, sorted[count * 95 / 100] / 1000.0,
+              sorted[count * 99 / 100] / 1000.0, count);
+    dstr_catf(out, "Per render: %llu draw calls, %llu vertices, %llu uniform uploads\n",
+              (unsigned long long)draw_calls, (unsigned long long)vertices,
+              (unsigned long long)uniform_uploads);
+    
+    for (int layer = 0; layer < OVERLAY_LAYER_COUNT; layer++) {
+        if (!layer_vertices[layer]) continue;
+        dstr_catf(out, "%s: %u vertices, built in %.1f us\n", layer_names[layer],
+                  layer_vertices[layer], layer_build_ns[layer] / 1000.0);
     }
 }
 
-static void render_bootstrap_grid(struct design_overlay_data *ctx, gs_effect_t *effect, gs_eparam_t *color_param)
+static bool grid_shader_active(const struct design_overlay_data *ctx)
 {
-    const int cols = ctx->bootstrap_columns;
-    const float gutter = ctx->bootstrap_gutter;
-    
-    if (cols <= 0) return;
-    
-    // Bootstrap container calculation (exact 90% width, centered)
-    const float container_w = floorf((float)ctx->canvas_width * 0.9f);
-    const float col_w = floorf((container_w - ((cols - 1) * gutter)) / cols);
-    const float start_x = floorf(((float)ctx->canvas_width - container_w) / 2.0f);
-    
-    const uint32_t color = COLOR_BOOTSTRAP_PINK;
-    const float opacity = ctx->grid_opacity;
-    
-    // Container boundaries (outer lines)
-    draw_simple_line(start_x, 0.0f, start_x, (float)ctx->canvas_height,
-                    color, opacity * 0.5f, effect, color_param);
-    draw_simple_line(start_x + container_w, 0.0f, start_x + container_w, (float)ctx->canvas_height,
-                    color, opacity * 0.5f, effect, color_param);
-    
-    // Column dividers
-    for (int i = 1; i < cols; i++) {
-        float x = start_x + (i * (col_w + gutter));
-        draw_simple_line(x, 0.0f, x, (float)ctx->canvas_height,
-                        color, opacity, effect, color_param);
+    return ctx->cfg->grid_engine == GRID_ENGINE_SHADER && overlay_effect != NULL;
+}
+
+static bool line_quads_active(const struct design_overlay_data *ctx)
+{
+    return ctx->cfg->line_width > 0.0f && overlay_effect != NULL &&
+           gs_effect_get_technique(overlay_effect, "Lines") != NULL;
+}
+
+static void get_overlay_params_sized(const struct overlay_settings *s, uint32_t width, uint32_t height,
+                                     struct overlay_params *params)
+{
+    params->canvas_width = width;
+    params->canvas_height = height;
+    params->material_grid_size = s->material_grid_size;
+    params->bootstrap_columns = s->bootstrap_columns;
+    params->bootstrap_gutter = s->bootstrap_gutter;
+    params->safe_zone_type = s->safe_zone_type;
+    params->custom_safe_zone_percent = s->custom_safe_zone_percent;
+    params->grid_opacity = s->grid_opacity;
+    params->safe_zone_opacity = s->safe_zone_opacity;
+    params->crosshair_opacity = s->crosshair_opacity;
+    params->grid_color = s->grid_color;
+    params->safe_zone_color = s->safe_zone_color;
+    params->measurement_labels = s->show_measurements;
+    
+    params->custom_layout_id = 0;
+    params->custom_lines = NULL;
+    params->custom_line_count = 0;
+    params->custom_scale_x = 1.0f;
+    params->custom_scale_y = 1.0f;
+    
+    if (s->custom_layout) {
+        // Breakpoints follow the canvas width, coordinates scale from the reference canvas
+        uint32_t ref_w, ref_h;
+        layout_file_reference_size(s->custom_layout, &ref_w, &ref_h);
+        params->custom_layout_id = layout_file_id(s->custom_layout);
+        params->custom_lines = layout_file_lines(s->custom_layout, width, &params->custom_line_count);
+        params->custom_scale_x = (float)width / (float)ref_w;
+        params->custom_scale_y = (float)height / (float)ref_h;
     }
 }
 
-static void render_safe_zones(struct design_overlay_data *ctx, gs_effect_t *effect, gs_eparam_t *color_param)
+static void get_overlay_params(const struct overlay_settings *s, struct overlay_params *params)
 {
-    float percent;
-    uint32_t color;
-    
-    switch (ctx->safe_zone_type) {
-        case 0: // Mobile
-            percent = 0.8f;
-            color = COLOR_SAFE_ORANGE;
-            break;
-        case 1: // Desktop
-            percent = 0.9f;
-            color = COLOR_SAFE_GREEN;
-            break;
-        case 2: // Broadcast SMPTE
-            percent = 0.93f;
-            color = COLOR_SAFE_ORANGE;
-            break;
-        case 3: // Custom
-            percent = ctx->custom_safe_zone_percent;
-            color = ctx->safe_zone_color;
-            break;
-        default:
-            percent = 0.9f;
-            color = COLOR_SAFE_GREEN;
+    get_overlay_params_sized(s, s->canvas_width, s->canvas_height, params);
+}
+
+// Viewports side by side at one common scale, centered, with room above for their labels
+static void get_breakpoint_tiles(const struct overlay_settings *s, struct breakpoint_tile *tiles)
+{
+    const float canvas_w = (float)s->canvas_width;
+    const float canvas_h = (float)s->canvas_height;
+    const float gap = floorf(canvas_w * 0.02f);
+    
+    float total_w = 0.0f;
+    float max_h = 0.0f;
+    for (int i = 0; i < BREAKPOINT_COUNT; i++) {
+        total_w += (float)breakpoints[i].width;
+        max_h = fmaxf(max_h, (float)breakpoints[i].height);
     }
     
-    percent = fmaxf(0.1f, fminf(0.99f, percent));
-    
-    const float safe_w = floorf((float)ctx->canvas_width * percent);
-    const float safe_h = floorf((float)ctx->canvas_height * percent);
-    const float margin_x = floorf(((float)ctx->canvas_width - safe_w) / 2.0f);
-    const float margin_y = floorf(((float)ctx->canvas_height - safe_h) / 2.0f);
-    const float opacity = ctx->safe_zone_opacity;
-    
-    // Main safe zone rectangle
-    // Top
-    draw_simple_line(margin_x, margin_y, margin_x + safe_w, margin_y,
-                    color, opacity, effect, color_param);
-    // Right
-    draw_simple_line(margin_x + safe_w, margin_y, margin_x + safe_w, margin_y + safe_h,
-                    color, opacity, effect, color_param);
-    // Bottom
-    draw_simple_line(margin_x + safe_w, margin_y + safe_h, margin_x, margin_y + safe_h,
-                    color, opacity, effect, color_param);
-    // Left
-    draw_simple_line(margin_x, margin_y + safe_h, margin_x, margin_y,
-                    color, opacity, effect, color_param);
-    
-    // Corner markers for professional look
-    const float marker_size = 20.0f;
-    
-    // Top-left
-    draw_simple_line(margin_x - marker_size, margin_y, margin_x + marker_size, margin_y,
-                    color, opacity, effect, color_param);
-    draw_simple_line(margin_x, margin_y - marker_size, margin_x, margin_y + marker_size,
-                    color, opacity, effect, color_param);
-    
-    // Top-right
-    draw_simple_line(margin_x + safe_w - marker_size, margin_y, margin_x + safe_w + marker_size, margin_y,
-                    color, opacity, effect, color_param);
-    draw_simple_line(margin_x + safe_w, margin_y - marker_size, margin_x + safe_w, margin_y + marker_size,
-                    color, opacity, effect, color_param);
-    
-    // Bottom-right
-    draw_simple_line(margin_x + safe_w - marker_size, margin_y + safe_h, margin_x + safe_w + marker_size, margin_y + safe_h,
-                    color, opacity, effect, color_param);
-    draw_simple_line(margin_x + safe_w, margin_y + safe_h - marker_size, margin_x + safe_w, margin_y + safe_h + marker_size,
-                    color, opacity, effect, color_param);
-    
-    // Bottom-left
-    draw_simple_line(margin_x - marker_size, margin_y + safe_h, margin_x + marker_size, margin_y + safe_h,
-                    color, opacity, effect, color_param);
-    draw_simple_line(margin_x, margin_y + safe_h - marker_size, margin_x, margin_y + safe_h + marker_size,
-                    color, opacity, effect, color_param);
-}
-
-static void render_rule_of_thirds(struct design_overlay_data *ctx, gs_effect_t *effect, gs_eparam_t *color_param)
+    const float scale = fminf((canvas_w * 0.94f - gap * (BREAKPOINT_COUNT - 1)) / total_w, canvas_h * 0.86f / max_h);
+    float x = floorf((canvas_w - (total_w * scale + gap * (BREAKPOINT_COUNT - 1))) / 2.0f);
+    const float y = floorf((canvas_h - max_h * scale) / 2.0f + canvas_h * 0.03f);
+    
+    for (int i = 0; i < BREAKPOINT_COUNT; i++) {
+        struct breakpoint_tile *tile = &tiles[i];
+        get_overlay_params_sized(s, breakpoints[i].width, breakpoints[i].height, &tile->params);
+        tile->params.bootstrap_columns = breakpoints[i].columns;
+        tile->params.bootstrap_gutter = breakpoints[i].gutter;
+        tile->params.measurement_labels = false;  // Unreadable at tile scale
+        tile->x = x;
+        tile->y = y;
+        tile->scale = scale;
+        x += floorf((float)breakpoints[i].width * scale) + gap;
+    }
+}
+
+static uint32_t get_layer_mask(const struct overlay_settings *s)
 {
-    const uint32_t color = COLOR_CROSSHAIR_YELLOW;
-    const float opacity = ctx->crosshair_opacity * 0.6f;
-    
-    // Precise mathematical positioning
-    const float third_x1 = floorf((float)ctx->canvas_width / 3.0f);
-    const float third_x2 = floorf((float)ctx->canvas_width * 2.0f / 3.0f);
-    const float third_y1 = floorf((float)ctx->canvas_height / 3.0f);
-    const float third_y2 = floorf((float)ctx->canvas_height * 2.0f / 3.0f);
-    
-    // Vertical lines
-    draw_simple_line(third_x1, 0.0f, third_x1, (float)ctx->canvas_height,
-                    color, opacity, effect, color_param);
-    draw_simple_line(third_x2, 0.0f, third_x2, (float)ctx->canvas_height,
-                    color, opacity, effect, color_param);
-    
-    // Horizontal lines
-    draw_simple_line(0.0f, third_y1, (float)ctx->canvas_width, third_y1,
-                    color, opacity, effect, color_param);
-    draw_simple_line(0.0f, third_y2, (float)ctx->canvas_width, third_y2,
-                    color, opacity, effect, color_param);
-    
-    // Intersection dots for precision
-    const float dot_size = 4.0f;
-    
-    // Four intersection points
-    for (int i = 0; i < 2; i++) {
-        for (int j = 0; j < 2; j++) {
-            float x = (i == 0) ? third_x1 : third_x2;
-            float y = (j == 0) ? third_y1 : third_y2;
-            
-            // Small cross at intersection
-            draw_simple_line(x - dot_size, y, x + dot_size, y,
-                           color, opacity, effect, color_param);
-            draw_simple_line(x, y - dot_size, x, y + dot_size,
-                           color, opacity, effect, color_param);
-        }
+    uint32_t mask = 0;
+    if (s->show_center_guides) mask |= OVERLAY_LAYER_BIT(OVERLAY_LAYER_CENTER_GUIDES);
+    if (s->show_rule_of_thirds) mask |= OVERLAY_LAYER_BIT(OVERLAY_LAYER_RULE_OF_THIRDS);
+    if (s->show_material_grid) mask |= OVERLAY_LAYER_BIT(OVERLAY_LAYER_MATERIAL_GRID);
+    if (s->show_bootstrap_grid) mask |= OVERLAY_LAYER_BIT(OVERLAY_LAYER_BOOTSTRAP_GRID);
+    if (s->show_safe_zones) mask |= OVERLAY_LAYER_BIT(OVERLAY_LAYER_SAFE_ZONES);
+    if (s->show_custom_layout && s->custom_layout) mask |= OVERLAY_LAYER_BIT(OVERLAY_LAYER_CUSTOM);
+    if (s->show_crosshair) mask |= OVERLAY_LAYER_BIT(OVERLAY_LAYER_CROSSHAIR);
+    if (s->show_branding) mask |= OVERLAY_LAYER_BIT(OVERLAY_LAYER_BRANDING);
+    return mask;
+}
+
+// Every layer that has content, so hotkeys can show the ones the properties leave off
+static uint32_t get_build_mask(const struct overlay_settings *s)
+{
+    uint32_t mask = OVERLAY_LAYER_BIT(OVERLAY_LAYER_COUNT) - 1;
+    if (!s->custom_layout) mask &= ~OVERLAY_LAYER_BIT(OVERLAY_LAYER_CUSTOM);
+    return mask;
+}
+
+// ============================================================================
+// Settings snapshots
+// ============================================================================
+
+static void settings_derive(struct overlay_settings *s)
+{
+    get_overlay_params(s, &s->params);
+    overlay_compute_layout(&s->params, &s->layout);
+    s->layer_mask = get_layer_mask(s);
+    s->build_mask = get_build_mask(s);
+    if (s->show_breakpoints) {
+        get_breakpoint_tiles(s, s->tiles);
     }
 }
 
-static void render_crosshair(struct design_overlay_data *ctx, gs_effect_t *effect, gs_eparam_t *color_param)
+static void settings_free(struct overlay_settings *s)
 {
-    const float cx = floorf((float)ctx->canvas_width / 2.0f);
-    const float cy = floorf((float)ctx->canvas_height / 2.0f);
-    const float size = 40.0f;
-    const uint32_t color = COLOR_CROSSHAIR_YELLOW;
-    const float opacity = ctx->crosshair_opacity;
-    
-    // Main crosshair lines
-    draw_simple_line(cx - size, cy, cx + size, cy,
-                    color, opacity, effect, color_param);
-    draw_simple_line(cx, cy - size, cx, cy + size,
-                    color, opacity, effect, color_param);
-    
-    // Center dot
-    const float dot_size = 3.0f;
-    draw_simple_line(cx - dot_size, cy, cx + dot_size, cy,
-                    color, opacity, effect, color_param);
-    draw_simple_line(cx, cy - dot_size, cx, cy + dot_size,
-                    color, opacity, effect, color_param);
-    
-    // Tick marks for precision
-    const float tick_size = 8.0f;
-    const float tick_offset = size + 5.0f;
-    
-    // Horizontal ticks
-    draw_simple_line(cx - tick_offset, cy - tick_size, cx - tick_offset, cy + tick_size,
-                    color, opacity * 0.7f, effect, color_param);
-    draw_simple_line(cx + tick_offset, cy - tick_size, cx + tick_offset, cy + tick_size,
-                    color, opacity * 0.7f, effect, color_param);
-    
-    // Vertical ticks
-    draw_simple_line(cx - tick_size, cy - tick_offset, cx + tick_size, cy - tick_offset,
-                    color, opacity * 0.7f, effect, color_param);
-    draw_simple_line(cx - tick_size, cy + tick_offset, cx + tick_size, cy + tick_offset,
-                    color, opacity * 0.7f, effect, color_param);
+    layout_file_release(s->custom_layout);
+    reference_image_release(s->reference);
+    bfree(s->export_path);
+    bfree(s);
+}
+
+static struct overlay_settings *settings_resize(const struct overlay_settings *src, uint32_t width,
+                                                uint32_t height)
+{
+    struct overlay_settings *s = bmemdup(src, sizeof(struct overlay_settings));
+    s->retired_next = NULL;
+    s->export_path = bstrdup(src->export_path);
+    layout_file_addref(s->custom_layout);
+    reference_image_addref(s->reference);
+    s->canvas_width = width;
+    s->canvas_height = height;
+    settings_derive(s);
+    return s;
+}
+
+// The replaced snapshot may still be in use by the current frame, so it is
+// only queued for reclamation
+static void retire_settings(struct design_overlay_data *ctx, struct overlay_settings *old)
+{
+    if (!old) return;
+    
+    // Push only; the graphics thread takes the whole list at once, so there is no ABA
+    struct overlay_settings *head;
+    do {
+        head = overlay_atomic_load_ptr((void *volatile *)&ctx->retired);
+        old->retired_next = head;
+    } while (!overlay_atomic_compare_swap_ptr((void *volatile *)&ctx->retired, head, old));
+}
+
+// Any thread, after a swap. Writes the snapshot that is latest now, not the one
+// the caller swapped in, so of two racing publishers the last write is always
+// the winner's layout. The lock keeps acquire_settings from freeing that
+// snapshot while it is read. Unchanged layouts are not rewritten.
+static void publish_layout(struct design_overlay_data *ctx)
+{
+    pthread_mutex_lock(&ctx->publish_mutex);
+    const struct overlay_settings *latest = overlay_atomic_load_ptr((void *volatile *)&ctx->latest);
+    if (latest) {
+        overlay_shm_publish_layout(ctx->shm, &latest->params, &latest->layout);
+    }
+    pthread_mutex_unlock(&ctx->publish_mutex);
+}
+
+// Any thread. Opens or closes the shared-memory region when publishing is toggled,
+// so instances that do not publish hold no named region
+static void set_layout_publishing(struct design_overlay_data *ctx, bool publish)
+{
+    pthread_mutex_lock(&ctx->publish_mutex);
+    if (publish && !ctx->shm) {
+        ctx->shm = overlay_shm_create(obs_source_get_name(ctx->source));
+    } else if (!publish && ctx->shm) {
+        overlay_shm_destroy(ctx->shm);
+        ctx->shm = NULL;
+    }
+    pthread_mutex_unlock(&ctx->publish_mutex);
 }
 
-static void render_center_guides(struct design_overlay_data *ctx, gs_effect_t *effect, gs_eparam_t *color_param)
+// Any thread
+static void publish_settings(struct design_overlay_data *ctx, struct overlay_settings *s)
 {
-    const float cx = floorf((float)ctx->canvas_width / 2.0f);
-    const float cy = floorf((float)ctx->canvas_height / 2.0f);
-    const uint32_t color = 0xFF888888; // Gray
-    const float opacity = ctx->crosshair_opacity * 0.4f;
+    os_atomic_set_long(&ctx->width, (long)s->canvas_width);
+    os_atomic_set_long(&ctx->height, (long)s->canvas_height);
     
-    // Full-screen center lines
-    draw_simple_line(cx, 0.0f, cx, (float)ctx->canvas_height,
-                    color, opacity, effect, color_param);
-    draw_simple_line(0.0f, cy, (float)ctx->canvas_width, cy,
-                    color, opacity, effect, color_param);
+    retire_settings(ctx, overlay_atomic_exchange_ptr((void *volatile *)&ctx->latest, s));
+    publish_layout(ctx);
 }
 
-static void render_branding(struct design_overlay_data *ctx, gs_effect_t *effect, gs_eparam_t *color_param)
+// Graphics thread. Publishes s only if expected is still the latest snapshot,
+// so an update published in the meantime is never overwritten; s is freed
+// otherwise. Returns true when s was published.
+static bool republish_settings(struct design_overlay_data *ctx, const struct overlay_settings *expected,
+                               struct overlay_settings *s)
 {
-    if (!ctx->show_branding) return;
+    if (!overlay_atomic_compare_swap_ptr((void *volatile *)&ctx->latest, (void *)expected, s)) {
+        settings_free(s);
+        return false;
+    }
     
-    // Simple "design.rip" text representation in bottom right
-    const float margin = 20.0f;
-    const float x = (float)ctx->canvas_width - margin - 60.0f;
-    const float y = (float)ctx->canvas_height - margin - 10.0f;
-    const uint32_t color = COLOR_BRAND_BLUE;
-    const float opacity = 0.7f;
+    os_atomic_set_long(&ctx->width, (long)s->canvas_width);
+    os_atomic_set_long(&ctx->height, (long)s->canvas_height);
+    
+    retire_settings(ctx, (struct overlay_settings *)expected);
+    publish_layout(ctx);
+    return true;
+}
+
+// Graphics thread, once per frame before anything reads ctx->cfg. Every
+// snapshot on the retired list was replaced before the list was taken, so
+// none of them can be the one loaded afterwards.
+static void acquire_settings(struct design_overlay_data *ctx)
+{
+    struct overlay_settings *retired = overlay_atomic_exchange_ptr((void *volatile *)&ctx->retired, NULL);
+    const struct overlay_settings *latest = overlay_atomic_load_ptr((void *volatile *)&ctx->latest);
     
-    // Simple text-like lines to represent "design.rip"
-    const float char_width = 8.0f;
-    const float char_height = 12.0f;
+    if (latest != ctx->cfg) {
+        ctx->cfg = latest;
+        ctx->needs_redraw = true;
+    }
     
-    // "d" 
-    draw_simple_line(x, y, x, y + char_height, color, opacity, effect, color_param);
-    draw_simple_line(x, y, x + char_width, y, color, opacity, effect, color_param);
-    draw_simple_line(x + char_width, y, x + char_width, y + char_height, color, opacity, effect, color_param);
-    draw_simple_line(x, y + char_height, x + char_width, y + char_height, color, opacity, effect, color_param);
+    if (!retired) return;
     
-    // dot
-    draw_simple_line(x + char_width * 1.5f, y + char_height * 0.8f, x + char_width * 1.5f + 2, y + char_height * 0.8f, 
-                    color, opacity, effect, color_param);
+    // A layout write may still be reading one of them
+    pthread_mutex_lock(&ctx->publish_mutex);
+    while (retired) {
+        struct overlay_settings *next = retired->retired_next;
+        settings_free(retired);
+        retired = next;
+    }
+    pthread_mutex_unlock(&ctx->publish_mutex);
 }
 
 // ============================================================================
@@ -358,7 +799,8 @@ static const char *design_overlay_get_name(void *unused)
     return PLUGIN_NAME;
 }
 
-static void *design_overlay_create(obs_data_t *settings, obs_source_t *source)
+static struct design_overlay_data *create_context(obs_data_t *settings, obs_source_t *source,
+                                                  bool is_filter)
 {
     struct design_overlay_data *ctx = bzalloc(sizeof(struct design_overlay_data));
     if (!ctx) {
@@ -366,10 +808,60 @@ static void *design_overlay_create(obs_data_t *settings, obs_source_t *source)
     }
     
     ctx->source = source;
+    ctx->is_filter = is_filter;
     ctx->needs_redraw = true;
-    ctx->last_render_time = 0;
+    ctx->output_ratio = 1.0f;
+    ctx->grid_lod.lod = 1;
+    for (int i = 0; i < BREAKPOINT_COUNT; i++) {
+        ctx->breakpoint_lod[i].lod = 1;
+    }
+    pthread_mutex_init(&ctx->stats.mutex, NULL);
+    pthread_mutex_init(&ctx->publish_mutex, NULL);
+    ctx->export_hotkey = OBS_INVALID_HOTKEY_ID;
+    ctx->picker_hotkey = OBS_INVALID_HOTKEY_ID;
+    for (int i = 0; i < LOUPE_MOVE_COUNT; i++) {
+        ctx->loupe_hotkeys[i] = OBS_INVALID_HOTKEY_ID;
+    }
+    ctx->picked_color = -1;
+    ctx->reference_mismatch = -1;
+    
+    // Filters start at the base canvas until the first tick sees the parent
+    struct obs_video_info ovi;
+    const bool have_video = obs_get_video_info(&ovi);
+    ctx->filter_width = have_video ? (long)ovi.base_width : 1920;
+    ctx->filter_height = have_video ? (long)ovi.base_height : 1080;
     
     design_overlay_update(ctx, settings);
+    acquire_settings(ctx);
+    
+    // Sources and filters alike
+    for (int i = 0; i < OVERLAY_LAYER_COUNT; i++) {
+        ctx->layer_hotkeys[i] = obs_hotkey_register_source(source, layer_hotkey_names[i].name,
+                                                           layer_hotkey_names[i].description,
+                                                           layer_hotkey_pressed, ctx);
+    }
+    return ctx;
+}
+
+static void *design_overlay_create(obs_data_t *settings, obs_source_t *source)
+{
+    struct design_overlay_data *ctx = create_context(settings, source, false);
+    if (!ctx) {
+        return NULL;
+    }
+    
+    obs_add_main_render_callback(design_overlay_main_render, ctx);
+    ctx->export_hotkey = obs_hotkey_register_source(source, "design_overlay.export",
+                                                    "Export Annotated Screenshot",
+                                                    export_hotkey_pressed, ctx);
+    ctx->picker_hotkey = obs_hotkey_register_source(source, "design_overlay.pick_color",
+                                                    "Sample Color Under the Picker",
+                                                    picker_hotkey_pressed, ctx);
+    for (int i = 0; i < LOUPE_MOVE_COUNT; i++) {
+        ctx->loupe_hotkeys[i] = obs_hotkey_register_source(source, loupe_moves[i].name,
+                                                           loupe_moves[i].description,
+                                                           loupe_hotkey_pressed, ctx);
+    }
     
     blog(LOG_INFO, "[Design Overlay] Clean overlay created (version %s)", PLUGIN_VERSION);
     return ctx;
@@ -380,6 +872,88 @@ static void design_overlay_destroy(void *data)
     struct design_overlay_data *ctx = data;
     if (!ctx) return;
     
+    if (!ctx->is_filter) {
+        obs_remove_main_render_callback(design_overlay_main_render, ctx);
+    }
+    if (ctx->export_hotkey != OBS_INVALID_HOTKEY_ID) {
+        obs_hotkey_unregister(ctx->export_hotkey);
+    }
+    if (ctx->picker_hotkey != OBS_INVALID_HOTKEY_ID) {
+        obs_hotkey_unregister(ctx->picker_hotkey);
+    }
+    for (int i = 0; i < LOUPE_MOVE_COUNT; i++) {
+        if (ctx->loupe_hotkeys[i] != OBS_INVALID_HOTKEY_ID) {
+            obs_hotkey_unregister(ctx->loupe_hotkeys[i]);
+        }
+    }
+    for (int i = 0; i < OVERLAY_LAYER_COUNT; i++) {
+        if (ctx->layer_hotkeys[i] != OBS_INVALID_HOTKEY_ID) {
+            obs_hotkey_unregister(ctx->layer_hotkeys[i]);
+        }
+    }
+    
+    obs_enter_graphics();
+    shared_geometry_release(ctx->geometry);
+    for (int i = 0; i < BREAKPOINT_COUNT; i++) {
+        shared_geometry_release(ctx->breakpoint_geometry[i]);
+    }
+    gs_texrender_destroy(ctx->parent_texrender);
+    gs_texture_destroy(ctx->picker_texture);
+    readback_ring_free(&ctx->picker_ring);
+    gs_texrender_destroy(ctx->analyzer_texrender);
+    readback_ring_free(&ctx->analyzer_ring);
+    gs_texrender_destroy(ctx->palette_texrender);
+    readback_ring_free(&ctx->palette_ring);
+    gs_texrender_destroy(ctx->canvas_texrender);
+    for (int i = 0; i <= REFERENCE_REDUCE_PASSES; i++) {
+        gs_texrender_destroy(ctx->reference_reduce[i]);
+    }
+    readback_ring_free(&ctx->reference_ring);
+    gs_texture_destroy(ctx->loupe_texture);
+    gs_texrender_destroy(ctx->scope_texrender);
+    readback_ring_free(&ctx->scope_ring);
+    gs_vertexbuffer_destroy(ctx->scope_points);
+    gs_texrender_destroy(ctx->waveform_texrender);
+    gs_texrender_destroy(ctx->vectorscope_texrender);
+    gs_texrender_destroy(ctx->export_texrender);
+    readback_ring_free(&ctx->export_ring);
+    obs_leave_graphics();
+    
+    analyzer_destroy(ctx->analyzer);
+    palette_destroy(ctx->palette);
+    exporter_destroy(ctx->exporter);  // Lets queued exports finish writing
+    bfree(ctx->export_directory);
+    layout_file_release(ctx->export_layout);
+    overlay_prims_free(&ctx->picker_prims);
+    overlay_prims_free(&ctx->analyzer_prims);
+    overlay_prims_free(&ctx->palette_prims);
+    overlay_prims_free(&ctx->loupe_prims);
+    overlay_prims_free(&ctx->reference_prims);
+    overlay_prims_free(&ctx->scope_prims);
+    overlay_prims_free(&ctx->breakpoint_prims);
+    overlay_shm_destroy(ctx->shm);
+    
+    log_render_cost(ctx);
+    
+    struct dstr summary;
+    dstr_init(&summary);
+    stats_format(ctx, &summary);
+    blog(LOG_INFO, "[Design Overlay] Render statistics for '%s':\n%s",
+         obs_source_get_name(ctx->source), summary.array);
+    dstr_free(&summary);
+    pthread_mutex_destroy(&ctx->stats.mutex);
+    pthread_mutex_destroy(&ctx->publish_mutex);
+    
+    const long cache_rebuilds = os_atomic_load_long(&ctx->cache_rebuilds);
+    if (cache_rebuilds > 0) {
+        blog(LOG_INFO, "[Design Overlay] Texture cache: %ld rebuilds, %ld hits", cache_rebuilds,
+             os_atomic_load_long(&ctx->cache_hits));
+    }
+    
+    // ctx->cfg is either the latest snapshot or still on the retired list
+    acquire_settings(ctx);
+    settings_free(ctx->latest);
+    
     blog(LOG_INFO, "[Design Overlay] Clean overlay destroyed");
     bfree(ctx);
 }
@@ -389,48 +963,139 @@ static void design_overlay_update(void *data, obs_data_t *settings)
     struct design_overlay_data *ctx = data;
     if (!ctx) return;
     
+    struct overlay_settings *s = bzalloc(sizeof(struct overlay_settings));
+    
     // Basic flags
-    ctx->enabled = obs_data_get_bool(settings, "enabled");
-    ctx->show_material_grid = obs_data_get_bool(settings, "show_material_grid");
-    ctx->show_bootstrap_grid = obs_data_get_bool(settings, "show_bootstrap_grid");
-    ctx->show_safe_zones = obs_data_get_bool(settings, "show_safe_zones");
-    ctx->show_crosshair = obs_data_get_bool(settings, "show_crosshair");
-    ctx->show_rule_of_thirds = obs_data_get_bool(settings, "show_rule_of_thirds");
-    ctx->show_center_guides = obs_data_get_bool(settings, "show_center_guides");
-    ctx->show_branding = obs_data_get_bool(settings, "show_branding");
+    s->enabled = obs_data_get_bool(settings, "enabled");
+    s->show_material_grid = obs_data_get_bool(settings, "show_material_grid");
+    s->show_bootstrap_grid = obs_data_get_bool(settings, "show_bootstrap_grid");
+    s->show_safe_zones = obs_data_get_bool(settings, "show_safe_zones");
+    s->show_crosshair = obs_data_get_bool(settings, "show_crosshair");
+    s->show_rule_of_thirds = obs_data_get_bool(settings, "show_rule_of_thirds");
+    s->show_center_guides = obs_data_get_bool(settings, "show_center_guides");
+    s->show_branding = obs_data_get_bool(settings, "show_branding");
+    s->show_color_picker = obs_data_get_bool(settings, "show_color_picker");
+    s->show_grid_analyzer = obs_data_get_bool(settings, "show_grid_analyzer");
+    s->show_palette = obs_data_get_bool(settings, "show_palette");
+    s->show_contrast = obs_data_get_bool(settings, "show_contrast");
+    s->show_loupe = obs_data_get_bool(settings, "show_loupe");
+    s->show_reference = obs_data_get_bool(settings, "show_reference");
+    s->show_scopes = obs_data_get_bool(settings, "show_scopes");
+    s->show_breakpoints = obs_data_get_bool(settings, "show_breakpoints");
+    s->show_custom_layout = obs_data_get_bool(settings, "show_custom_layout");
+    s->show_measurements = obs_data_get_bool(settings, "show_measurements");
+    if (ctx->is_filter) {
+        // These sample the program canvas, which the filter's parent need not match
+        s->show_color_picker = false;
+        s->show_grid_analyzer = false;
+        s->show_palette = false;
+        s->show_contrast = false;
+        s->show_loupe = false;
+        s->show_reference = false;
+        s->show_scopes = false;
+    }
     
     // Opacity settings
-    ctx->grid_opacity = (float)obs_data_get_double(settings, "grid_opacity") / 100.0f;
-    ctx->safe_zone_opacity = (float)obs_data_get_double(settings, "safe_zone_opacity") / 100.0f;
-    ctx->crosshair_opacity = (float)obs_data_get_double(settings, "crosshair_opacity") / 100.0f;
+    s->grid_opacity = (float)obs_data_get_double(settings, "grid_opacity") / 100.0f;
+    s->safe_zone_opacity = (float)obs_data_get_double(settings, "safe_zone_opacity") / 100.0f;
+    s->crosshair_opacity = (float)obs_data_get_double(settings, "crosshair_opacity") / 100.0f;
     
     // Colors
-    ctx->grid_color = (uint32_t)obs_data_get_int(settings, "grid_color");
-    ctx->safe_zone_color = (uint32_t)obs_data_get_int(settings, "safe_zone_color");
-    ctx->crosshair_color = (uint32_t)obs_data_get_int(settings, "crosshair_color");
-    
-    // Configuration
-    ctx->canvas_width = (uint32_t)obs_data_get_int(settings, "canvas_width");
-    ctx->canvas_height = (uint32_t)obs_data_get_int(settings, "canvas_height");
-    ctx->material_grid_size = (int)obs_data_get_int(settings, "material_grid_size");
-    ctx->bootstrap_columns = (int)obs_data_get_int(settings, "bootstrap_columns");
-    ctx->bootstrap_gutter = (float)obs_data_get_double(settings, "bootstrap_gutter");
-    ctx->safe_zone_type = (int)obs_data_get_int(settings, "safe_zone_type");
-    ctx->custom_safe_zone_percent = (float)obs_data_get_double(settings, "custom_safe_zone_percent") / 100.0f;
+    s->grid_color = (uint32_t)obs_data_get_int(settings, "grid_color");
+    s->safe_zone_color = (uint32_t)obs_data_get_int(settings, "safe_zone_color");
+    s->crosshair_color = (uint32_t)obs_data_get_int(settings, "crosshair_color");
+    s->line_width = (float)obs_data_get_double(settings, "line_width");
+    
+    // Configuration (the filter takes its canvas from the parent instead)
+    if (ctx->is_filter) {
+        s->canvas_width = (uint32_t)os_atomic_load_long(&ctx->filter_width);
+        s->canvas_height = (uint32_t)os_atomic_load_long(&ctx->filter_height);
+    } else {
+        s->canvas_width = (uint32_t)obs_data_get_int(settings, "canvas_width");
+        s->canvas_height = (uint32_t)obs_data_get_int(settings, "canvas_height");
+    }
+    s->material_grid_size = (int)obs_data_get_int(settings, "material_grid_size");
+    s->bootstrap_columns = (int)obs_data_get_int(settings, "bootstrap_columns");
+    s->bootstrap_gutter = (float)obs_data_get_double(settings, "bootstrap_gutter");
+    s->safe_zone_type = (int)obs_data_get_int(settings, "safe_zone_type");
+    s->custom_safe_zone_percent = (float)obs_data_get_double(settings, "custom_safe_zone_percent") / 100.0f;
+    s->render_mode = (int)obs_data_get_int(settings, "render_mode");
+    s->grid_engine = (int)obs_data_get_int(settings, "grid_engine");
+    s->picker_x = (int)obs_data_get_int(settings, "picker_x");
+    s->picker_y = (int)obs_data_get_int(settings, "picker_y");
+    s->picker_size = (int)obs_data_get_int(settings, "picker_size");
+    s->analyzer_scale = (int)obs_data_get_int(settings, "analyzer_scale");
+    s->analyzer_interval_ms = (int)obs_data_get_int(settings, "analyzer_interval_ms");
+    s->analyzer_threshold = (int)obs_data_get_int(settings, "analyzer_threshold");
+    s->palette_colors = (int)obs_data_get_int(settings, "palette_colors");
+    s->palette_interval_ms = (int)obs_data_get_int(settings, "palette_interval_ms");
+    s->contrast_level = (int)obs_data_get_int(settings, "contrast_level");
+    s->contrast_radius = (int)obs_data_get_int(settings, "contrast_radius");
+    s->loupe_size = (int)obs_data_get_int(settings, "loupe_size");
+    s->loupe_zoom = (int)obs_data_get_int(settings, "loupe_zoom");
+    s->reference_mode = (int)obs_data_get_int(settings, "reference_mode");
+    s->reference_opacity = (float)obs_data_get_double(settings, "reference_opacity") / 100.0f;
+    s->scope_type = (int)obs_data_get_int(settings, "scope_type");
+    
+    s->export_path = bstrdup(obs_data_get_string(settings, "export_path"));
+    
+    // Re-read on every update so edits to the file apply without a restart
+    if (s->show_custom_layout) {
+        s->custom_layout = layout_file_acquire(obs_data_get_string(settings, "layout_file"));
+    }
+    if (s->show_reference) {
+        s->reference = reference_image_acquire(obs_data_get_string(settings, "reference_file"));
+    }
     
     // Validation
-    if (ctx->canvas_width < 100) ctx->canvas_width = 1920;
-    if (ctx->canvas_height < 100) ctx->canvas_height = 1080;
-    if (ctx->canvas_width > 7680) ctx->canvas_width = 7680;
-    if (ctx->canvas_height > 4320) ctx->canvas_height = 4320;
+    if (!ctx->is_filter) {
+        if (s->canvas_width < 100) s->canvas_width = 1920;
+        if (s->canvas_height < 100) s->canvas_height = 1080;
+        if (s->canvas_width > 7680) s->canvas_width = 7680;
+        if (s->canvas_height > 4320) s->canvas_height = 4320;
+    }
     
-    if (ctx->material_grid_size < 4) ctx->material_grid_size = 8;
-    if (ctx->material_grid_size > 128) ctx->material_grid_size = 128;
+    if (s->material_grid_size < 4) s->material_grid_size = 8;
+    if (s->material_grid_size > 128) s->material_grid_size = 128;
     
-    if (ctx->bootstrap_columns < 1) ctx->bootstrap_columns = 12;
-    if (ctx->bootstrap_columns > 24) ctx->bootstrap_columns = 24;
+    if (s->bootstrap_columns < 1) s->bootstrap_columns = 12;
+    if (s->bootstrap_columns > 24) s->bootstrap_columns = 24;
     
-    ctx->needs_redraw = true;
+    if (s->line_width < 0.0f) s->line_width = 0.0f;
+    if (s->line_width > 8.0f) s->line_width = 8.0f;
+    
+    if (s->picker_size < 1) s->picker_size = 1;
+    if (s->picker_size > 64) s->picker_size = 64;
+    
+    if (s->analyzer_scale < 1) s->analyzer_scale = 2;
+    if (s->analyzer_scale > 8) s->analyzer_scale = 8;
+    if (s->analyzer_interval_ms < 100) s->analyzer_interval_ms = 100;
+    if (s->analyzer_threshold < 1) s->analyzer_threshold = 1;
+    if (s->analyzer_threshold > 255) s->analyzer_threshold = 255;
+    
+    if (s->palette_colors < 2) s->palette_colors = 2;
+    if (s->palette_colors > PALETTE_MAX_COLORS) s->palette_colors = PALETTE_MAX_COLORS;
+    if (s->palette_interval_ms < 100) s->palette_interval_ms = 100;
+    
+    if (s->contrast_level != CONTRAST_LEVEL_AAA) s->contrast_level = CONTRAST_LEVEL_AA;
+    if (s->contrast_radius < 1) s->contrast_radius = 1;
+    if (s->contrast_radius > 8) s->contrast_radius = 8;
+    
+    if (s->loupe_size < 4) s->loupe_size = 4;
+    if (s->loupe_size > 64) s->loupe_size = 64;
+    if (s->loupe_zoom < 8) s->loupe_zoom = 8;
+    if (s->loupe_zoom > 32) s->loupe_zoom = 32;
+    
+    if (s->scope_type < SCOPE_WAVEFORM || s->scope_type > SCOPE_BOTH) s->scope_type = SCOPE_BOTH;
+    
+    if (s->reference_mode != REFERENCE_MODE_DIFFERENCE) s->reference_mode = REFERENCE_MODE_ONION;
+    
+    os_atomic_set_long(&ctx->loupe_x, (long)obs_data_get_int(settings, "loupe_x"));
+    os_atomic_set_long(&ctx->loupe_y, (long)obs_data_get_int(settings, "loupe_y"));
+    
+    settings_derive(s);
+    set_layout_publishing(ctx, obs_data_get_bool(settings, "publish_layout"));
+    publish_settings(ctx, s);
 }
 
 static void design_overlay_get_defaults(obs_data_t *settings)
@@ -443,6 +1108,16 @@ static void design_overlay_get_defaults(obs_data_t *settings)
     obs_data_set_default_bool(settings, "show_rule_of_thirds", false);
     obs_data_set_default_bool(settings, "show_center_guides", false);
     obs_data_set_default_bool(settings, "show_branding", true);
+    obs_data_set_default_bool(settings, "show_color_picker", false);
+    obs_data_set_default_bool(settings, "show_grid_analyzer", false);
+    obs_data_set_default_bool(settings, "show_palette", false);
+    obs_data_set_default_bool(settings, "show_contrast", false);
+    obs_data_set_default_bool(settings, "show_loupe", false);
+    obs_data_set_default_bool(settings, "show_reference", false);
+    obs_data_set_default_bool(settings, "show_scopes", false);
+    obs_data_set_default_bool(settings, "show_breakpoints", false);
+    obs_data_set_default_bool(settings, "show_custom_layout", false);
+    obs_data_set_default_bool(settings, "show_measurements", true);
     
     // Clean opacity defaults
     obs_data_set_default_double(settings, "grid_opacity", 30.0);
@@ -453,6 +1128,7 @@ static void design_overlay_get_defaults(obs_data_t *settings)
     obs_data_set_default_int(settings, "grid_color", COLOR_GRID_BLUE);
     obs_data_set_default_int(settings, "safe_zone_color", COLOR_SAFE_ORANGE);
     obs_data_set_default_int(settings, "crosshair_color", COLOR_CROSSHAIR_YELLOW);
+    obs_data_set_default_double(settings, "line_width", 1.0);
     
     // Configuration defaults
     obs_data_set_default_int(settings, "canvas_width", 1920);
@@ -462,11 +1138,34 @@ static void design_overlay_get_defaults(obs_data_t *settings)
     obs_data_set_default_double(settings, "bootstrap_gutter", 30.0);
     obs_data_set_default_int(settings, "safe_zone_type", 1);
     obs_data_set_default_double(settings, "custom_safe_zone_percent", 85.0);
+    obs_data_set_default_int(settings, "render_mode", RENDER_MODE_DIRECT);
+    obs_data_set_default_int(settings, "grid_engine", GRID_ENGINE_SHADER);
+    obs_data_set_default_int(settings, "picker_x", 960);
+    obs_data_set_default_int(settings, "picker_y", 540);
+    obs_data_set_default_int(settings, "picker_size", 8);
+    obs_data_set_default_int(settings, "analyzer_scale", 2);
+    obs_data_set_default_int(settings, "analyzer_interval_ms", 1000);
+    obs_data_set_default_int(settings, "analyzer_threshold", 32);
+    obs_data_set_default_int(settings, "palette_colors", 5);
+    obs_data_set_default_int(settings, "palette_interval_ms", 500);
+    obs_data_set_default_int(settings, "contrast_level", CONTRAST_LEVEL_AA);
+    obs_data_set_default_int(settings, "contrast_radius", 2);
+    obs_data_set_default_int(settings, "loupe_x", 960);
+    obs_data_set_default_int(settings, "loupe_y", 540);
+    obs_data_set_default_int(settings, "loupe_size", 16);
+    obs_data_set_default_int(settings, "loupe_zoom", 16);
+    obs_data_set_default_string(settings, "reference_file", "");
+    obs_data_set_default_int(settings, "reference_mode", REFERENCE_MODE_ONION);
+    obs_data_set_default_double(settings, "reference_opacity", 50.0);
+    obs_data_set_default_int(settings, "scope_type", SCOPE_BOTH);
+    obs_data_set_default_string(settings, "export_path", "");
+    obs_data_set_default_bool(settings, "publish_layout", false);
+    obs_data_set_default_string(settings, "layout_file", "");
 }
 
 static obs_properties_t *design_overlay_get_properties(void *data)
 {
-    UNUSED_PARAMETER(data);
+    struct design_overlay_data *ctx = data;
     
     obs_properties_t *props = obs_properties_create();
     
@@ -482,6 +1181,7 @@ static obs_properties_t *design_overlay_get_properties(void *data)
     obs_properties_add_float_slider(props, "bootstrap_gutter", "Bootstrap Gutter (px)", 10.0, 50.0, 5.0);
     obs_properties_add_float_slider(props, "grid_opacity", "Grid Opacity (%)", 10.0, 80.0, 5.0);
     obs_properties_add_color(props, "grid_color", "Grid Color");
+    obs_properties_add_float_slider(props, "line_width", "Line Width (screen px, 0 = hairline)", 0.0, 8.0, 0.5);
     
     // Safe zones
     obs_properties_add_text(props, "safe_header", "=== Safe Zones ===", OBS_TEXT_INFO);
@@ -503,9 +1203,120 @@ static obs_properties_t *design_overlay_get_properties(void *data)
     obs_properties_add_bool(props, "show_crosshair", "Show Crosshair");
     obs_properties_add_bool(props, "show_rule_of_thirds", "Show Rule of Thirds");
     obs_properties_add_bool(props, "show_center_guides", "Show Center Guides");
+    obs_properties_add_bool(props, "show_measurements", "Show Measurements (px)");
     obs_properties_add_float_slider(props, "crosshair_opacity", "Tools Opacity (%)", 30.0, 100.0, 5.0);
     obs_properties_add_color(props, "crosshair_color", "Tools Color");
     
+    // Custom layout
+    obs_properties_add_text(props, "layout_header", "=== Custom Layout ===", OBS_TEXT_INFO);
+    obs_properties_add_bool(props, "show_custom_layout", "Show Custom Layout");
+    obs_properties_add_path(props, "layout_file", "Layout File", OBS_PATH_FILE,
+                            "Layout files (*.json);;All files (*.*)", NULL);
+    obs_properties_add_button(props, "reload_layout", "Reload Layout File", reload_layout_clicked);
+    
+    // Color picker
+    obs_properties_add_text(props, "picker_header", "=== Color Picker ===", OBS_TEXT_INFO);
+    obs_properties_add_bool(props, "show_color_picker", "Show Color Picker");
+    obs_properties_add_int(props, "picker_x", "Picker X (px)", 0, 7680, 1);
+    obs_properties_add_int(props, "picker_y", "Picker Y (px)", 0, 4320, 1);
+    obs_properties_add_int_slider(props, "picker_size", "Sample Area (px)", 1, 64, 1);
+    obs_properties_add_button(props, "pick_now", "Sample Color Now", pick_button_clicked);
+    
+    if (ctx) {
+        const long picked = os_atomic_load_long(&ctx->picked_color);
+        if (picked >= 0) {
+            char picked_text[64];
+            snprintf(picked_text, sizeof(picked_text), "Picked: #%06lX (%ld, %ld, %ld)",
+                     picked, (picked >> 16) & 0xFF, (picked >> 8) & 0xFF, picked & 0xFF);
+            obs_properties_add_text(props, "picked_color", picked_text, OBS_TEXT_INFO);
+        }
+    }
+    
+    // Grid analyzer
+    obs_properties_add_text(props, "analyzer_header", "=== Grid Analyzer ===", OBS_TEXT_INFO);
+    obs_properties_add_bool(props, "show_grid_analyzer", "Highlight Off-Grid and Unsafe Content");
+    
+    obs_property_t *analyzer_scale_list = obs_properties_add_list(props, "analyzer_scale", "Analysis Resolution",
+                                                                OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_INT);
+    obs_property_list_add_int(analyzer_scale_list, "Full", 1);
+    obs_property_list_add_int(analyzer_scale_list, "Half", 2);
+    obs_property_list_add_int(analyzer_scale_list, "Quarter", 4);
+    
+    obs_properties_add_int(props, "analyzer_interval_ms", "Analysis Interval (ms)", 100, 10000, 100);
+    obs_properties_add_int_slider(props, "analyzer_threshold", "Edge Threshold", 1, 255, 1);
+    
+    // Palette
+    obs_properties_add_text(props, "palette_header", "=== Color Palette ===", OBS_TEXT_INFO);
+    obs_properties_add_bool(props, "show_palette", "Show Dominant Colors");
+    obs_properties_add_int_slider(props, "palette_colors", "Colors", 2, PALETTE_MAX_COLORS, 1);
+    obs_properties_add_int(props, "palette_interval_ms", "Update Interval (ms)", 100, 10000, 100);
+    
+    // Contrast
+    obs_properties_add_text(props, "contrast_header", "=== Contrast Check ===", OBS_TEXT_INFO);
+    obs_properties_add_bool(props, "show_contrast", "Highlight Low-Contrast Areas");
+    
+    obs_property_t *contrast_level_list = obs_properties_add_list(props, "contrast_level", "WCAG Level",
+                                                                OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_INT);
+    obs_property_list_add_int(contrast_level_list, "AA (4.5:1)", CONTRAST_LEVEL_AA);
+    obs_property_list_add_int(contrast_level_list, "AAA (7:1)", CONTRAST_LEVEL_AAA);
+    
+    obs_properties_add_int_slider(props, "contrast_radius", "Sample Distance (px)", 1, 8, 1);
+    
+    // Loupe
+    obs_properties_add_text(props, "loupe_header", "=== Pixel Loupe ===", OBS_TEXT_INFO);
+    obs_properties_add_bool(props, "show_loupe", "Show Pixel Loupe");
+    obs_properties_add_int(props, "loupe_x", "Loupe X (px)", 0, 7680, 1);
+    obs_properties_add_int(props, "loupe_y", "Loupe Y (px)", 0, 4320, 1);
+    obs_properties_add_int_slider(props, "loupe_size", "Region (px)", 4, 64, 1);
+    obs_properties_add_int_slider(props, "loupe_zoom", "Zoom", 8, 32, 1);
+    
+    // Reference mockup
+    obs_properties_add_text(props, "reference_header", "=== Reference Mockup ===", OBS_TEXT_INFO);
+    obs_properties_add_bool(props, "show_reference", "Compare With Mockup");
+    obs_properties_add_path(props, "reference_file", "Mockup Image", OBS_PATH_FILE,
+                            "Images (*.png *.jpg *.jpeg *.bmp);;All files (*.*)", NULL);
+    
+    obs_property_t *reference_mode_list = obs_properties_add_list(props, "reference_mode", "Blend",
+                                                                OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_INT);
+    obs_property_list_add_int(reference_mode_list, "Onion skin", REFERENCE_MODE_ONION);
+    obs_property_list_add_int(reference_mode_list, "Difference", REFERENCE_MODE_DIFFERENCE);
+    
+    obs_properties_add_float_slider(props, "reference_opacity", "Mockup Opacity (%)", 0.0, 100.0, 1.0);
+    
+    if (ctx) {
+        const long mismatch = os_atomic_load_long(&ctx->reference_mismatch);
+        if (mismatch >= 0) {
+            char mismatch_text[64];
+            snprintf(mismatch_text, sizeof(mismatch_text), "Mismatch: %ld.%02ld%% of full scale",
+                     mismatch / 100, mismatch % 100);
+            obs_properties_add_text(props, "reference_mismatch", mismatch_text, OBS_TEXT_INFO);
+        }
+    }
+    
+    // Scopes
+    obs_properties_add_text(props, "scope_header", "=== Scopes ===", OBS_TEXT_INFO);
+    obs_properties_add_bool(props, "show_scopes", "Show Scopes");
+    
+    obs_property_t *scope_type_list = obs_properties_add_list(props, "scope_type", "Scope",
+                                                            OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_INT);
+    obs_property_list_add_int(scope_type_list, "Waveform", SCOPE_WAVEFORM);
+    obs_property_list_add_int(scope_type_list, "Vectorscope", SCOPE_VECTORSCOPE);
+    obs_property_list_add_int(scope_type_list, "Waveform and vectorscope", SCOPE_BOTH);
+    
+    // Responsive preview
+    obs_properties_add_text(props, "breakpoint_header", "=== Responsive Preview ===", OBS_TEXT_INFO);
+    obs_properties_add_bool(props, "show_breakpoints", "Show Mobile / Tablet / Desktop Side by Side");
+    
+    // Export
+    obs_properties_add_text(props, "export_header", "=== Export ===", OBS_TEXT_INFO);
+    obs_properties_add_path(props, "export_path", "Export Folder (empty = plugin config folder)",
+                            OBS_PATH_DIRECTORY, NULL, NULL);
+    obs_properties_add_button(props, "export_now", "Export Annotated Screenshot", export_button_clicked);
+    
+    // External tools
+    obs_properties_add_text(props, "publish_header", "=== External Tools ===", OBS_TEXT_INFO);
+    obs_properties_add_bool(props, "publish_layout", "Publish Layout to Shared Memory");
+    
     // Branding
     obs_properties_add_text(props, "brand_header", "=== Branding ===", OBS_TEXT_INFO);
     obs_properties_add_bool(props, "show_branding", "Show design.rip");
@@ -515,98 +1326,2548 @@ static obs_properties_t *design_overlay_get_properties(void *data)
     obs_properties_add_int(props, "canvas_width", "Canvas Width (px)", 640, 7680, 1);
     obs_properties_add_int(props, "canvas_height", "Canvas Height (px)", 480, 4320, 1);
     
+    // Performance
+    obs_properties_add_text(props, "perf_header", "=== Performance ===", OBS_TEXT_INFO);
+    obs_property_t *render_mode_list = obs_properties_add_list(props, "render_mode", "Render Mode",
+                                                             OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_INT);
+    obs_property_list_add_int(render_mode_list, "Direct (vertex buffer)", RENDER_MODE_DIRECT);
+    obs_property_list_add_int(render_mode_list, "Cached texture", RENDER_MODE_TEXTURE);
+    
+    obs_property_t *grid_engine_list = obs_properties_add_list(props, "grid_engine", "Grid Engine",
+                                                             OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_INT);
+    obs_property_list_add_int(grid_engine_list, "Geometry (one line per step)", GRID_ENGINE_GEOMETRY);
+    obs_property_list_add_int(grid_engine_list, "Procedural shader", GRID_ENGINE_SHADER);
+    
+    if (ctx) {
+        struct dstr summary;
+        dstr_init(&summary);
+        stats_format(ctx, &summary);
+        obs_properties_add_text(props, "render_stats", summary.array, OBS_TEXT_INFO);
+        dstr_free(&summary);
+    }
+    
+    // The frame snapshot belongs to the graphics thread, read the setting itself
+    obs_data_t *settings = ctx ? obs_source_get_settings(ctx->source) : NULL;
+    const bool texture_mode = settings && obs_data_get_int(settings, "render_mode") == RENDER_MODE_TEXTURE;
+    obs_data_release(settings);
+    
+    if (texture_mode) {
+        char stats[128];
+        snprintf(stats, sizeof(stats), "Texture cache: %ld rebuilds, %ld hits",
+                 os_atomic_load_long(&ctx->cache_rebuilds), os_atomic_load_long(&ctx->cache_hits));
+        obs_properties_add_text(props, "cache_stats", stats, OBS_TEXT_INFO);
+    }
+    
     return props;
 }
 
+// Re-applying the settings re-reads the layout file (recompiling it if it changed)
+static bool reload_layout_clicked(obs_properties_t *props, obs_property_t *property, void *data)
+{
+    struct design_overlay_data *ctx = data;
+    
+    UNUSED_PARAMETER(props);
+    UNUSED_PARAMETER(property);
+    
+    obs_source_update(ctx->source, NULL);
+    return false;
+}
+
 static uint32_t design_overlay_get_width(void *data)
 {
     struct design_overlay_data *ctx = data;
-    return ctx ? ctx->canvas_width : 1920;
+    return ctx ? (uint32_t)os_atomic_load_long(&ctx->width) : 1920;
 }
 
 static uint32_t design_overlay_get_height(void *data)
 {
     struct design_overlay_data *ctx = data;
-    return ctx ? ctx->canvas_height : 1080;
+    return ctx ? (uint32_t)os_atomic_load_long(&ctx->height) : 1080;
 }
 
-static void design_overlay_video_tick(void *data, float seconds)
+static bool has_render_resources(const struct design_overlay_data *ctx);
+static void release_render_resources(struct design_overlay_data *ctx);
+
+// The program is rendered at the base resolution and scaled to the output afterwards
+static float output_ratio(void)
 {
-    struct design_overlay_data *ctx = data;
-    if (!ctx) return;
+    struct obs_video_info ovi;
+    if (!obs_get_video_info(&ovi) || !ovi.base_width || !ovi.base_height) return 1.0f;
     
-    UNUSED_PARAMETER(seconds);
-    ctx->last_render_time = obs_get_video_frame_time();
+    return fminf((float)ovi.output_width / (float)ovi.base_width,
+                 (float)ovi.output_height / (float)ovi.base_height);
 }
 
-static void design_overlay_video_render(void *data, gs_effect_t *effect)
+// Adopts the finest level seen since the last tick; true when the geometry must be rebuilt
+static bool settle_grid_lod(struct grid_lod_state *state)
 {
-    struct design_overlay_data *ctx = data;
-    if (!ctx || !ctx->enabled) return;
-    
-    UNUSED_PARAMETER(effect);
-    
-    // Get solid effect
-    gs_effect_t *solid_effect = obs_get_base_effect(OBS_EFFECT_SOLID);
-    if (!solid_effect) return;
-    
-    gs_eparam_t *color_param = gs_effect_get_param_by_name(solid_effect, "color");
-    if (!color_param) return;
-    
-    gs_technique_t *tech = gs_effect_get_technique(solid_effect, "Solid");
-    if (!tech) return;
-    
-    // Clean rendering setup
-    gs_blend_state_push();
-    gs_enable_blending(true);
-    gs_blend_function(GS_BLEND_SRCALPHA, GS_BLEND_INVSRCALPHA);
-    
-    gs_technique_begin(tech);
-    gs_technique_begin_pass(tech, 0);
-    
-    // Render in clean order
-    if (ctx->show_center_guides) {
-        render_center_guides(ctx, solid_effect, color_param);
-    }
-    
-    if (ctx->show_rule_of_thirds) {
-        render_rule_of_thirds(ctx, solid_effect, color_param);
+    const bool changed = state->seen && (state->seen != state->lod || state->halfway_seen != state->halfway);
+    if (changed) {
+        state->lod = state->seen;
+        state->halfway = state->halfway_seen;
     }
+    state->seen = 0;
+    return changed;
+}
+
+static void design_overlay_video_tick(void *data, float seconds)
+{
+    struct design_overlay_data *ctx = data;
+    if (!ctx) return;
     
-    if (ctx->show_material_grid) {
-        render_material_grid(ctx, solid_effect, color_param);
-    }
+    UNUSED_PARAMETER(seconds);
     
-    if (ctx->show_bootstrap_grid) {
-        render_bootstrap_grid(ctx, solid_effect, color_param);
+    // Hidden instances only drop their GPU state once; settings are picked up again on show
+    if (!os_atomic_load_bool(&ctx->showing)) {
+        if (has_render_resources(ctx)) {
+            obs_enter_graphics();
+            release_render_resources(ctx);
+            obs_leave_graphics();
+        }
+        return;
     }
     
-    if (ctx->show_safe_zones) {
-        render_safe_zones(ctx, solid_effect, color_param);
-    }
+    acquire_settings(ctx);
+    ctx->output_ratio = output_ratio();
     
-    if (ctx->show_crosshair) {
-        render_crosshair(ctx, solid_effect, color_param);
+    // Several views of one source share its geometry, so the finest level wins
+    bool lod_changed = settle_grid_lod(&ctx->grid_lod);
+    for (int i = 0; i < BREAKPOINT_COUNT; i++) {
+        lod_changed |= settle_grid_lod(&ctx->breakpoint_lod[i]);
     }
-    
-    if (ctx->show_branding) {
-        render_branding(ctx, solid_effect, color_param);
+    if (lod_changed) {
+        ctx->needs_redraw = true;
     }
-    
-    gs_technique_end_pass(tech);
-    gs_technique_end(tech);
-    
-    gs_blend_state_pop();
-    
-    ctx->needs_redraw = false;
 }
 
-// ============================================================================
-// Source info structure
-// ============================================================================
+// Flags only: the callbacks come from whichever thread changed the scene, so
+// resources are released by the next tick or main render on the graphics thread
+static void design_overlay_show(void *data)
+{
+    struct design_overlay_data *ctx = data;
+    os_atomic_set_bool(&ctx->showing, true);
+}
 
-struct obs_source_info design_overlay_source_info = {
-    .id = "design_overlay_source",
+static void design_overlay_hide(void *data)
+{
+    struct design_overlay_data *ctx = data;
+    os_atomic_set_bool(&ctx->showing, false);
+}
+
+static void design_overlay_activate(void *data)
+{
+    struct design_overlay_data *ctx = data;
+    os_atomic_set_bool(&ctx->active, true);
+}
+
+static void design_overlay_deactivate(void *data)
+{
+    struct design_overlay_data *ctx = data;
+    os_atomic_set_bool(&ctx->active, false);
+}
+
+// Hairlines: two vertices per line, drawn as GS_LINES
+static void build_line_buffer(struct shared_geometry *geometry)
+{
+    const struct overlay_prim_list *prims = &geometry->prims;
+    geometry->line_vertex_count = (uint32_t)(prims->num * 2);
+    if (geometry->line_vertex_count == 0) return;
+    
+    struct gs_vb_data *vbd = gs_vbdata_create();
+    vbd->num = geometry->line_vertex_count;
+    vbd->points = bmalloc(sizeof(struct vec3) * vbd->num);
+    vbd->colors = bmalloc(sizeof(uint32_t) * vbd->num);
+    
+    for (size_t i = 0; i < prims->num; i++) {
+        const struct overlay_line *line = &prims->lines[i];
+        const uint32_t color = to_vertex_color(line->color, 1.0f);
+        
+        vec3_set(&vbd->points[i * 2], line->x1, line->y1, 0.0f);
+        vec3_set(&vbd->points[i * 2 + 1], line->x2, line->y2, 0.0f);
+        vbd->colors[i * 2] = color;
+        vbd->colors[i * 2 + 1] = color;
+    }
+    
+    geometry->line_vb = gs_vertexbuffer_create(vbd, 0);
+    if (!geometry->line_vb) {
+        blog(LOG_WARNING, "[Design Overlay] Failed to create vertex buffer (%u vertices)",
+             geometry->line_vertex_count);
+        geometry->line_vertex_count = 0;
+    }
+}
+
+// Anti-aliased lines: each line becomes a quad of four vertices that all carry
+// both endpoints, and the "Lines" technique pushes them out to the stroke
+// width in screen space. The width is a uniform, so zooming never rebuilds.
+static void build_quad_buffers(struct shared_geometry *geometry)
+{
+    const struct overlay_prim_list *prims = &geometry->prims;
+    if (prims->num == 0) return;
+    
+    // Corner order: side (-1, +1) at the first endpoint, then at the second
+    static const float sides[4] = {-1.0f, 1.0f, -1.0f, 1.0f};
+    static const uint32_t corners[6] = {0, 1, 3, 0, 3, 2};
+    
+    struct gs_vb_data *vbd = gs_vbdata_create();
+    vbd->num = prims->num * 4;
+    vbd->points = bmalloc(sizeof(struct vec3) * vbd->num);
+    vbd->colors = bmalloc(sizeof(uint32_t) * vbd->num);
+    vbd->num_tex = 1;
+    vbd->tvarray = bzalloc(sizeof(struct gs_tvertarray));
+    vbd->tvarray[0].width = 4;
+    vbd->tvarray[0].array = bmalloc(sizeof(struct vec4) * vbd->num);
+    struct vec4 *quad = vbd->tvarray[0].array;
+    
+    const size_t index_count = prims->num * 6;
+    uint32_t *indices = bmalloc(sizeof(uint32_t) * index_count);
+    
+    for (size_t i = 0; i < prims->num; i++) {
+        const struct overlay_line *line = &prims->lines[i];
+        const uint32_t color = to_vertex_color(line->color, 1.0f);
+        const uint32_t base = (uint32_t)(i * 4);
+        
+        for (int c = 0; c < 4; c++) {
+            const bool first = c < 2;
+            vec3_set(&vbd->points[base + c], first ? line->x1 : line->x2, first ? line->y1 : line->y2, 0.0f);
+            vec4_set(&quad[base + c], first ? line->x2 : line->x1, first ? line->y2 : line->y1, sides[c],
+                     first ? 1.0f : -1.0f);
+            vbd->colors[base + c] = color;
+        }
+        
+        for (int c = 0; c < 6; c++) indices[i * 6 + c] = base + corners[c];
+    }
+    
+    geometry->quad_vb = gs_vertexbuffer_create(vbd, 0);
+    geometry->quad_ib = gs_indexbuffer_create(GS_UNSIGNED_LONG, indices, index_count, 0);
+    if (!geometry->quad_vb || !geometry->quad_ib) {
+        blog(LOG_WARNING, "[Design Overlay] Failed to create line quad buffers (%zu lines)", prims->num);
+        gs_vertexbuffer_destroy(geometry->quad_vb);
+        gs_indexbuffer_destroy(geometry->quad_ib);
+        geometry->quad_vb = NULL;
+        geometry->quad_ib = NULL;
+        return;
+    }
+    
+    geometry->quad_index_count = (uint32_t)index_count;
+}
+
+// Every label of the entry in one buffer, laid out layer by layer so each
+// layer is one index range
+static void build_text_buffers(struct shared_geometry *geometry)
+{
+    const struct overlay_prim_list *prims = &geometry->prims;
+    
+    size_t max_quads = 0;
+    for (size_t i = 0; i < prims->label_num; i++) max_quads += strlen(prims->labels[i].text) * 2;
+    if (max_quads == 0) return;
+    
+    struct text_quad *quads = bmalloc(sizeof(struct text_quad) * max_quads);
+    size_t quad_count = 0;
+    for (int layer = 0; layer < OVERLAY_LAYER_COUNT; layer++) {
+        const size_t first = prims->label_layer_start[layer];
+        const size_t layer_first_quad = quad_count;
+        for (size_t i = first; i < first + prims->label_layer_count[layer]; i++) {
+            quad_count += text_layout_label(&prims->labels[i], quads + quad_count);
+        }
+        geometry->text_segments[layer].first = (uint32_t)(layer_first_quad * 6);
+        geometry->text_segments[layer].count = (uint32_t)((quad_count - layer_first_quad) * 6);
+    }
+    if (quad_count == 0) {
+        bfree(quads);
+        return;
+    }
+    
+    struct gs_vb_data *vbd = gs_vbdata_create();
+    vbd->num = quad_count * 4;
+    vbd->points = bmalloc(sizeof(struct vec3) * vbd->num);
+    vbd->colors = bmalloc(sizeof(uint32_t) * vbd->num);
+    vbd->num_tex = 1;
+    vbd->tvarray = bzalloc(sizeof(struct gs_tvertarray));
+    vbd->tvarray[0].width = 2;
+    vbd->tvarray[0].array = bmalloc(sizeof(struct vec2) * vbd->num);
+    struct vec2 *uv = vbd->tvarray[0].array;
+    
+    const size_t index_count = quad_count * 6;
+    uint32_t *indices = bmalloc(sizeof(uint32_t) * index_count);
+    
+    for (size_t i = 0; i < quad_count; i++) {
+        const struct text_quad *q = &quads[i];
+        const uint32_t color = to_vertex_color(q->color, 1.0f);
+        const uint32_t base = (uint32_t)(i * 4);
+        
+        vec3_set(&vbd->points[base], q->x0, q->y0, 0.0f);
+        vec3_set(&vbd->points[base + 1], q->x1, q->y0, 0.0f);
+        vec3_set(&vbd->points[base + 2], q->x0, q->y1, 0.0f);
+        vec3_set(&vbd->points[base + 3], q->x1, q->y1, 0.0f);
+        vec2_set(&uv[base], q->u0, q->v0);
+        vec2_set(&uv[base + 1], q->u1, q->v0);
+        vec2_set(&uv[base + 2], q->u0, q->v1);
+        vec2_set(&uv[base + 3], q->u1, q->v1);
+        for (int c = 0; c < 4; c++) vbd->colors[base + c] = color;
+        
+        indices[i * 6] = base;
+        indices[i * 6 + 1] = base + 1;
+        indices[i * 6 + 2] = base + 2;
+        indices[i * 6 + 3] = base + 1;
+        indices[i * 6 + 4] = base + 3;
+        indices[i * 6 + 5] = base + 2;
+    }
+    bfree(quads);
+    
+    geometry->text_vb = gs_vertexbuffer_create(vbd, 0);
+    geometry->text_ib = gs_indexbuffer_create(GS_UNSIGNED_LONG, indices, index_count, 0);
+    if (!geometry->text_vb || !geometry->text_ib) {
+        blog(LOG_WARNING, "[Design Overlay] Failed to create label buffers (%zu glyph quads)", quad_count);
+        gs_vertexbuffer_destroy(geometry->text_vb);
+        gs_indexbuffer_destroy(geometry->text_ib);
+        geometry->text_vb = NULL;
+        geometry->text_ib = NULL;
+        memset(geometry->text_segments, 0, sizeof(geometry->text_segments));
+        return;
+    }
+    
+    geometry->text_index_count = (uint32_t)index_count;
+}
+
+// Fills a new cache entry: per-layer primitives and one vertex buffer for all
+// of them, each layer a contiguous segment that can be drawn on its own
+static void build_shared_geometry(struct shared_geometry *geometry)
+{
+    const struct overlay_params *params = &geometry->key.params;
+    struct overlay_prim_list *prims = &geometry->prims;
+    const bool quads = geometry->key.line_width > 0.0f;
+    const size_t vertices_per_line = quads ? 4 : 2;
+    const size_t elements_per_line = quads ? 6 : 2;  // Indices for quads, vertices for hairlines
+    
+    overlay_prims_clear(prims);
+    
+    for (int layer = 0; layer < OVERLAY_LAYER_COUNT; layer++) {
+        prims->layer_start[layer] = prims->num;
+        prims->label_layer_start[layer] = prims->label_num;
+        if (!(geometry->key.layer_mask & OVERLAY_LAYER_BIT(layer))) continue;
+        
+        const uint64_t start_ns = os_gettime_ns();
+        profile_start(layer_profile_names[layer]);
+        geometry_build_layer(prims, params, (enum overlay_layer)layer, geometry->key.flags);
+        profile_end(layer_profile_names[layer]);
+        
+        geometry->layer_build_ns[layer] = os_gettime_ns() - start_ns;
+        geometry->layer_vertices[layer] = (uint32_t)(prims->layer_count[layer] * vertices_per_line);
+        geometry->line_segments[layer].first = (uint32_t)(prims->layer_start[layer] * elements_per_line);
+        geometry->line_segments[layer].count = (uint32_t)(prims->layer_count[layer] * elements_per_line);
+    }
+    
+    if (quads) {
+        build_quad_buffers(geometry);
+    } else {
+        build_line_buffer(geometry);
+    }
+    build_text_buffers(geometry);
+}
+
+static void rebuild_geometry(struct design_overlay_data *ctx)
+{
+    struct geometry_key key;
+    const uint32_t flags = grid_shader_active(ctx) ? GEOMETRY_SKIP_PROCEDURAL : 0;
+    const float line_width = line_quads_active(ctx) ? ctx->cfg->line_width : 0.0f;
+    
+    // The level only matters to the geometry grid; leaving it out elsewhere keeps keys shareable
+    struct overlay_params params = ctx->cfg->params;
+    params.grid_lod = !grid_shader_active(ctx) ? ctx->grid_lod.lod : 0;
+    params.grid_halfway = !grid_shader_active(ctx) && ctx->grid_lod.halfway;
+    geometry_key_init(&key, &params, ctx->cfg->build_mask, flags, line_width);
+    
+    // Acquire before releasing so an unchanged key never rebuilds
+    bool created;
+    struct shared_geometry *geometry = shared_geometry_acquire(&key, &created);
+    if (created) {
+        build_shared_geometry(geometry);
+    } else if (geometry != ctx->geometry) {
+        blog(LOG_DEBUG, "[Design Overlay] Sharing geometry with %ld other source(s), %zu cached",
+             geometry->refs - 1, shared_geometry_count());
+    }
+    
+    shared_geometry_release(ctx->geometry);
+    ctx->geometry = geometry;
+    
+    pthread_mutex_lock(&ctx->stats.mutex);
+    memcpy(ctx->stats.layer_vertices, geometry->layer_vertices, sizeof(geometry->layer_vertices));
+    memcpy(ctx->stats.layer_build_ns, geometry->layer_build_ns, sizeof(geometry->layer_build_ns));
+    pthread_mutex_unlock(&ctx->stats.mutex);
+    
+    ctx->needs_redraw = false;
+}
+
+static void set_effect_vec4(struct design_overlay_data *ctx, const char *name, const struct vec4 *value)
+{
+    gs_eparam_t *param = gs_effect_get_param_by_name(overlay_effect, name);
+    if (!param) return;
+    
+    gs_effect_set_vec4(param, value);
+    count_uniform(ctx);
+}
+
+static void set_effect_float(struct design_overlay_data *ctx, const char *name, float value)
+{
+    gs_eparam_t *param = gs_effect_get_param_by_name(overlay_effect, name);
+    if (!param) return;
+    
+    gs_effect_set_float(param, value);
+    count_uniform(ctx);
+}
+
+static inline int lowest_layer(uint32_t bits)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, bits);
+    return (int)index;
+#else
+    return __builtin_ctz(bits);
+#endif
+}
+
+// Segments of the set layers, touching ones merged, so with every layer
+// visible the whole buffer is still a single draw call
+static size_t visible_segments(const struct layer_segment *segments, uint32_t layers,
+                               struct layer_segment *runs)
+{
+    size_t count = 0;
+    for (uint32_t bits = layers; bits; bits &= bits - 1) {
+        const struct layer_segment *segment = &segments[lowest_layer(bits)];
+        if (!segment->count) continue;
+        
+        if (count && runs[count - 1].first + runs[count - 1].count == segment->first) {
+            runs[count - 1].count += segment->count;
+        } else {
+            runs[count++] = *segment;
+        }
+    }
+    return count;
+}
+
+static void draw_line_quads(struct design_overlay_data *ctx)
+{
+    struct gs_rect viewport;
+    gs_get_viewport(&viewport);
+    
+    struct vec2 viewport_size;
+    vec2_set(&viewport_size, (float)viewport.cx, (float)viewport.cy);
+    gs_eparam_t *viewport_param = gs_effect_get_param_by_name(overlay_effect, "viewport_size");
+    if (viewport_param) {
+        gs_effect_set_vec2(viewport_param, &viewport_size);
+        count_uniform(ctx);
+    }
+    set_effect_float(ctx, "line_width", ctx->geometry->key.line_width);
+    
+    // Quads of either winding, depending on the line direction
+    const enum gs_cull_mode cull_mode = gs_get_cull_mode();
+    gs_set_cull_mode(GS_NEITHER);
+    
+    // One indexed draw call per run of visible layers
+    struct layer_segment runs[OVERLAY_LAYER_COUNT];
+    const size_t run_count = visible_segments(ctx->geometry->line_segments, ctx->layers, runs);
+    
+    gs_load_vertexbuffer(ctx->geometry->quad_vb);
+    gs_load_indexbuffer(ctx->geometry->quad_ib);
+    while (gs_effect_loop(overlay_effect, "Lines")) {
+        for (size_t i = 0; i < run_count; i++) {
+            gs_draw(GS_TRIS, runs[i].first, runs[i].count);
+            count_draw(ctx, runs[i].count);
+        }
+    }
+    gs_load_indexbuffer(NULL);
+    
+    gs_set_cull_mode(cull_mode);
+}
+
+static void draw_labels(struct design_overlay_data *ctx)
+{
+    gs_eparam_t *atlas_param = gs_effect_get_param_by_name(overlay_effect, "glyph_atlas");
+    if (!atlas_param) return;
+    
+    gs_effect_set_texture(atlas_param, glyph_atlas);
+    count_uniform(ctx);
+    
+    const enum gs_cull_mode cull_mode = gs_get_cull_mode();
+    gs_set_cull_mode(GS_NEITHER);
+    
+    // Labels of the visible layers, one indexed draw call per run
+    struct layer_segment runs[OVERLAY_LAYER_COUNT];
+    const size_t run_count = visible_segments(ctx->geometry->text_segments, ctx->layers, runs);
+    
+    gs_load_vertexbuffer(ctx->geometry->text_vb);
+    gs_load_indexbuffer(ctx->geometry->text_ib);
+    while (gs_effect_loop(overlay_effect, "Text")) {
+        for (size_t i = 0; i < run_count; i++) {
+            gs_draw(GS_TRIS, runs[i].first, runs[i].count);
+            count_draw(ctx, runs[i].count);
+        }
+    }
+    gs_load_indexbuffer(NULL);
+    
+    gs_set_cull_mode(cull_mode);
+}
+
+static void draw_geometry(struct design_overlay_data *ctx)
+{
+    if (ctx->geometry->quad_vb) {
+        draw_line_quads(ctx);
+        return;
+    }
+    
+    // Get solid effect (per-vertex color variant)
+    gs_effect_t *solid_effect = obs_get_base_effect(OBS_EFFECT_SOLID);
+    if (!solid_effect) return;
+    
+    gs_eparam_t *color_param = gs_effect_get_param_by_name(solid_effect, "color");
+    if (!color_param) return;
+    
+    gs_technique_t *tech = gs_effect_get_technique(solid_effect, "SolidColored");
+    if (!tech) return;
+    
+    // Vertex colors carry the final color, so the uniform stays white
+    struct vec4 white;
+    vec4_set(&white, 1.0f, 1.0f, 1.0f, 1.0f);
+    gs_effect_set_vec4(color_param, &white);
+    count_uniform(ctx);
+    
+    gs_technique_begin(tech);
+    gs_technique_begin_pass(tech, 0);
+    
+    // One draw call per run of visible layers, a single one when all are shown
+    struct layer_segment runs[OVERLAY_LAYER_COUNT];
+    const size_t run_count = visible_segments(ctx->geometry->line_segments, ctx->layers, runs);
+    
+    gs_load_vertexbuffer(ctx->geometry->line_vb);
+    gs_load_indexbuffer(NULL);
+    for (size_t i = 0; i < run_count; i++) {
+        gs_draw(GS_LINES, runs[i].first, runs[i].count);
+        count_draw(ctx, runs[i].count);
+    }
+    
+    gs_technique_end_pass(tech);
+    gs_technique_end(tech);
+}
+
+static void draw_procedural_grid(struct design_overlay_data *ctx)
+{
+    struct vec4 color;
+    struct vec4 thirds;
+    const struct overlay_layout *layout = &ctx->cfg->layout;
+    vec4_set(&thirds, layout->thirds[0], layout->thirds[1], layout->thirds[2], layout->thirds[3]);
+    
+    struct vec2 canvas_size;
+    vec2_set(&canvas_size, (float)ctx->cfg->canvas_width, (float)ctx->cfg->canvas_height);
+    gs_eparam_t *size_param = gs_effect_get_param_by_name(overlay_effect, "canvas_size");
+    if (size_param) {
+        gs_effect_set_vec2(size_param, &canvas_size);
+        count_uniform(ctx);
+    }
+    
+    // Disabled layers get zero alpha, the shader cost stays constant
+    set_effect_float(ctx, "grid_size", (float)ctx->cfg->material_grid_size);
+    set_effect_float(ctx, "grid_min_spacing", GRID_LOD_MIN_SPACING);
+    set_effect_float(ctx, "output_scale", ctx->output_ratio);
+    const bool material = (ctx->layers & OVERLAY_LAYER_BIT(OVERLAY_LAYER_MATERIAL_GRID)) != 0;
+    color_to_vec4(&color, ctx->cfg->grid_color, material ? ctx->cfg->grid_opacity : 0.0f);
+    set_effect_vec4(ctx, "grid_color", &color);
+    
+    const bool bootstrap = (ctx->layers & OVERLAY_LAYER_BIT(OVERLAY_LAYER_BOOTSTRAP_GRID)) != 0;
+    const float bootstrap_opacity = bootstrap ? ctx->cfg->grid_opacity : 0.0f;
+    set_effect_float(ctx, "bootstrap_columns", (float)ctx->cfg->bootstrap_columns);
+    set_effect_float(ctx, "bootstrap_start", layout->container_x);
+    set_effect_float(ctx, "bootstrap_container", layout->container_w);
+    set_effect_float(ctx, "bootstrap_pitch", fmaxf(layout->column_w + layout->gutter, 1.0f));
+    color_to_vec4(&color, COLOR_BOOTSTRAP_PINK, bootstrap_opacity);
+    set_effect_vec4(ctx, "bootstrap_color", &color);
+    color_to_vec4(&color, COLOR_BOOTSTRAP_PINK, bootstrap_opacity * 0.5f);
+    set_effect_vec4(ctx, "bootstrap_edge_color", &color);
+    
+    set_effect_vec4(ctx, "thirds", &thirds);
+    const bool thirds_shown = (ctx->layers & OVERLAY_LAYER_BIT(OVERLAY_LAYER_RULE_OF_THIRDS)) != 0;
+    color_to_vec4(&color, COLOR_CROSSHAIR_YELLOW, thirds_shown ? ctx->cfg->crosshair_opacity * 0.6f : 0.0f);
+    set_effect_vec4(ctx, "thirds_color", &color);
+    
+    while (gs_effect_loop(overlay_effect, "Grid")) {
+        gs_draw_sprite(NULL, 0, ctx->cfg->canvas_width, ctx->cfg->canvas_height);
+        count_draw(ctx, 4);
+    }
+}
+
+static void draw_overlay(struct design_overlay_data *ctx)
+{
+    const uint32_t procedural_layers = OVERLAY_LAYER_BIT(OVERLAY_LAYER_MATERIAL_GRID) |
+                                       OVERLAY_LAYER_BIT(OVERLAY_LAYER_BOOTSTRAP_GRID) |
+                                       OVERLAY_LAYER_BIT(OVERLAY_LAYER_RULE_OF_THIRDS);
+    if (grid_shader_active(ctx) && (ctx->layers & procedural_layers)) {
+        profile_start("draw_procedural_grid");
+        draw_procedural_grid(ctx);
+        profile_end("draw_procedural_grid");
+    }
+    
+    if (ctx->geometry && (ctx->geometry->line_vb || ctx->geometry->quad_vb)) {
+        profile_start("draw_geometry");
+        draw_geometry(ctx);
+        profile_end("draw_geometry");
+    }
+    
+    // Labels need the effect and atlas; without them the lines still draw
+    if (ctx->geometry && ctx->geometry->text_vb && overlay_effect && glyph_atlas) {
+        profile_start("draw_labels");
+        draw_labels(ctx);
+        profile_end("draw_labels");
+    }
+}
+
+// Instances sharing the geometry but toggling different layers each keep a
+// slot, so they do not redraw the texture for one another every frame
+static gs_texture_t *update_texture_cache(struct design_overlay_data *ctx)
+{
+    if (!ctx->geometry) return NULL;
+    
+    // The shader grid inside the texture adapts to the output scale, the geometry
+    // grid to its level, so both are part of the key
+    const bool geometry_grid = !grid_shader_active(ctx);
+    const struct geometry_texture_key key = {
+        .layers = ctx->layers,
+        .output_scale = ctx->output_ratio,
+        .grid_lod = geometry_grid ? ctx->grid_lod.lod : 0,
+        .grid_halfway = geometry_grid && ctx->grid_lod.halfway,
+    };
+    struct geometry_texture *texture = shared_geometry_texture(ctx->geometry, &key);
+    if (!texture) return NULL;
+    
+    // A hotkey toggle only redraws the texture from the existing buffers
+    if (texture->valid) {
+        os_atomic_inc_long(&ctx->cache_hits);
+        return gs_texrender_get_texture(texture->texrender);
+    }
+    
+    const uint32_t width = ctx->cfg->canvas_width;
+    const uint32_t height = ctx->cfg->canvas_height;
+    
+    gs_texrender_reset(texture->texrender);
+    if (!gs_texrender_begin(texture->texrender, width, height)) {
+        return NULL;
+    }
+    
+    struct vec4 clear_color;
+    vec4_zero(&clear_color);
+    gs_clear(GS_CLEAR_COLOR, &clear_color, 0.0f, 0);
+    gs_ortho(0.0f, (float)width, 0.0f, (float)height, -100.0f, 100.0f);
+    
+    // Store premultiplied alpha so the blit composites exactly like direct drawing
+    gs_blend_state_push();
+    gs_enable_blending(true);
+    gs_blend_function_separate(GS_BLEND_SRCALPHA, GS_BLEND_INVSRCALPHA,
+                               GS_BLEND_ONE, GS_BLEND_INVSRCALPHA);
+    
+    draw_overlay(ctx);
+    
+    gs_blend_state_pop();
+    gs_texrender_end(texture->texrender);
+    
+    texture->valid = true;
+    const long rebuilds = os_atomic_inc_long(&ctx->cache_rebuilds);
+    
+    blog(LOG_DEBUG, "[Design Overlay] Texture cache rebuilt %ux%u for layers 0x%02x (%ld rebuilds, %ld hits)",
+         width, height, ctx->layers, rebuilds, os_atomic_load_long(&ctx->cache_hits));
+    return gs_texrender_get_texture(texture->texrender);
+}
+
+static void render_cached(struct design_overlay_data *ctx)
+{
+    gs_texture_t *tex = update_texture_cache(ctx);
+    if (!tex) return;
+    
+    gs_effect_t *default_effect = obs_get_base_effect(OBS_EFFECT_DEFAULT);
+    gs_eparam_t *image_param = gs_effect_get_param_by_name(default_effect, "image");
+    gs_effect_set_texture(image_param, tex);
+    count_uniform(ctx);
+    
+    gs_blend_state_push();
+    gs_enable_blending(true);
+    gs_blend_function(GS_BLEND_ONE, GS_BLEND_INVSRCALPHA);
+    
+    // One textured quad per frame
+    while (gs_effect_loop(default_effect, "Draw")) {
+        gs_draw_sprite(tex, 0, ctx->cfg->canvas_width, ctx->cfg->canvas_height);
+        count_draw(ctx, 4);
+    }
+    
+    gs_blend_state_pop();
+}
+
+// ============================================================================
+// Color picker
+// ============================================================================
+
+static void get_picker_rect(const struct design_overlay_data *ctx, float *x, float *y, float *size)
+{
+    *size = (float)ctx->cfg->picker_size;
+    *x = floorf((float)ctx->cfg->picker_x - *size / 2.0f);
+    *y = floorf((float)ctx->cfg->picker_y - *size / 2.0f);
+}
+
+// Runs on the graphics thread, two frames after the copy was queued
+static void picker_readback(void *param, const uint8_t *data, uint32_t linesize,
+                            uint32_t width, uint32_t height)
+{
+    struct design_overlay_data *ctx = param;
+    uint64_t sum[3] = {0, 0, 0};
+    
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t *row = data + (size_t)y * linesize;
+        for (uint32_t x = 0; x < width; x++) {
+            sum[0] += row[x * 4];
+            sum[1] += row[x * 4 + 1];
+            sum[2] += row[x * 4 + 2];
+        }
+    }
+    
+    const uint64_t count = (uint64_t)width * height;
+    const long r = (long)((sum[0] + count / 2) / count);
+    const long g = (long)((sum[1] + count / 2) / count);
+    const long b = (long)((sum[2] + count / 2) / count);
+    os_atomic_set_long(&ctx->picked_color, (r << 16) | (g << 8) | b);
+}
+
+static void free_picker(struct design_overlay_data *ctx)
+{
+    gs_texture_destroy(ctx->picker_texture);
+    ctx->picker_texture = NULL;
+    readback_ring_free(&ctx->picker_ring);
+    ctx->picker_sampled = false;
+}
+
+static void picker_hotkey_pressed(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed)
+{
+    struct design_overlay_data *ctx = data;
+    
+    UNUSED_PARAMETER(id);
+    UNUSED_PARAMETER(hotkey);
+    
+    if (pressed) {
+        os_atomic_set_bool(&ctx->pick_requested, true);
+    }
+}
+
+static bool pick_button_clicked(obs_properties_t *props, obs_property_t *property, void *data)
+{
+    struct design_overlay_data *ctx = data;
+    
+    UNUSED_PARAMETER(props);
+    UNUSED_PARAMETER(property);
+    
+    os_atomic_set_bool(&ctx->pick_requested, true);
+    return false;
+}
+
+static void update_color_picker(struct design_overlay_data *ctx, uint32_t cx, uint32_t cy)
+{
+    // Picker coordinates are overlay canvas pixels, the program canvas is cx x cy.
+    // The average covers every program pixel under the sample area.
+    float x, y, size;
+    get_picker_rect(ctx, &x, &y, &size);
+    const float scale_x = (float)cx / (float)ctx->cfg->canvas_width;
+    const float scale_y = (float)cy / (float)ctx->cfg->canvas_height;
+    const int region[4] = {
+        (int)floorf(x * scale_x),
+        (int)floorf(y * scale_y),
+        (int)fmaxf(roundf(size * scale_x), 1.0f),
+        (int)fmaxf(roundf(size * scale_y), 1.0f),
+    };
+    
+    // Capturing renders the whole program, so a region that stays put is only
+    // sampled again on request
+    const bool moved = !ctx->picker_sampled || memcmp(region, ctx->picker_region, sizeof(region)) != 0;
+    const bool requested = os_atomic_exchange_bool(&ctx->pick_requested, false);
+    if ((moved || requested) &&
+        capture_copy_region(&ctx->picker_texture, region[0], region[1], (uint32_t)region[2], (uint32_t)region[3])) {
+        readback_ring_stage(&ctx->picker_ring, ctx->picker_texture);
+        memcpy(ctx->picker_region, region, sizeof(region));
+        ctx->picker_sampled = true;
+    }
+    
+    // Never waits: only surfaces staged READBACK_RING_SIZE - 1 frames ago are mapped
+    readback_ring_collect(&ctx->picker_ring, picker_readback, ctx);
+}
+
+static void draw_prims_immediate(struct design_overlay_data *ctx, const struct overlay_prim_list *list)
+{
+    for (size_t first = 0; first < list->num; first += IMMEDIATE_LINES_PER_DRAW) {
+        size_t last = first + IMMEDIATE_LINES_PER_DRAW;
+        if (last > list->num) last = list->num;
+        
+        gs_render_start(true);
+        for (size_t i = first; i < last; i++) {
+            const struct overlay_line *line = &list->lines[i];
+            const uint32_t color = to_vertex_color(line->color, 1.0f);
+            
+            gs_color(color);
+            gs_vertex2f(line->x1, line->y1);
+            gs_color(color);
+            gs_vertex2f(line->x2, line->y2);
+        }
+        gs_render_stop(GS_LINES);
+        count_draw(ctx, (uint32_t)((last - first) * 2));
+    }
+}
+
+// Labels of a dynamic layer, from the glyph atlas like the cached ones. Uses its
+// own technique, so it runs outside the solid pass.
+static void draw_prim_labels(struct design_overlay_data *ctx, const struct overlay_prim_list *list)
+{
+    if (!list->label_num || !overlay_effect || !glyph_atlas) return;
+    
+    gs_eparam_t *atlas_param = gs_effect_get_param_by_name(overlay_effect, "glyph_atlas");
+    if (!atlas_param) return;
+    
+    gs_effect_set_texture(atlas_param, glyph_atlas);
+    count_uniform(ctx);
+    
+    const enum gs_cull_mode cull_mode = gs_get_cull_mode();
+    gs_set_cull_mode(GS_NEITHER);
+    
+    struct text_quad quads[2 * OVERLAY_LABEL_MAX];
+    while (gs_effect_loop(overlay_effect, "Text")) {
+        for (size_t i = 0; i < list->label_num; i++) {
+            const size_t quad_count = text_layout_label(&list->labels[i], quads);
+            if (!quad_count) continue;
+            
+            gs_render_start(true);
+            for (size_t q = 0; q < quad_count; q++) {
+                const struct text_quad *quad = &quads[q];
+                const uint32_t color = to_vertex_color(quad->color, 1.0f);
+                const float corners[6][4] = {
+                    {quad->x0, quad->y0, quad->u0, quad->v0}, {quad->x1, quad->y0, quad->u1, quad->v0},
+                    {quad->x0, quad->y1, quad->u0, quad->v1}, {quad->x1, quad->y0, quad->u1, quad->v0},
+                    {quad->x1, quad->y1, quad->u1, quad->v1}, {quad->x0, quad->y1, quad->u0, quad->v1},
+                };
+                for (int c = 0; c < 6; c++) {
+                    gs_color(color);
+                    gs_texcoord(corners[c][2], corners[c][3], 0);
+                    gs_vertex2f(corners[c][0], corners[c][1]);
+                }
+            }
+            gs_render_stop(GS_TRIS);
+            count_draw(ctx, (uint32_t)(quad_count * 6));
+        }
+    }
+    
+    gs_set_cull_mode(cull_mode);
+}
+
+// Whole font pixels for a label about text_h canvas pixels tall
+static float label_scale_for_height(float text_h)
+{
+    return fmaxf(1.0f, floorf(text_h / (float)TEXT_GLYPH_HEIGHT));
+}
+
+static void draw_filled_rect(struct design_overlay_data *ctx, float x, float y, float w, float h,
+                             uint32_t color)
+{
+    const uint32_t vertex_color = to_vertex_color(color, 1.0f);
+    
+    gs_render_start(true);
+    gs_color(vertex_color);
+    gs_vertex2f(x, y);
+    gs_color(vertex_color);
+    gs_vertex2f(x + w, y);
+    gs_color(vertex_color);
+    gs_vertex2f(x, y + h);
+    gs_color(vertex_color);
+    gs_vertex2f(x + w, y + h);
+    gs_render_stop(GS_TRISTRIP);
+    count_draw(ctx, 4);
+}
+
+static void add_rect_outline(struct overlay_prim_list *list, float x, float y, float w, float h,
+                             uint32_t color, float opacity)
+{
+    overlay_prims_add_line(list, x, y, x + w, y, color, opacity);
+    overlay_prims_add_line(list, x + w, y, x + w, y + h, color, opacity);
+    overlay_prims_add_line(list, x + w, y + h, x, y + h, color, opacity);
+    overlay_prims_add_line(list, x, y + h, x, y, color, opacity);
+}
+
+static void draw_color_picker(struct design_overlay_data *ctx)
+{
+    float x, y, size;
+    get_picker_rect(ctx, &x, &y, &size);
+    
+    const long picked = os_atomic_load_long(&ctx->picked_color);
+    const uint32_t color = COLOR_CROSSHAIR_YELLOW;
+    const float opacity = ctx->cfg->crosshair_opacity;
+    const float swatch = 48.0f;
+    const float text_h = 14.0f;
+    const float text_scale = label_scale_for_height(text_h);
+    const float panel_w = 140.0f;
+    
+    // Swatch goes right of the sample area unless that leaves the canvas
+    float panel_x = x + size + 12.0f;
+    if (panel_x + panel_w > (float)ctx->cfg->canvas_width) panel_x = x - 12.0f - panel_w;
+    float panel_y = y;
+    if (panel_y + swatch + text_h * 3.0f > (float)ctx->cfg->canvas_height) {
+        panel_y = (float)ctx->cfg->canvas_height - swatch - text_h * 3.0f;
+    }
+    
+    struct overlay_prim_list *list = &ctx->picker_prims;
+    overlay_prims_clear(list);
+    
+    // Sample area outline, kept outside the sampled pixels
+    overlay_prims_add_line(list, x - 1.0f, y - 1.0f, x + size + 1.0f, y - 1.0f, color, opacity);
+    overlay_prims_add_line(list, x + size + 1.0f, y - 1.0f, x + size + 1.0f, y + size + 1.0f, color, opacity);
+    overlay_prims_add_line(list, x + size + 1.0f, y + size + 1.0f, x - 1.0f, y + size + 1.0f, color, opacity);
+    overlay_prims_add_line(list, x - 1.0f, y + size + 1.0f, x - 1.0f, y - 1.0f, color, opacity);
+    
+    // Swatch border
+    overlay_prims_add_line(list, panel_x, panel_y, panel_x + swatch, panel_y, color, opacity);
+    overlay_prims_add_line(list, panel_x + swatch, panel_y, panel_x + swatch, panel_y + swatch, color, opacity);
+    overlay_prims_add_line(list, panel_x + swatch, panel_y + swatch, panel_x, panel_y + swatch, color, opacity);
+    overlay_prims_add_line(list, panel_x, panel_y + swatch, panel_x, panel_y, color, opacity);
+    
+    if (picked >= 0) {
+        char hex[16];
+        char rgb[16];
+        snprintf(hex, sizeof(hex), "#%06X", (unsigned)(picked & 0xFFFFFF));
+        snprintf(rgb, sizeof(rgb), "%ld,%ld,%ld", (picked >> 16) & 0xFF, (picked >> 8) & 0xFF,
+                 picked & 0xFF);
+        
+        overlay_prims_add_label(list, panel_x, panel_y + swatch + 6.0f, text_scale, OVERLAY_ALIGN_LEFT, color,
+                                opacity, "%s", hex);
+        overlay_prims_add_label(list, panel_x, panel_y + swatch + 10.0f + text_h, text_scale, OVERLAY_ALIGN_LEFT,
+                                color, opacity, "%s", rgb);
+        
+        draw_filled_rect(ctx, panel_x + 1.0f, panel_y + 1.0f, swatch - 1.0f, swatch - 1.0f,
+                         0xFF000000 | (uint32_t)picked);
+    }
+    
+    draw_prims_immediate(ctx, list);
+}
+
+// ============================================================================
+// Grid analyzer
+// ============================================================================
+
+// Runs on the graphics thread; the worker takes its own copy of the frame
+static void analyzer_readback(void *param, const uint8_t *data, uint32_t linesize,
+                              uint32_t width, uint32_t height)
+{
+    struct design_overlay_data *ctx = param;
+    analyzer_submit(ctx->analyzer, data, linesize, width, height, &ctx->analyzer_config);
+}
+
+static void free_analyzer_capture(struct design_overlay_data *ctx)
+{
+    gs_texrender_destroy(ctx->analyzer_texrender);
+    ctx->analyzer_texrender = NULL;
+    readback_ring_free(&ctx->analyzer_ring);
+    ctx->analyzer_result_count = 0;
+}
+
+static void update_grid_analyzer(struct design_overlay_data *ctx, uint32_t cx, uint32_t cy)
+{
+    if (!ctx->analyzer) {
+        ctx->analyzer = analyzer_create();
+        if (!ctx->analyzer) return;
+    }
+    if (!ctx->analyzer_texrender) {
+        ctx->analyzer_texrender = gs_texrender_create(GS_RGBA, GS_ZS_NONE);
+        if (!ctx->analyzer_texrender) return;
+    }
+    
+    const uint64_t now = os_gettime_ns();
+    const uint64_t interval_ns = (uint64_t)ctx->cfg->analyzer_interval_ms * 1000000ULL;
+    
+    if (now - ctx->analyzer_last_ns >= interval_ns) {
+        // Analysis runs in overlay canvas pixels, downscaled by analyzer_scale
+        const uint32_t width = ctx->cfg->canvas_width / (uint32_t)ctx->cfg->analyzer_scale;
+        const uint32_t height = ctx->cfg->canvas_height / (uint32_t)ctx->cfg->analyzer_scale;
+        
+        if (capture_canvas_region(ctx->analyzer_texrender, 0.0f, 0.0f, (float)cx, (float)cy,
+                                  width, height)) {
+            readback_ring_stage(&ctx->analyzer_ring, gs_texrender_get_texture(ctx->analyzer_texrender));
+            ctx->analyzer_last_ns = now;
+        }
+        
+        const struct overlay_layout *layout = &ctx->cfg->layout;
+        
+        ctx->analyzer_config.canvas_scale = (float)ctx->cfg->canvas_width / (float)width;
+        ctx->analyzer_config.grid_size = ctx->cfg->material_grid_size;
+        ctx->analyzer_config.edge_threshold = (uint8_t)ctx->cfg->analyzer_threshold;
+        ctx->analyzer_config.safe_x = layout->safe_x;
+        ctx->analyzer_config.safe_y = layout->safe_y;
+        ctx->analyzer_config.safe_w = layout->safe_w;
+        ctx->analyzer_config.safe_h = layout->safe_h;
+    }
+    
+    readback_ring_collect(&ctx->analyzer_ring, analyzer_readback, ctx);
+}
+
+static void draw_grid_analyzer(struct design_overlay_data *ctx)
+{
+    analyzer_get_results(ctx->analyzer, ctx->analyzer_results, &ctx->analyzer_result_count);
+    
+    struct overlay_prim_list *list = &ctx->analyzer_prims;
+    overlay_prims_clear(list);
+    
+    for (size_t i = 0; i < ctx->analyzer_result_count; i++) {
+        const struct analyzer_result *r = &ctx->analyzer_results[i];
+        const uint32_t color = r->issue == ANALYZER_OFF_GRID ? COLOR_ANALYZER_OFF_GRID
+                                                              : COLOR_ANALYZER_UNSAFE;
+        
+        draw_filled_rect(ctx, r->x, r->y, r->w, r->h, (color & 0x00FFFFFF) | 0x40000000);
+        
+        overlay_prims_add_line(list, r->x, r->y, r->x + r->w, r->y, color, 1.0f);
+        overlay_prims_add_line(list, r->x + r->w, r->y, r->x + r->w, r->y + r->h, color, 1.0f);
+        overlay_prims_add_line(list, r->x + r->w, r->y + r->h, r->x, r->y + r->h, color, 1.0f);
+        overlay_prims_add_line(list, r->x, r->y + r->h, r->x, r->y, color, 1.0f);
+    }
+    
+    draw_prims_immediate(ctx, list);
+}
+
+// ============================================================================
+// Color palette
+// ============================================================================
+
+// Runs on the graphics thread; the worker takes its own copy of the frame
+static void palette_readback(void *param, const uint8_t *data, uint32_t linesize,
+                             uint32_t width, uint32_t height)
+{
+    struct design_overlay_data *ctx = param;
+    palette_submit(ctx->palette, data, linesize, width, height, ctx->palette_colors);
+}
+
+static void free_palette_capture(struct design_overlay_data *ctx)
+{
+    gs_texrender_destroy(ctx->palette_texrender);
+    ctx->palette_texrender = NULL;
+    readback_ring_free(&ctx->palette_ring);
+    ctx->swatch_count = 0;
+}
+
+static void update_palette(struct design_overlay_data *ctx, uint32_t cx, uint32_t cy)
+{
+    if (!ctx->palette) {
+        ctx->palette = palette_create();
+        if (!ctx->palette) return;
+    }
+    if (!ctx->palette_texrender) {
+        ctx->palette_texrender = gs_texrender_create(GS_RGBA, GS_ZS_NONE);
+        if (!ctx->palette_texrender) return;
+    }
+    
+    const uint64_t now = os_gettime_ns();
+    const uint64_t interval_ns = (uint64_t)ctx->cfg->palette_interval_ms * 1000000ULL;
+    
+    if (now - ctx->palette_last_ns >= interval_ns) {
+        // A few thousand pixels are plenty for dominant colors, keep the aspect ratio
+        uint32_t width = PALETTE_MAX_SAMPLE;
+        uint32_t height = PALETTE_MAX_SAMPLE;
+        if (cx >= cy) {
+            height = (uint32_t)((uint64_t)PALETTE_MAX_SAMPLE * cy / cx);
+        } else {
+            width = (uint32_t)((uint64_t)PALETTE_MAX_SAMPLE * cx / cy);
+        }
+        if (width > cx) width = cx;
+        if (height > cy) height = cy;
+        if (!width) width = 1;
+        if (!height) height = 1;
+        
+        if (capture_canvas_region(ctx->palette_texrender, 0.0f, 0.0f, (float)cx, (float)cy,
+                                  width, height)) {
+            readback_ring_stage(&ctx->palette_ring, gs_texrender_get_texture(ctx->palette_texrender));
+            ctx->palette_last_ns = now;
+        }
+        ctx->palette_colors = ctx->cfg->palette_colors;
+    }
+    
+    readback_ring_collect(&ctx->palette_ring, palette_readback, ctx);
+}
+
+// Swatch strip along the bottom of the safe zone, hex value under each swatch
+static void draw_palette(struct design_overlay_data *ctx)
+{
+    struct overlay_prim_list *list = &ctx->palette_prims;
+    overlay_prims_clear(list);
+    
+    palette_get_swatches(ctx->palette, ctx->swatches, &ctx->swatch_count);
+    if (!ctx->swatch_count) return;
+    
+    const struct overlay_layout *layout = &ctx->cfg->layout;
+    const uint32_t color = COLOR_CROSSHAIR_YELLOW;
+    const float opacity = ctx->cfg->crosshair_opacity;
+    const float swatch_w = 80.0f;
+    const float swatch_h = 40.0f;
+    const float gap = 4.0f;
+    const float text_h = 14.0f;
+    
+    const float x0 = layout->safe_x;
+    const float y = layout->safe_y + layout->safe_h - swatch_h - text_h - 6.0f;
+    
+    for (size_t i = 0; i < ctx->swatch_count; i++) {
+        const uint32_t rgb = ctx->swatches[i].color;
+        const float x = x0 + (float)i * (swatch_w + gap);
+        
+        draw_filled_rect(ctx, x, y, swatch_w, swatch_h, 0xFF000000 | rgb);
+        
+        overlay_prims_add_line(list, x, y, x + swatch_w, y, color, opacity);
+        overlay_prims_add_line(list, x + swatch_w, y, x + swatch_w, y + swatch_h, color, opacity);
+        overlay_prims_add_line(list, x + swatch_w, y + swatch_h, x, y + swatch_h, color, opacity);
+        overlay_prims_add_line(list, x, y + swatch_h, x, y, color, opacity);
+        
+        overlay_prims_add_label(list, x, y + swatch_h + 6.0f, label_scale_for_height(text_h), OVERLAY_ALIGN_LEFT,
+                                color, opacity, "#%06X", rgb);
+    }
+    
+    draw_prims_immediate(ctx, list);
+}
+
+// ============================================================================
+// Canvas copy
+// ============================================================================
+
+static bool canvas_copy_wanted(const struct design_overlay_data *ctx)
+{
+    return ctx->cfg->enabled && overlay_effect &&
+           (ctx->cfg->show_contrast || (ctx->cfg->show_reference && ctx->cfg->reference) ||
+            (ctx->cfg->show_breakpoints && !ctx->is_filter));
+}
+
+static void free_canvas_copy(struct design_overlay_data *ctx)
+{
+    gs_texrender_destroy(ctx->canvas_texrender);
+    ctx->canvas_texrender = NULL;
+    ctx->canvas_copy_ready = false;
+}
+
+// Copies the program canvas at overlay canvas size; the copy stays on the GPU.
+// Returns true when the copy was refreshed.
+static bool update_canvas_copy(struct design_overlay_data *ctx, uint32_t cx, uint32_t cy)
+{
+    if (!ctx->canvas_texrender) {
+        ctx->canvas_texrender = gs_texrender_create(GS_RGBA, GS_ZS_NONE);
+        if (!ctx->canvas_texrender) return false;
+    }
+    
+    const uint64_t now = os_gettime_ns();
+    if (ctx->canvas_copy_ready && now - ctx->canvas_copy_ns < CANVAS_COPY_REFRESH_NS) return false;
+    
+    if (!capture_canvas_region(ctx->canvas_texrender, 0.0f, 0.0f, (float)cx, (float)cy,
+                               ctx->cfg->canvas_width, ctx->cfg->canvas_height)) {
+        return false;
+    }
+    
+    ctx->canvas_copy_ready = true;
+    ctx->canvas_copy_ns = now;
+    return true;
+}
+
+// ============================================================================
+// Contrast heatmap
+// ============================================================================
+
+// One full-canvas quad, the shader compares each pixel against its neighbors
+static void draw_contrast_heatmap(struct design_overlay_data *ctx)
+{
+    gs_texture_t *tex = gs_texrender_get_texture(ctx->canvas_texrender);
+    gs_eparam_t *image_param = gs_effect_get_param_by_name(overlay_effect, "canvas_image");
+    gs_eparam_t *step_param = gs_effect_get_param_by_name(overlay_effect, "contrast_step");
+    if (!tex || !image_param || !step_param) return;
+    
+    const float radius = (float)ctx->cfg->contrast_radius;
+    struct vec2 step;
+    vec2_set(&step, radius / (float)ctx->cfg->canvas_width, radius / (float)ctx->cfg->canvas_height);
+    
+    gs_effect_set_texture(image_param, tex);
+    count_uniform(ctx);
+    gs_effect_set_vec2(step_param, &step);
+    count_uniform(ctx);
+    set_effect_float(ctx, "contrast_target", ctx->cfg->contrast_level == CONTRAST_LEVEL_AAA ? 7.0f : 4.5f);
+    set_effect_float(ctx, "contrast_opacity", CONTRAST_OPACITY);
+    
+    gs_blend_state_push();
+    gs_enable_blending(true);
+    gs_blend_function(GS_BLEND_SRCALPHA, GS_BLEND_INVSRCALPHA);
+    
+    while (gs_effect_loop(overlay_effect, "Contrast")) {
+        gs_draw_sprite(NULL, 0, ctx->cfg->canvas_width, ctx->cfg->canvas_height);
+        count_draw(ctx, 4);
+    }
+    
+    gs_blend_state_pop();
+}
+
+// ============================================================================
+// Reference mockup
+// ============================================================================
+
+// Runs on the graphics thread with the REFERENCE_TILES_X x REFERENCE_TILES_Y grid
+static void reference_readback(void *param, const uint8_t *data, uint32_t linesize,
+                               uint32_t width, uint32_t height)
+{
+    struct design_overlay_data *ctx = param;
+    if (width != REFERENCE_TILES_X || height != REFERENCE_TILES_Y) return;
+    
+    float total = 0.0f;
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t *row = data + (size_t)y * linesize;
+        for (uint32_t x = 0; x < width; x++) {
+            const float score = (float)row[x * 4] / 255.0f;
+            ctx->reference_tiles[y * REFERENCE_TILES_X + x] = score;
+            total += score;
+        }
+    }
+    
+    ctx->reference_scored = true;
+    const float average = total / (float)(REFERENCE_TILES_X * REFERENCE_TILES_Y);
+    os_atomic_set_long(&ctx->reference_mismatch, (long)(average * 10000.0f + 0.5f));
+}
+
+static void free_reference_capture(struct design_overlay_data *ctx)
+{
+    for (int i = 0; i <= REFERENCE_REDUCE_PASSES; i++) {
+        gs_texrender_destroy(ctx->reference_reduce[i]);
+        ctx->reference_reduce[i] = NULL;
+    }
+    readback_ring_free(&ctx->reference_ring);
+    ctx->reference_scored = false;
+    os_atomic_set_long(&ctx->reference_mismatch, -1);
+}
+
+// Full-target quad with the current effect parameters, no blending
+static bool render_pass(gs_texrender_t *target, const char *technique, uint32_t width, uint32_t height)
+{
+    gs_texrender_reset(target);
+    if (!gs_texrender_begin(target, width, height)) return false;
+    
+    gs_ortho(0.0f, (float)width, 0.0f, (float)height, -100.0f, 100.0f);
+    gs_blend_state_push();
+    gs_enable_blending(false);
+    
+    while (gs_effect_loop(overlay_effect, technique)) {
+        gs_draw_sprite(NULL, 0, width, height);
+    }
+    
+    gs_blend_state_pop();
+    gs_texrender_end(target);
+    return true;
+}
+
+// Mismatch image, halved REFERENCE_REDUCE_PASSES times, then one tiny staged copy
+static void score_reference(struct design_overlay_data *ctx)
+{
+    gs_texture_t *reference = reference_image_texture(ctx->cfg->reference);
+    gs_texture_t *canvas = gs_texrender_get_texture(ctx->canvas_texrender);
+    gs_eparam_t *canvas_param = gs_effect_get_param_by_name(overlay_effect, "canvas_image");
+    gs_eparam_t *reference_param = gs_effect_get_param_by_name(overlay_effect, "reference_image");
+    gs_eparam_t *source_param = gs_effect_get_param_by_name(overlay_effect, "reduce_source");
+    if (!reference || !canvas || !canvas_param || !reference_param || !source_param) return;
+    
+    for (int i = 0; i <= REFERENCE_REDUCE_PASSES; i++) {
+        if (!ctx->reference_reduce[i]) {
+            ctx->reference_reduce[i] = gs_texrender_create(GS_RGBA, GS_ZS_NONE);
+            if (!ctx->reference_reduce[i]) return;
+        }
+    }
+    
+    uint32_t width = REFERENCE_TILES_X << REFERENCE_REDUCE_PASSES;
+    uint32_t height = REFERENCE_TILES_Y << REFERENCE_REDUCE_PASSES;
+    
+    gs_effect_set_texture(canvas_param, canvas);
+    gs_effect_set_texture(reference_param, reference);
+    if (!render_pass(ctx->reference_reduce[0], "Mismatch", width, height)) return;
+    
+    for (int i = 1; i <= REFERENCE_REDUCE_PASSES; i++) {
+        width /= 2;
+        height /= 2;
+        gs_effect_set_texture(source_param, gs_texrender_get_texture(ctx->reference_reduce[i - 1]));
+        if (!render_pass(ctx->reference_reduce[i], "Reduce", width, height)) return;
+    }
+    
+    readback_ring_stage(&ctx->reference_ring,
+                        gs_texrender_get_texture(ctx->reference_reduce[REFERENCE_REDUCE_PASSES]));
+}
+
+// Onion skin or difference over the whole canvas
+static void draw_reference_image(struct design_overlay_data *ctx)
+{
+    const bool difference = ctx->cfg->reference_mode == REFERENCE_MODE_DIFFERENCE;
+    gs_texture_t *reference = reference_image_texture(ctx->cfg->reference);
+    gs_eparam_t *reference_param = gs_effect_get_param_by_name(overlay_effect, "reference_image");
+    gs_eparam_t *canvas_param = gs_effect_get_param_by_name(overlay_effect, "canvas_image");
+    if (!reference || !reference_param || !canvas_param) return;
+    if (difference && !ctx->canvas_copy_ready) return;
+    
+    gs_effect_set_texture(reference_param, reference);
+    count_uniform(ctx);
+    if (difference) {
+        gs_effect_set_texture(canvas_param, gs_texrender_get_texture(ctx->canvas_texrender));
+        count_uniform(ctx);
+    }
+    set_effect_float(ctx, "reference_opacity", ctx->cfg->reference_opacity);
+    
+    gs_blend_state_push();
+    gs_enable_blending(true);
+    gs_blend_function(GS_BLEND_SRCALPHA, GS_BLEND_INVSRCALPHA);
+    
+    while (gs_effect_loop(overlay_effect, difference ? "ReferenceDiff" : "ReferenceOnion")) {
+        gs_draw_sprite(NULL, 0, ctx->cfg->canvas_width, ctx->cfg->canvas_height);
+        count_draw(ctx, 4);
+    }
+    
+    gs_blend_state_pop();
+}
+
+// Tiles above the threshold, tinted by score and labeled in percent
+static void draw_reference_tiles(struct design_overlay_data *ctx)
+{
+    const float tile_w = (float)ctx->cfg->canvas_width / (float)REFERENCE_TILES_X;
+    const float tile_h = (float)ctx->cfg->canvas_height / (float)REFERENCE_TILES_Y;
+    const uint32_t color = COLOR_ANALYZER_UNSAFE;
+    const float text_h = 14.0f;
+    
+    struct overlay_prim_list *list = &ctx->reference_prims;
+    overlay_prims_clear(list);
+    
+    for (int y = 0; y < REFERENCE_TILES_Y; y++) {
+        for (int x = 0; x < REFERENCE_TILES_X; x++) {
+            const float score = ctx->reference_tiles[y * REFERENCE_TILES_X + x];
+            if (score < REFERENCE_TILE_THRESHOLD) continue;
+            
+            const float tx = (float)x * tile_w;
+            const float ty = (float)y * tile_h;
+            const uint32_t alpha = (uint32_t)(fminf(score * 4.0f, 0.5f) * 255.0f);
+            
+            draw_filled_rect(ctx, tx, ty, tile_w, tile_h, (color & 0x00FFFFFF) | (alpha << 24));
+            overlay_prims_add_label(list, tx + 6.0f, ty + 6.0f, label_scale_for_height(text_h), OVERLAY_ALIGN_LEFT,
+                                    color, 1.0f, "%d", (int)(score * 100.0f + 0.5f));
+        }
+    }
+    
+    draw_prims_immediate(ctx, list);
+}
+
+// ============================================================================
+// Scopes
+// ============================================================================
+
+// One point per sample at a fixed position; the colors are rewritten by every readback
+static gs_vertbuffer_t *create_scope_points(void)
+{
+    struct gs_vb_data *vbd = gs_vbdata_create();
+    vbd->num = SCOPE_SAMPLES_X * SCOPE_SAMPLES_Y;
+    vbd->points = bzalloc(sizeof(struct vec3) * vbd->num);
+    vbd->colors = bzalloc(sizeof(uint32_t) * vbd->num);
+    vbd->num_tex = 1;
+    vbd->tvarray = bzalloc(sizeof(struct gs_tvertarray));
+    vbd->tvarray[0].width = 2;
+    vbd->tvarray[0].array = bmalloc(sizeof(struct vec2) * vbd->num);
+    struct vec2 *uv = vbd->tvarray[0].array;
+    
+    for (uint32_t y = 0; y < SCOPE_SAMPLES_Y; y++) {
+        for (uint32_t x = 0; x < SCOPE_SAMPLES_X; x++) {
+            vec2_set(&uv[y * SCOPE_SAMPLES_X + x], ((float)x + 0.5f) / (float)SCOPE_SAMPLES_X,
+                     ((float)y + 0.5f) / (float)SCOPE_SAMPLES_Y);
+        }
+    }
+    
+    gs_vertbuffer_t *points = gs_vertexbuffer_create(vbd, GS_DYNAMIC);
+    if (!points) {
+        blog(LOG_WARNING, "[Design Overlay] Failed to create scope sample buffer");
+    }
+    return points;
+}
+
+// Runs on the graphics thread with the SCOPE_SAMPLES_X x SCOPE_SAMPLES_Y grid.
+// RGBA bytes already are the packed vertex color layout, so rows are copied as is.
+static void scope_readback(void *param, const uint8_t *data, uint32_t linesize,
+                           uint32_t width, uint32_t height)
+{
+    struct design_overlay_data *ctx = param;
+    if (width != SCOPE_SAMPLES_X || height != SCOPE_SAMPLES_Y || !ctx->scope_points) return;
+    
+    struct gs_vb_data *vbd = gs_vertexbuffer_get_data(ctx->scope_points);
+    for (uint32_t y = 0; y < height; y++) {
+        memcpy(vbd->colors + (size_t)y * width, data + (size_t)y * linesize, (size_t)width * 4);
+    }
+    ctx->scope_points_dirty = true;
+}
+
+static void free_scope_capture(struct design_overlay_data *ctx)
+{
+    gs_texrender_destroy(ctx->scope_texrender);
+    ctx->scope_texrender = NULL;
+    readback_ring_free(&ctx->scope_ring);
+    gs_vertexbuffer_destroy(ctx->scope_points);
+    ctx->scope_points = NULL;
+    ctx->scope_points_dirty = false;
+    ctx->scope_last_ns = 0;
+    gs_texrender_destroy(ctx->waveform_texrender);
+    ctx->waveform_texrender = NULL;
+    gs_texrender_destroy(ctx->vectorscope_texrender);
+    ctx->vectorscope_texrender = NULL;
+}
+
+// Clears target, then every sample adds one hit to the bin its technique maps it to
+static bool accumulate_scope(struct design_overlay_data *ctx, gs_texrender_t **target, const char *technique,
+                             uint32_t width, uint32_t height)
+{
+    if (!*target) {
+        *target = gs_texrender_create(GS_RGBA16F, GS_ZS_NONE);
+        if (!*target) return false;
+    }
+    
+    gs_eparam_t *size_param = gs_effect_get_param_by_name(overlay_effect, "scope_size");
+    gs_eparam_t *chroma_param = gs_effect_get_param_by_name(overlay_effect, "scope_chroma_scale");
+    if (!size_param || !chroma_param) return false;
+    
+    gs_texrender_reset(*target);
+    if (!gs_texrender_begin(*target, width, height)) return false;
+    
+    struct vec4 clear_color;
+    vec4_zero(&clear_color);
+    gs_clear(GS_CLEAR_COLOR, &clear_color, 0.0f, 0);
+    gs_ortho(0.0f, (float)width, 0.0f, (float)height, -100.0f, 100.0f);
+    
+    struct vec2 size;
+    vec2_set(&size, (float)width, (float)height);
+    gs_effect_set_vec2(size_param, &size);
+    gs_effect_set_float(chroma_param, SCOPE_CHROMA_SCALE);
+    
+    gs_blend_state_push();
+    gs_enable_blending(true);
+    gs_blend_function(GS_BLEND_ONE, GS_BLEND_ONE);
+    
+    gs_load_vertexbuffer(ctx->scope_points);
+    gs_load_indexbuffer(NULL);
+    while (gs_effect_loop(overlay_effect, technique)) {
+        gs_draw(GS_POINTS, 0, SCOPE_SAMPLES_X * SCOPE_SAMPLES_Y);
+    }
+    
+    gs_blend_state_pop();
+    gs_texrender_end(*target);
+    return true;
+}
+
+// Samples the canvas every SCOPE_REFRESH_NS; each sample grid that arrives is
+// scattered into the traces once and then only composited
+static void update_scopes(struct design_overlay_data *ctx, uint32_t cx, uint32_t cy)
+{
+    if (!ctx->scope_texrender) {
+        ctx->scope_texrender = gs_texrender_create(GS_RGBA, GS_ZS_NONE);
+        if (!ctx->scope_texrender) return;
+    }
+    if (!ctx->scope_points) {
+        ctx->scope_points = create_scope_points();
+        if (!ctx->scope_points) return;
+    }
+    
+    const uint64_t now = os_gettime_ns();
+    if (now - ctx->scope_last_ns >= SCOPE_REFRESH_NS &&
+        capture_canvas_region(ctx->scope_texrender, 0.0f, 0.0f, (float)cx, (float)cy, SCOPE_SAMPLES_X,
+                              SCOPE_SAMPLES_Y)) {
+        readback_ring_stage(&ctx->scope_ring, gs_texrender_get_texture(ctx->scope_texrender));
+        ctx->scope_last_ns = now;
+    }
+    
+    readback_ring_collect(&ctx->scope_ring, scope_readback, ctx);
+    if (!ctx->scope_points_dirty) return;
+    
+    gs_vertexbuffer_flush(ctx->scope_points);
+    ctx->scope_points_dirty = false;
+    
+    if (ctx->cfg->scope_type & SCOPE_WAVEFORM) {
+        accumulate_scope(ctx, &ctx->waveform_texrender, "WaveformScatter", SCOPE_SAMPLES_X,
+                         SCOPE_WAVEFORM_LEVELS);
+    }
+    if (ctx->cfg->scope_type & SCOPE_VECTORSCOPE) {
+        accumulate_scope(ctx, &ctx->vectorscope_texrender, "VectorscopeScatter", SCOPE_VECTOR_SIZE,
+                         SCOPE_VECTOR_SIZE);
+    }
+}
+
+// Top-right corner of the safe zone, the vectorscope outermost. The waveform
+// panel is twice as wide as it is tall.
+static void get_scope_panels(const struct design_overlay_data *ctx, float *waveform_x, float *vector_x,
+                             float *y, float *size)
+{
+    const struct overlay_layout *layout = &ctx->cfg->layout;
+    const float scale = (float)ctx->cfg->canvas_height / 1080.0f;
+    const float gap = floorf(8.0f * scale);
+    
+    *size = floorf(SCOPE_PANEL_SIZE * scale);
+    *y = layout->safe_y + gap;
+    
+    float right = layout->safe_x + layout->safe_w - gap;
+    *vector_x = right - *size;
+    if (ctx->cfg->scope_type & SCOPE_VECTORSCOPE) {
+        right = *vector_x - gap;
+    }
+    *waveform_x = right - *size * 2.0f;
+}
+
+// Vectorscope position of an encoded RGB color, 0-1 across the panel (as VSVectorscope)
+static void scope_chroma_point(float r, float g, float b, float *x, float *y)
+{
+    const float luma = 0.2126f * r + 0.7152f * g + 0.0722f * b;
+    *x = 0.5f + (b - luma) / 1.8556f * SCOPE_CHROMA_SCALE;
+    *y = 0.5f - (r - luma) / 1.5748f * SCOPE_CHROMA_SCALE;
+}
+
+static void draw_scope_panel(struct design_overlay_data *ctx, gs_texrender_t *target, float gain, float x,
+                             float y, float width, float height)
+{
+    gs_texture_t *tex = target ? gs_texrender_get_texture(target) : NULL;
+    gs_eparam_t *image_param = gs_effect_get_param_by_name(overlay_effect, "scope_image");
+    if (!tex || !image_param) return;
+    
+    gs_effect_set_texture(image_param, tex);
+    count_uniform(ctx);
+    set_effect_float(ctx, "scope_gain", gain);
+    
+    gs_matrix_push();
+    gs_matrix_translate3f(x, y, 0.0f);
+    while (gs_effect_loop(overlay_effect, "Scope")) {
+        gs_draw_sprite(NULL, 0, (uint32_t)width, (uint32_t)height);
+        count_draw(ctx, 4);
+    }
+    gs_matrix_pop();
+}
+
+// Accumulated traces, stretched over their panels
+static void draw_scope_images(struct design_overlay_data *ctx)
+{
+    float waveform_x, vector_x, y, size;
+    get_scope_panels(ctx, &waveform_x, &vector_x, &y, &size);
+    
+    if (ctx->cfg->scope_type & SCOPE_WAVEFORM) {
+        draw_scope_panel(ctx, ctx->waveform_texrender, SCOPE_WAVEFORM_GAIN, waveform_x, y, size * 2.0f, size);
+    }
+    if (ctx->cfg->scope_type & SCOPE_VECTORSCOPE) {
+        draw_scope_panel(ctx, ctx->vectorscope_texrender, SCOPE_VECTOR_GAIN, vector_x, y, size, size);
+    }
+}
+
+// Panel frames, waveform levels every 25 %, the full-chroma circle, 75 % color
+// bar targets and the skin tone line
+static void draw_scope_graticules(struct design_overlay_data *ctx)
+{
+    float waveform_x, vector_x, y, size;
+    get_scope_panels(ctx, &waveform_x, &vector_x, &y, &size);
+    
+    const uint32_t color = COLOR_GUIDE_GRAY;
+    const float opacity = 0.8f;
+    const float text_h = floorf(size / 16.0f);
+    
+    struct overlay_prim_list *list = &ctx->scope_prims;
+    overlay_prims_clear(list);
+    
+    if (ctx->cfg->scope_type & SCOPE_WAVEFORM) {
+        const float width = size * 2.0f;
+        add_rect_outline(list, waveform_x, y, width, size, color, opacity);
+        for (int level = 1; level < 4; level++) {
+            const float ly = y + size * (float)level / 4.0f;
+            overlay_prims_add_line(list, waveform_x, ly, waveform_x + width, ly, color, opacity * 0.4f);
+        }
+        const float scale = label_scale_for_height(text_h);
+        overlay_prims_add_label(list, waveform_x + 4.0f, y + 4.0f, scale, OVERLAY_ALIGN_LEFT, color, opacity,
+                                "100");
+        overlay_prims_add_label(list, waveform_x + 4.0f, y + size - scale * TEXT_GLYPH_HEIGHT - 4.0f, scale,
+                                OVERLAY_ALIGN_LEFT, color, opacity, "0");
+    }
+    
+    if (ctx->cfg->scope_type & SCOPE_VECTORSCOPE) {
+        static const float bars[6][3] = {
+            {0.75f, 0.0f, 0.0f}, {0.75f, 0.75f, 0.0f}, {0.0f, 0.75f, 0.0f},
+            {0.0f, 0.75f, 0.75f}, {0.0f, 0.0f, 0.75f}, {0.75f, 0.0f, 0.75f},
+        };
+        const float cx = vector_x + size / 2.0f;
+        const float cy = y + size / 2.0f;
+        const float radius = size * 0.5f * SCOPE_CHROMA_SCALE;
+        const int segments = 64;
+        
+        add_rect_outline(list, vector_x, y, size, size, color, opacity);
+        overlay_prims_add_line(list, vector_x, cy, vector_x + size, cy, color, opacity * 0.4f);
+        overlay_prims_add_line(list, cx, y, cx, y + size, color, opacity * 0.4f);
+        
+        for (int i = 0; i < segments; i++) {
+            const float a0 = 6.2831853f * (float)i / (float)segments;
+            const float a1 = 6.2831853f * (float)(i + 1) / (float)segments;
+            overlay_prims_add_line(list, cx + cosf(a0) * radius, cy + sinf(a0) * radius,
+                                   cx + cosf(a1) * radius, cy + sinf(a1) * radius, color, opacity * 0.6f);
+        }
+        
+        const float box = floorf(size / 32.0f);
+        for (int i = 0; i < 6; i++) {
+            float bx, by;
+            scope_chroma_point(bars[i][0], bars[i][1], bars[i][2], &bx, &by);
+            const uint32_t bar_color = 0xFF000000 | ((bars[i][0] > 0.0f) ? 0xFF0000 : 0) |
+                                       ((bars[i][1] > 0.0f) ? 0x00FF00 : 0) | ((bars[i][2] > 0.0f) ? 0x0000FF : 0);
+            add_rect_outline(list, vector_x + bx * size - box, y + by * size - box, box * 2.0f, box * 2.0f,
+                             bar_color, opacity);
+        }
+        
+        // Runs from the center through a typical skin tone to the circle
+        float sx, sy;
+        scope_chroma_point(0.87f, 0.68f, 0.55f, &sx, &sy);
+        const float dx = sx - 0.5f;
+        const float dy = sy - 0.5f;
+        const float length = sqrtf(dx * dx + dy * dy);
+        if (length > 0.0f) {
+            overlay_prims_add_line(list, cx, cy, cx + dx / length * radius, cy + dy / length * radius, color,
+                                   opacity * 0.6f);
+        }
+    }
+    
+    draw_prims_immediate(ctx, list);
+}
+
+// ============================================================================
+// Layer hotkeys
+// ============================================================================
+
+// Any thread; the next render picks the bit up
+static void layer_hotkey_pressed(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed)
+{
+    struct design_overlay_data *ctx = data;
+    
+    UNUSED_PARAMETER(hotkey);
+    if (!pressed) return;
+    
+    for (int i = 0; i < OVERLAY_LAYER_COUNT; i++) {
+        if (ctx->layer_hotkeys[i] != id) continue;
+        
+        const long toggles = overlay_atomic_xor_long(&ctx->layer_toggles, (long)OVERLAY_LAYER_BIT(i));
+        blog(LOG_DEBUG, "[Design Overlay] %s toggled (mask 0x%02lx)", layer_names[i],
+             toggles ^ (long)OVERLAY_LAYER_BIT(i));
+        break;
+    }
+}
+
+// Properties with the hotkey toggles applied, limited to layers the geometry holds
+static uint32_t visible_layers(const struct design_overlay_data *ctx)
+{
+    const uint32_t toggles = (uint32_t)os_atomic_load_long(&ctx->layer_toggles);
+    return (ctx->cfg->layer_mask ^ toggles) & ctx->cfg->build_mask;
+}
+
+// ============================================================================
+// Pixel loupe
+// ============================================================================
+
+// Moves the loupe on the context and writes the position back to the source
+// settings so it is saved, without a full update (which would re-read the
+// layout and the reference image on every press)
+static void loupe_hotkey_pressed(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed)
+{
+    struct design_overlay_data *ctx = data;
+    
+    UNUSED_PARAMETER(hotkey);
+    if (!pressed) return;
+    
+    for (int i = 0; i < LOUPE_MOVE_COUNT; i++) {
+        if (ctx->loupe_hotkeys[i] != id) continue;
+        
+        const long width = os_atomic_load_long(&ctx->width);
+        const long height = os_atomic_load_long(&ctx->height);
+        long x = os_atomic_load_long(&ctx->loupe_x) + loupe_moves[i].dx;
+        long y = os_atomic_load_long(&ctx->loupe_y) + loupe_moves[i].dy;
+        
+        if (x > width - 1) x = width - 1;
+        if (y > height - 1) y = height - 1;
+        if (x < 0) x = 0;
+        if (y < 0) y = 0;
+        
+        os_atomic_set_long(&ctx->loupe_x, x);
+        os_atomic_set_long(&ctx->loupe_y, y);
+        
+        obs_data_t *settings = obs_source_get_settings(ctx->source);
+        obs_data_set_int(settings, "loupe_x", x);
+        obs_data_set_int(settings, "loupe_y", y);
+        obs_data_release(settings);
+        break;
+    }
+}
+
+// Sampled region and the enlarged panel, which sits right of the region
+// unless that leaves the canvas
+static void get_loupe_rect(const struct design_overlay_data *ctx, float *x, float *y, float *size,
+                           float *panel_x, float *panel_y, float *panel_size)
+{
+    const float canvas_w = (float)ctx->cfg->canvas_width;
+    const float canvas_h = (float)ctx->cfg->canvas_height;
+    
+    *size = (float)ctx->cfg->loupe_size;
+    *x = floorf((float)os_atomic_load_long(&ctx->loupe_x) - *size / 2.0f);
+    *y = floorf((float)os_atomic_load_long(&ctx->loupe_y) - *size / 2.0f);
+    *panel_size = *size * (float)ctx->cfg->loupe_zoom;
+    
+    *panel_x = *x + *size + 16.0f;
+    if (*panel_x + *panel_size > canvas_w) *panel_x = *x - 16.0f - *panel_size;
+    *panel_y = floorf(*y + *size / 2.0f - *panel_size / 2.0f);
+    if (*panel_y + *panel_size > canvas_h) *panel_y = canvas_h - *panel_size;
+    if (*panel_y < 0.0f) *panel_y = 0.0f;
+}
+
+static void free_loupe_capture(struct design_overlay_data *ctx)
+{
+    gs_texture_destroy(ctx->loupe_texture);
+    ctx->loupe_texture = NULL;
+    ctx->loupe_ready = false;
+}
+
+// Crops the program pixels under the loupe from the shared frame every frame;
+// the copy is only a few pixels across
+static void update_loupe_capture(struct design_overlay_data *ctx, uint32_t cx, uint32_t cy)
+{
+    float x, y, size, panel_x, panel_y, panel_size;
+    get_loupe_rect(ctx, &x, &y, &size, &panel_x, &panel_y, &panel_size);
+    const float scale_x = (float)cx / (float)ctx->cfg->canvas_width;
+    const float scale_y = (float)cy / (float)ctx->cfg->canvas_height;
+    const float width = fmaxf(roundf(size * scale_x), 1.0f);
+    const float height = fmaxf(roundf(size * scale_y), 1.0f);
+    
+    ctx->loupe_ready = capture_copy_region(&ctx->loupe_texture, (int)floorf(x * scale_x),
+                                           (int)floorf(y * scale_y), (uint32_t)width, (uint32_t)height);
+}
+
+// Point-sampled quad, the pixel grid comes from the shader
+static void draw_loupe_image(struct design_overlay_data *ctx)
+{
+    gs_texture_t *tex = ctx->loupe_texture;
+    gs_eparam_t *image_param = gs_effect_get_param_by_name(overlay_effect, "canvas_image");
+    if (!tex || !image_param) return;
+    
+    float x, y, size, panel_x, panel_y, panel_size;
+    get_loupe_rect(ctx, &x, &y, &size, &panel_x, &panel_y, &panel_size);
+    
+    struct vec4 grid_color;
+    color_to_vec4(&grid_color, COLOR_GUIDE_GRAY, 0.35f);
+    
+    gs_effect_set_texture(image_param, tex);
+    count_uniform(ctx);
+    // The grid follows the program pixels, which differ from canvas pixels when scaled
+    set_effect_float(ctx, "loupe_pixels", (float)gs_texture_get_width(tex));
+    set_effect_vec4(ctx, "loupe_grid_color", &grid_color);
+    
+    gs_matrix_push();
+    gs_matrix_translate3f(panel_x, panel_y, 0.0f);
+    while (gs_effect_loop(overlay_effect, "Loupe")) {
+        gs_draw_sprite(NULL, 0, (uint32_t)panel_size, (uint32_t)panel_size);
+        count_draw(ctx, 4);
+    }
+    gs_matrix_pop();
+}
+
+// Region outline, panel frame and the crosshair marker on the center pixel
+static void draw_loupe_marker(struct design_overlay_data *ctx)
+{
+    float x, y, size, panel_x, panel_y, panel_size;
+    get_loupe_rect(ctx, &x, &y, &size, &panel_x, &panel_y, &panel_size);
+    
+    const uint32_t color = COLOR_CROSSHAIR_YELLOW;
+    const float opacity = ctx->cfg->crosshair_opacity;
+    const float zoom = (float)ctx->cfg->loupe_zoom;
+    const float center = floorf(size / 2.0f) * zoom;
+    
+    struct overlay_prim_list *list = &ctx->loupe_prims;
+    overlay_prims_clear(list);
+    
+    add_rect_outline(list, x - 1.0f, y - 1.0f, size + 2.0f, size + 2.0f, color, opacity);
+    add_rect_outline(list, panel_x - 1.0f, panel_y - 1.0f, panel_size + 2.0f, panel_size + 2.0f, color,
+                     opacity);
+    add_rect_outline(list, panel_x + center, panel_y + center, zoom, zoom, color, opacity);
+    geometry_crosshair_marker(list, panel_x + center + zoom / 2.0f, panel_y + center + zoom / 2.0f,
+                              panel_size * 0.35f, opacity * 0.6f);
+    
+    draw_prims_immediate(ctx, list);
+}
+
+// ============================================================================
+// Screenshot export
+// ============================================================================
+
+static void export_hotkey_pressed(void *data, obs_hotkey_id id, obs_hotkey_t *hotkey, bool pressed)
+{
+    struct design_overlay_data *ctx = data;
+    
+    UNUSED_PARAMETER(id);
+    UNUSED_PARAMETER(hotkey);
+    
+    if (pressed) {
+        os_atomic_set_bool(&ctx->export_requested, true);
+    }
+}
+
+static bool export_button_clicked(obs_properties_t *props, obs_property_t *property, void *data)
+{
+    struct design_overlay_data *ctx = data;
+    
+    UNUSED_PARAMETER(props);
+    UNUSED_PARAMETER(property);
+    
+    os_atomic_set_bool(&ctx->export_requested, true);
+    return false;
+}
+
+// Runs on the graphics thread; encoding and disk I/O happen on the export worker
+static void export_readback(void *param, const uint8_t *data, uint32_t linesize,
+                            uint32_t width, uint32_t height)
+{
+    struct design_overlay_data *ctx = param;
+    
+    if (!exporter_submit(ctx->exporter, data, linesize, width, height, &ctx->export_request)) {
+        blog(LOG_WARNING, "[Design Overlay] Export skipped, %d exports still pending", EXPORT_MAX_QUEUED);
+    }
+    ctx->export_waiting = false;
+}
+
+static void free_export_capture(struct design_overlay_data *ctx)
+{
+    gs_texrender_destroy(ctx->export_texrender);
+    ctx->export_texrender = NULL;
+    readback_ring_free(&ctx->export_ring);
+}
+
+static void start_export(struct design_overlay_data *ctx, uint32_t cx, uint32_t cy)
+{
+    if (!ctx->exporter) {
+        ctx->exporter = exporter_create();
+        if (!ctx->exporter) return;
+    }
+    if (!ctx->export_texrender) {
+        ctx->export_texrender = gs_texrender_create(GS_RGBA, GS_ZS_NONE);
+        if (!ctx->export_texrender) return;
+    }
+    
+    // Captured at overlay canvas size so the annotation lines up pixel for pixel
+    if (!capture_canvas_region(ctx->export_texrender, 0.0f, 0.0f, (float)cx, (float)cy,
+                               ctx->cfg->canvas_width, ctx->cfg->canvas_height)) {
+        return;
+    }
+    if (!readback_ring_stage(&ctx->export_ring, gs_texrender_get_texture(ctx->export_texrender))) {
+        blog(LOG_WARNING, "[Design Overlay] Export failed: could not stage the canvas");
+        return;
+    }
+    
+    bfree(ctx->export_directory);
+    if (ctx->cfg->export_path && *ctx->cfg->export_path) {
+        ctx->export_directory = bstrdup(ctx->cfg->export_path);
+    } else {
+        ctx->export_directory = obs_module_config_path("screenshots");
+    }
+    
+    layout_file_release(ctx->export_layout);
+    ctx->export_layout = ctx->cfg->custom_layout;
+    layout_file_addref(ctx->export_layout);
+    
+    ctx->export_request.params = ctx->cfg->params;
+    ctx->export_request.layer_mask = visible_layers(ctx);
+    ctx->export_request.directory = ctx->export_directory;
+    ctx->export_waiting = true;
+    ctx->export_wait_frames = 0;
+}
+
+static void update_export(struct design_overlay_data *ctx, uint32_t cx, uint32_t cy)
+{
+    if (!ctx->export_waiting && os_atomic_exchange_bool(&ctx->export_requested, false)) {
+        start_export(ctx, cx, cy);
+    }
+    
+    if (ctx->export_waiting && !readback_ring_collect(&ctx->export_ring, export_readback, ctx) &&
+        ++ctx->export_wait_frames > READBACK_RING_SIZE * 2) {
+        blog(LOG_WARNING, "[Design Overlay] Export failed: canvas readback did not complete");
+        ctx->export_waiting = false;
+    }
+    
+    // Full-canvas staging surfaces are only kept while an export is in flight
+    if (!ctx->export_waiting && ctx->export_texrender) {
+        free_export_capture(ctx);
+        layout_file_release(ctx->export_layout);
+        ctx->export_layout = NULL;
+    }
+}
+
+// ============================================================================
+// Dynamic layers
+// ============================================================================
+
+static void draw_dynamic_layers(struct design_overlay_data *ctx)
+{
+    gs_effect_t *solid_effect = obs_get_base_effect(OBS_EFFECT_SOLID);
+    gs_eparam_t *color_param = gs_effect_get_param_by_name(solid_effect, "color");
+    gs_technique_t *tech = gs_effect_get_technique(solid_effect, "SolidColored");
+    if (!color_param || !tech) return;
+    
+    struct vec4 white;
+    vec4_set(&white, 1.0f, 1.0f, 1.0f, 1.0f);
+    gs_effect_set_vec4(color_param, &white);
+    count_uniform(ctx);
+    
+    gs_blend_state_push();
+    gs_enable_blending(true);
+    gs_blend_function(GS_BLEND_SRCALPHA, GS_BLEND_INVSRCALPHA);
+    
+    // The loupe image has its own technique, so it goes before the solid pass
+    const bool loupe = ctx->cfg->show_loupe && ctx->loupe_ready && overlay_effect;
+    if (loupe) {
+        draw_loupe_image(ctx);
+    }
+    
+    const bool scopes = ctx->cfg->show_scopes && overlay_effect;
+    if (scopes) {
+        draw_scope_images(ctx);
+    }
+    
+    gs_technique_begin(tech);
+    gs_technique_begin_pass(tech, 0);
+    
+    if (ctx->cfg->show_grid_analyzer && ctx->analyzer) {
+        draw_grid_analyzer(ctx);
+    }
+    
+    if (ctx->cfg->show_reference && ctx->reference_scored) {
+        draw_reference_tiles(ctx);
+    }
+    
+    if (ctx->cfg->show_palette && ctx->palette) {
+        draw_palette(ctx);
+    }
+    
+    if (ctx->cfg->show_color_picker) {
+        draw_color_picker(ctx);
+    }
+    
+    if (loupe) {
+        draw_loupe_marker(ctx);
+    }
+    
+    if (scopes) {
+        draw_scope_graticules(ctx);
+    }
+    
+    gs_technique_end_pass(tech);
+    gs_technique_end(tech);
+    
+    // Value labels, from the lists the solid pass just filled
+    if (ctx->cfg->show_reference && ctx->reference_scored) {
+        draw_prim_labels(ctx, &ctx->reference_prims);
+    }
+    if (ctx->cfg->show_palette && ctx->palette) {
+        draw_prim_labels(ctx, &ctx->palette_prims);
+    }
+    if (ctx->cfg->show_color_picker) {
+        draw_prim_labels(ctx, &ctx->picker_prims);
+    }
+    if (scopes) {
+        draw_prim_labels(ctx, &ctx->scope_prims);
+    }
+    
+    gs_blend_state_pop();
+}
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+// Geometry of either mode, or the filter's copy of its parent
+static bool has_render_resources(const struct design_overlay_data *ctx)
+{
+    return ctx->geometry || ctx->breakpoint_geometry[0] || ctx->parent_texrender;
+}
+
+// Graphics thread. The geometry (and texture cache) is rebuilt or re-shared by
+// the first render after the source is shown again.
+static void release_render_resources(struct design_overlay_data *ctx)
+{
+    shared_geometry_release(ctx->geometry);
+    ctx->geometry = NULL;
+    for (int i = 0; i < BREAKPOINT_COUNT; i++) {
+        shared_geometry_release(ctx->breakpoint_geometry[i]);
+        ctx->breakpoint_geometry[i] = NULL;
+    }
+    gs_texrender_destroy(ctx->parent_texrender);
+    ctx->parent_texrender = NULL;
+    ctx->needs_redraw = true;
+    
+    blog(LOG_DEBUG, "[Design Overlay] '%s' hidden, released its geometry (%zu configurations cached)",
+         obs_source_get_name(ctx->source), shared_geometry_count());
+}
+
+static bool has_capture_resources(const struct design_overlay_data *ctx)
+{
+    return ctx->picker_texture || ctx->analyzer || ctx->analyzer_texrender || ctx->palette ||
+           ctx->palette_texrender || ctx->canvas_texrender || ctx->reference_reduce[0] ||
+           ctx->loupe_texture || ctx->scope_texrender || ctx->export_texrender;
+}
+
+// Graphics thread. Capture tools start over on the next activation; an export
+// still waiting for its readback is dropped.
+static void release_capture_resources(struct design_overlay_data *ctx)
+{
+    free_picker(ctx);
+    free_analyzer_capture(ctx);
+    analyzer_destroy(ctx->analyzer);
+    ctx->analyzer = NULL;
+    ctx->analyzer_last_ns = 0;
+    free_palette_capture(ctx);
+    palette_destroy(ctx->palette);
+    ctx->palette = NULL;
+    ctx->palette_last_ns = 0;
+    free_canvas_copy(ctx);
+    free_reference_capture(ctx);
+    free_loupe_capture(ctx);
+    free_scope_capture(ctx);
+    
+    if (ctx->export_waiting) {
+        blog(LOG_WARNING, "[Design Overlay] Export of '%s' dropped, the source was deactivated",
+             obs_source_get_name(ctx->source));
+        ctx->export_waiting = false;
+    }
+    free_export_capture(ctx);
+    layout_file_release(ctx->export_layout);
+    ctx->export_layout = NULL;
+}
+
+// ============================================================================
+// Render callbacks
+// ============================================================================
+
+// Output pixels per canvas pixel for this draw: the source transform, then the output ratio
+static float effective_output_scale(const struct design_overlay_data *ctx)
+{
+    struct matrix4 m;
+    gs_matrix_get(&m);
+    
+    const float sx = sqrtf(m.x.x * m.x.x + m.x.y * m.x.y);
+    const float sy = sqrtf(m.y.x * m.y.x + m.y.y * m.y.y);
+    return fminf(sx, sy) * ctx->output_ratio;
+}
+
+// Smallest power-of-two step that keeps grid lines GRID_LOD_MIN_SPACING output pixels apart
+static int grid_lod_for_scale(const struct design_overlay_data *ctx, float scale)
+{
+    const float spacing = (float)ctx->cfg->material_grid_size * scale;
+    int lod = 1;
+    while (lod < GRID_LOD_MAX && spacing * (float)lod < GRID_LOD_MIN_SPACING) lod *= 2;
+    return lod;
+}
+
+// Whether the lines halfway between the majors of a coarser level are still
+// GRID_LOD_MIN_SPACING output pixels apart
+static bool grid_halfway_for_scale(const struct design_overlay_data *ctx, int lod, float scale)
+{
+    const float spacing = (float)ctx->cfg->material_grid_size * scale;
+    return lod > 1 && spacing * (float)(lod / 2) >= GRID_LOD_MIN_SPACING;
+}
+
+// Records the level a render at this scale needs; the next tick rebuilds if it changed
+static void observe_grid_lod(const struct design_overlay_data *ctx, struct grid_lod_state *state, float scale)
+{
+    const int lod = grid_lod_for_scale(ctx, scale);
+    const bool halfway = grid_halfway_for_scale(ctx, lod, scale);
+    if (!state->seen || lod < state->seen) {
+        state->seen = lod;
+        state->halfway_seen = halfway;
+    } else if (lod == state->seen) {
+        state->halfway_seen |= halfway;
+    }
+}
+
+// Responsive preview: one cache entry per viewport, so instances previewing
+// the same settings share them like any other geometry
+static void rebuild_breakpoint_geometry(struct design_overlay_data *ctx)
+{
+    for (int i = 0; i < BREAKPOINT_COUNT; i++) {
+        struct overlay_params params = ctx->cfg->tiles[i].params;
+        params.grid_lod = ctx->breakpoint_lod[i].lod;
+        params.grid_halfway = ctx->breakpoint_lod[i].halfway;
+        
+        struct geometry_key key;
+        geometry_key_init(&key, &params, ctx->cfg->build_mask, 0, 0.0f);
+        
+        bool created;
+        struct shared_geometry *geometry = shared_geometry_acquire(&key, &created);
+        if (created) {
+            build_shared_geometry(geometry);
+        }
+        
+        shared_geometry_release(ctx->breakpoint_geometry[i]);
+        ctx->breakpoint_geometry[i] = geometry;
+    }
+    
+    ctx->needs_redraw = false;
+}
+
+static void release_breakpoint_geometry(struct design_overlay_data *ctx)
+{
+    for (int i = 0; i < BREAKPOINT_COUNT; i++) {
+        shared_geometry_release(ctx->breakpoint_geometry[i]);
+        ctx->breakpoint_geometry[i] = NULL;
+    }
+}
+
+// The filter's parent, or the program copy for the source
+static gs_texture_t *breakpoint_content(const struct design_overlay_data *ctx)
+{
+    if (ctx->is_filter) {
+        return ctx->parent_texrender ? gs_texrender_get_texture(ctx->parent_texrender) : NULL;
+    }
+    return ctx->canvas_copy_ready ? gs_texrender_get_texture(ctx->canvas_texrender) : NULL;
+}
+
+// Dims everything around the tiles
+static void draw_breakpoint_backdrop(struct design_overlay_data *ctx)
+{
+    gs_effect_t *solid_effect = obs_get_base_effect(OBS_EFFECT_SOLID);
+    gs_eparam_t *color_param = gs_effect_get_param_by_name(solid_effect, "color");
+    if (!color_param) return;
+    
+    struct vec4 backdrop;
+    color_to_vec4(&backdrop, 0xFF141414, 0.92f);
+    gs_effect_set_vec4(color_param, &backdrop);
+    count_uniform(ctx);
+    
+    while (gs_effect_loop(solid_effect, "Solid")) {
+        gs_draw_sprite(NULL, 0, ctx->cfg->canvas_width, ctx->cfg->canvas_height);
+        count_draw(ctx, 4);
+    }
+}
+
+// Content cropped to each viewport's aspect ratio and scaled to fill it, one effect loop for all tiles
+static void draw_breakpoint_content(struct design_overlay_data *ctx, gs_texture_t *tex)
+{
+    const float content_w = (float)gs_texture_get_width(tex);
+    const float content_h = (float)gs_texture_get_height(tex);
+    if (content_w <= 0.0f || content_h <= 0.0f) return;
+    
+    gs_effect_t *default_effect = obs_get_base_effect(OBS_EFFECT_DEFAULT);
+    gs_eparam_t *image_param = gs_effect_get_param_by_name(default_effect, "image");
+    gs_effect_set_texture(image_param, tex);
+    count_uniform(ctx);
+    
+    while (gs_effect_loop(default_effect, "Draw")) {
+        for (int i = 0; i < BREAKPOINT_COUNT; i++) {
+            const struct breakpoint_tile *tile = &ctx->cfg->tiles[i];
+            const float view_w = (float)breakpoints[i].width;
+            const float view_h = (float)breakpoints[i].height;
+            
+            // Crop whichever side of the content is too long for the viewport
+            float src_w = content_w;
+            float src_h = content_w * view_h / view_w;
+            if (src_h > content_h) {
+                src_h = content_h;
+                src_w = content_h * view_w / view_h;
+            }
+            const float scale = view_w * tile->scale / src_w;
+            
+            gs_matrix_push();
+            gs_matrix_translate3f(tile->x, tile->y, 0.0f);
+            gs_matrix_scale3f(scale, scale, 1.0f);
+            gs_draw_sprite_subregion(tex, 0, (uint32_t)((content_w - src_w) / 2.0f),
+                                     (uint32_t)((content_h - src_h) / 2.0f), (uint32_t)src_w, (uint32_t)src_h);
+            gs_matrix_pop();
+            count_draw(ctx, 4);
+        }
+    }
+}
+
+// Every viewport's shared line buffer, then the tile frames and width labels, in one solid pass
+static void draw_breakpoint_guides(struct design_overlay_data *ctx)
+{
+    gs_effect_t *solid_effect = obs_get_base_effect(OBS_EFFECT_SOLID);
+    gs_eparam_t *color_param = gs_effect_get_param_by_name(solid_effect, "color");
+    gs_technique_t *tech = gs_effect_get_technique(solid_effect, "SolidColored");
+    if (!color_param || !tech) return;
+    
+    struct vec4 white;
+    vec4_set(&white, 1.0f, 1.0f, 1.0f, 1.0f);
+    gs_effect_set_vec4(color_param, &white);
+    count_uniform(ctx);
+    
+    const uint32_t color = COLOR_GUIDE_GRAY;
+    const float text_h = floorf(14.0f * (float)ctx->cfg->canvas_height / 1080.0f);
+    struct overlay_prim_list *list = &ctx->breakpoint_prims;
+    overlay_prims_clear(list);
+    
+    gs_technique_begin(tech);
+    gs_technique_begin_pass(tech, 0);
+    
+    for (int i = 0; i < BREAKPOINT_COUNT; i++) {
+        const struct breakpoint_tile *tile = &ctx->cfg->tiles[i];
+        const struct shared_geometry *geometry = ctx->breakpoint_geometry[i];
+        
+        if (geometry && geometry->line_vb) {
+            struct layer_segment runs[OVERLAY_LAYER_COUNT];
+            const size_t run_count = visible_segments(geometry->line_segments, ctx->layers, runs);
+            
+            gs_matrix_push();
+            gs_matrix_translate3f(tile->x, tile->y, 0.0f);
+            gs_matrix_scale3f(tile->scale, tile->scale, 1.0f);
+            gs_load_vertexbuffer(geometry->line_vb);
+            gs_load_indexbuffer(NULL);
+            for (size_t r = 0; r < run_count; r++) {
+                gs_draw(GS_LINES, runs[r].first, runs[r].count);
+                count_draw(ctx, runs[r].count);
+            }
+            gs_matrix_pop();
+        }
+        
+        add_rect_outline(list, tile->x, tile->y, (float)breakpoints[i].width * tile->scale,
+                         (float)breakpoints[i].height * tile->scale, color, 1.0f);
+        overlay_prims_add_label(list, tile->x, tile->y - text_h - 6.0f, label_scale_for_height(text_h),
+                                OVERLAY_ALIGN_LEFT, color, 1.0f, "%u", breakpoints[i].width);
+    }
+    
+    draw_prims_immediate(ctx, list);
+    
+    gs_technique_end_pass(tech);
+    gs_technique_end(tech);
+    
+    draw_prim_labels(ctx, list);
+}
+
+// Replaces the regular layers while the preview is on
+static void render_breakpoints(struct design_overlay_data *ctx)
+{
+    // Each tile is scaled down by its own factor, so each keeps its own level
+    if (ctx->layers & OVERLAY_LAYER_BIT(OVERLAY_LAYER_MATERIAL_GRID)) {
+        const float scale = effective_output_scale(ctx);
+        for (int i = 0; i < BREAKPOINT_COUNT; i++) {
+            observe_grid_lod(ctx, &ctx->breakpoint_lod[i], scale * ctx->cfg->tiles[i].scale);
+        }
+    }
+    
+    if (ctx->needs_redraw) {
+        rebuild_breakpoint_geometry(ctx);
+    }
+    
+    gs_blend_state_push();
+    gs_enable_blending(true);
+    gs_blend_function(GS_BLEND_SRCALPHA, GS_BLEND_INVSRCALPHA);
+    
+    draw_breakpoint_backdrop(ctx);
+    
+    gs_texture_t *content = breakpoint_content(ctx);
+    if (content) {
+        draw_breakpoint_content(ctx, content);
+    }
+    
+    draw_breakpoint_guides(ctx);
+    
+    gs_blend_state_pop();
+}
+
+static void render_overlay(struct design_overlay_data *ctx)
+{
+    // Read once so every pass of the frame agrees
+    ctx->layers = visible_layers(ctx);
+    
+    if (ctx->cfg->show_breakpoints) {
+        render_breakpoints(ctx);
+        return;
+    }
+    if (ctx->breakpoint_geometry[0]) {
+        release_breakpoint_geometry(ctx);
+    }
+    
+    // The shader grid adapts per pixel; the geometry grid is rebuilt by the next tick
+    if ((ctx->layers & OVERLAY_LAYER_BIT(OVERLAY_LAYER_MATERIAL_GRID)) && !grid_shader_active(ctx)) {
+        observe_grid_lod(ctx, &ctx->grid_lod, effective_output_scale(ctx));
+    }
+    
+    if (ctx->needs_redraw) {
+        rebuild_geometry(ctx);
+    }
+    
+    // Under the guides so they stay readable on top
+    if (ctx->cfg->show_reference && ctx->cfg->reference && overlay_effect) {
+        profile_start("draw_reference_image");
+        draw_reference_image(ctx);
+        profile_end("draw_reference_image");
+    }
+    
+    if (ctx->cfg->show_contrast && ctx->canvas_copy_ready && overlay_effect) {
+        profile_start("draw_contrast_heatmap");
+        draw_contrast_heatmap(ctx);
+        profile_end("draw_contrast_heatmap");
+    }
+    
+    if (ctx->cfg->render_mode == RENDER_MODE_TEXTURE) {
+        render_cached(ctx);
+    } else {
+        // Clean rendering setup
+        gs_blend_state_push();
+        gs_enable_blending(true);
+        gs_blend_function(GS_BLEND_SRCALPHA, GS_BLEND_INVSRCALPHA);
+        
+        draw_overlay(ctx);
+        
+        gs_blend_state_pop();
+    }
+    
+    // Layers that change between settings updates are never cached
+    if (ctx->cfg->show_color_picker || ctx->cfg->show_grid_analyzer || ctx->cfg->show_palette ||
+        ctx->cfg->show_loupe || ctx->cfg->show_reference || ctx->cfg->show_scopes) {
+        draw_dynamic_layers(ctx);
+    }
+}
+
+static const char *video_render_name = "design_overlay_video_render";
+
+static void design_overlay_video_render(void *data, gs_effect_t *effect)
+{
+    struct design_overlay_data *ctx = data;
+    if (!ctx || capture_in_progress()) return;
+    
+    UNUSED_PARAMETER(effect);
+    
+    // Rendered without being shown (the tick skipped it), so the snapshot may be stale
+    if (!os_atomic_load_bool(&ctx->showing)) {
+        acquire_settings(ctx);
+    }
+    if (!ctx->cfg->enabled) return;
+    
+    const struct render_cost before = ctx->cost;
+    const uint64_t start_ns = os_gettime_ns();
+    
+    profile_start(video_render_name);
+    render_overlay(ctx);
+    profile_end(video_render_name);
+    
+    const uint64_t render_ns = os_gettime_ns() - start_ns;
+    ctx->cost.renders++;
+    ctx->cost.render_ns += render_ns;
+    stats_record_render(ctx, render_ns, &before);
+}
+
+// Runs once per frame after the main view, outside of any scene rendering
+static void design_overlay_main_render(void *data, uint32_t cx, uint32_t cy)
+{
+    struct design_overlay_data *ctx = data;
+    
+    // Every capture tool samples the program output, which only contains
+    // this overlay while it is active
+    if (!os_atomic_load_bool(&ctx->active)) {
+        if (os_atomic_exchange_bool(&ctx->export_requested, false)) {
+            blog(LOG_INFO, "[Design Overlay] Export skipped, '%s' is not in the program output",
+                 obs_source_get_name(ctx->source));
+        }
+        if (has_capture_resources(ctx)) {
+            release_capture_resources(ctx);
+        }
+        return;
+    }
+    
+    if (ctx->cfg->enabled && ctx->cfg->show_color_picker) {
+        profile_start("design_overlay_color_picker");
+        update_color_picker(ctx, cx, cy);
+        profile_end("design_overlay_color_picker");
+    } else if (ctx->picker_texture) {
+        free_picker(ctx);
+    }
+    
+    if (ctx->cfg->enabled && ctx->cfg->show_grid_analyzer) {
+        profile_start("design_overlay_grid_analyzer");
+        update_grid_analyzer(ctx, cx, cy);
+        profile_end("design_overlay_grid_analyzer");
+    } else if (ctx->analyzer_texrender) {
+        free_analyzer_capture(ctx);
+    }
+    
+    if (ctx->cfg->enabled && ctx->cfg->show_palette) {
+        profile_start("design_overlay_palette");
+        update_palette(ctx, cx, cy);
+        profile_end("design_overlay_palette");
+    } else if (ctx->palette_texrender) {
+        free_palette_capture(ctx);
+    }
+    
+    // Swatches are refreshed by the previous frame's draw_palette
+    pthread_mutex_lock(&ctx->publish_mutex);
+    if (ctx->shm) {
+        const bool picking = ctx->cfg->enabled && ctx->cfg->show_color_picker;
+        const bool palette = ctx->cfg->enabled && ctx->cfg->show_palette;
+        overlay_shm_publish_colors(ctx->shm, picking ? os_atomic_load_long(&ctx->picked_color) : -1,
+                                   ctx->swatches, palette ? ctx->swatch_count : 0);
+    }
+    pthread_mutex_unlock(&ctx->publish_mutex);
+    
+    // Shared by the contrast heatmap and the reference diff
+    bool canvas_refreshed = false;
+    if (canvas_copy_wanted(ctx)) {
+        profile_start("design_overlay_canvas_copy");
+        canvas_refreshed = update_canvas_copy(ctx, cx, cy);
+        profile_end("design_overlay_canvas_copy");
+    } else if (ctx->canvas_texrender) {
+        free_canvas_copy(ctx);
+    }
+    
+    if (ctx->cfg->enabled && ctx->cfg->show_reference && ctx->cfg->reference && overlay_effect) {
+        profile_start("design_overlay_reference");
+        if (canvas_refreshed) score_reference(ctx);
+        readback_ring_collect(&ctx->reference_ring, reference_readback, ctx);
+        profile_end("design_overlay_reference");
+    } else if (ctx->reference_reduce[0]) {
+        free_reference_capture(ctx);
+    }
+    
+    if (ctx->cfg->enabled && ctx->cfg->show_loupe && overlay_effect) {
+        profile_start("design_overlay_loupe");
+        update_loupe_capture(ctx, cx, cy);
+        profile_end("design_overlay_loupe");
+    } else if (ctx->loupe_texture) {
+        free_loupe_capture(ctx);
+    }
+    
+    if (ctx->cfg->enabled && ctx->cfg->show_scopes && overlay_effect) {
+        profile_start("design_overlay_scopes");
+        update_scopes(ctx, cx, cy);
+        profile_end("design_overlay_scopes");
+    } else if (ctx->scope_texrender) {
+        free_scope_capture(ctx);
+    }
+    
+    profile_start("design_overlay_export");
+    update_export(ctx, cx, cy);
+    profile_end("design_overlay_export");
+}
+
+// ============================================================================
+// Filter variant
+// ============================================================================
+
+// Parent size, or the base canvas while the filter is not attached yet
+static bool get_filter_canvas(struct design_overlay_data *ctx, uint32_t *width, uint32_t *height)
+{
+    obs_source_t *target = obs_filter_get_target(ctx->source);
+    *width = target ? obs_source_get_base_width(target) : 0;
+    *height = target ? obs_source_get_base_height(target) : 0;
+    
+    if (!*width || !*height) {
+        struct obs_video_info ovi;
+        if (!obs_get_video_info(&ovi)) return false;
+        *width = ovi.base_width;
+        *height = ovi.base_height;
+    }
+    
+    return *width > 0 && *height > 0;
+}
+
+static void *design_overlay_filter_create(obs_data_t *settings, obs_source_t *source)
+{
+    struct design_overlay_data *ctx = create_context(settings, source, true);
+    if (!ctx) {
+        return NULL;
+    }
+    
+    blog(LOG_INFO, "[Design Overlay] Overlay filter created (version %s)", PLUGIN_VERSION);
+    return ctx;
+}
+
+static obs_properties_t *design_overlay_filter_get_properties(void *data)
+{
+    obs_properties_t *props = design_overlay_get_properties(data);
+    
+    // Canvas size comes from the parent; picker, analyzer and export sample the program canvas
+    static const char *source_only[] = {
+        "canvas_header", "canvas_width", "canvas_height",
+        "picker_header", "show_color_picker", "picker_x", "picker_y", "picker_size", "pick_now",
+        "picked_color",
+        "analyzer_header", "show_grid_analyzer", "analyzer_scale", "analyzer_interval_ms",
+        "analyzer_threshold", "export_header", "export_path", "export_now",
+    };
+    for (size_t i = 0; i < sizeof(source_only) / sizeof(source_only[0]); i++) {
+        obs_properties_remove_by_name(props, source_only[i]);
+    }
+    
+    return props;
+}
+
+// Only a real size change invalidates the cached geometry
+static void design_overlay_filter_tick(void *data, float seconds)
+{
+    struct design_overlay_data *ctx = data;
+    if (!ctx) return;
+    
+    design_overlay_video_tick(data, seconds);
+    if (!os_atomic_load_bool(&ctx->showing)) return;
+    
+    uint32_t width, height;
+    if (!get_filter_canvas(ctx, &width, &height)) return;
+    
+    os_atomic_set_long(&ctx->filter_width, (long)width);
+    os_atomic_set_long(&ctx->filter_height, (long)height);
+    
+    if (width != ctx->cfg->canvas_width || height != ctx->cfg->canvas_height) {
+        blog(LOG_DEBUG, "[Design Overlay] Filter canvas %ux%u -> %ux%u", ctx->cfg->canvas_width,
+             ctx->cfg->canvas_height, width, height);
+        
+        // Replaces only the snapshot it was resized from. An update that won the
+        // race sized itself from filter_width/filter_height, or the next tick
+        // resizes it.
+        republish_settings(ctx, ctx->cfg, settings_resize(ctx->cfg, width, height));
+        acquire_settings(ctx);
+    }
+}
+
+// The responsive preview draws the parent once per tile, so it goes through a texture
+static void render_filter_parent(struct design_overlay_data *ctx)
+{
+    if (!ctx->parent_texrender) {
+        ctx->parent_texrender = gs_texrender_create(GS_RGBA, GS_ZS_NONE);
+        if (!ctx->parent_texrender) return;
+    }
+    
+    const uint32_t width = ctx->cfg->canvas_width;
+    const uint32_t height = ctx->cfg->canvas_height;
+    
+    gs_texrender_reset(ctx->parent_texrender);
+    if (!gs_texrender_begin(ctx->parent_texrender, width, height)) return;
+    
+    struct vec4 clear_color;
+    vec4_zero(&clear_color);
+    gs_clear(GS_CLEAR_COLOR, &clear_color, 0.0f, 0);
+    gs_ortho(0.0f, (float)width, 0.0f, (float)height, -100.0f, 100.0f);
+    
+    gs_blend_state_push();
+    gs_blend_function(GS_BLEND_ONE, GS_BLEND_INVSRCALPHA);
+    obs_source_skip_video_filter(ctx->source);
+    gs_blend_state_pop();
+    
+    gs_texrender_end(ctx->parent_texrender);
+}
+
+// Draws the parent without an intermediate texture, then the overlay on top in the same pass.
+// Canvas captures skip the overlay, so they always get the plain parent.
+static void design_overlay_filter_render(void *data, gs_effect_t *effect)
+{
+    struct design_overlay_data *ctx = data;
+    
+    const bool preview = ctx->cfg->enabled && ctx->cfg->show_breakpoints;
+    if (preview && !capture_in_progress()) {
+        render_filter_parent(ctx);
+    } else {
+        obs_source_skip_video_filter(ctx->source);
+    }
+    
+    if (!preview && ctx->parent_texrender) {
+        gs_texrender_destroy(ctx->parent_texrender);
+        ctx->parent_texrender = NULL;
+    }
+    design_overlay_video_render(data, effect);
+}
+
+// ============================================================================
+// Source info structure
+// ============================================================================
+
+struct obs_source_info design_overlay_source_info = {
+    .id = "design_overlay_source",
     .type = OBS_SOURCE_TYPE_INPUT,
     .output_flags = OBS_SOURCE_VIDEO | OBS_SOURCE_CUSTOM_DRAW,
     .get_name = design_overlay_get_name,
@@ -619,22 +3880,73 @@ struct obs_source_info design_overlay_source_info = {
     .get_height = design_overlay_get_height,
     .video_render = design_overlay_video_render,
     .video_tick = design_overlay_video_tick,
+    .show = design_overlay_show,
+    .hide = design_overlay_hide,
+    .activate = design_overlay_activate,
+    .deactivate = design_overlay_deactivate,
     .icon_type = OBS_ICON_TYPE_DESKTOP_CAPTURE,
 };
 
+struct obs_source_info design_overlay_filter_info = {
+    .id = "design_overlay_filter",
+    .type = OBS_SOURCE_TYPE_FILTER,
+    .output_flags = OBS_SOURCE_VIDEO,
+    .get_name = design_overlay_get_name,
+    .create = design_overlay_filter_create,
+    .destroy = design_overlay_destroy,
+    .update = design_overlay_update,
+    .get_defaults = design_overlay_get_defaults,
+    .get_properties = design_overlay_filter_get_properties,
+    .video_render = design_overlay_filter_render,
+    .video_tick = design_overlay_filter_tick,
+    .show = design_overlay_show,
+    .hide = design_overlay_hide,
+    .activate = design_overlay_activate,
+    .deactivate = design_overlay_deactivate,
+};
+
 // ============================================================================
 // Module entry points
 // ============================================================================
 
 bool obs_module_load(void)
 {
+    char *effect_path = obs_module_file("design-overlay.effect");
+    if (effect_path) {
+        obs_enter_graphics();
+        overlay_effect = gs_effect_create_from_file(effect_path, NULL);
+        obs_leave_graphics();
+        bfree(effect_path);
+    }
+    
+    if (!overlay_effect) {
+        blog(LOG_WARNING, "[Design Overlay] design-overlay.effect not loaded, using geometry grid engine");
+    }
+    
+    uint8_t *atlas_pixels = bmalloc((size_t)TEXT_ATLAS_WIDTH * TEXT_ATLAS_HEIGHT);
+    text_atlas_fill(atlas_pixels);
+    obs_enter_graphics();
+    glyph_atlas = gs_texture_create(TEXT_ATLAS_WIDTH, TEXT_ATLAS_HEIGHT, GS_R8, 1,
+                                    (const uint8_t **)&atlas_pixels, 0);
+    obs_leave_graphics();
+    bfree(atlas_pixels);
+    
     obs_register_source(&design_overlay_source_info);
+    obs_register_source(&design_overlay_filter_info);
     blog(LOG_INFO, "[Design Overlay] Clean plugin loaded (version %s)", PLUGIN_VERSION);
     return true;
 }
 
 void obs_module_unload(void)
 {
+    obs_enter_graphics();
+    gs_effect_destroy(overlay_effect);
+    overlay_effect = NULL;
+    gs_texture_destroy(glyph_atlas);
+    glyph_atlas = NULL;
+    capture_free();
+    obs_leave_graphics();
+    
     blog(LOG_INFO, "[Design Overlay] Clean plugin unloaded");
 }
 
@@ -646,4 +3958,4 @@ const char *obs_module_description(void)
 const char *obs_module_name(void)
 {
     return PLUGIN_NAME;
-}
\ No newline at end of file
+}
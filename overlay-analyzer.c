@@ -0,0 +1,399 @@
+#include "overlay-analyzer.h"
+
+#include <util/bmem.h>
+#include <util/threading.h>
+#include <util/sse-intrin.h>
+#include <math.h>
+#include <string.h>
+
+// Edge pixels a column/row needs before it counts as a content edge
+#define MIN_EDGE_RUN 6
+
+struct overlay_analyzer {
+    pthread_t thread;
+    bool thread_created;
+    os_event_t *work_event;
+    volatile bool exiting;
+    volatile bool busy;
+
+    // Input frame, owned by the worker while busy
+    uint8_t *frame;
+    size_t frame_capacity;
+    uint32_t width;
+    uint32_t height;
+    struct analyzer_config config;
+
+    // Worker scratch, reallocated only when the frame size changes
+    uint8_t *luma;
+    uint8_t *edge_x;      // Horizontal luma steps (vertical edges)
+    uint8_t *edge_y;      // Vertical luma steps (horizontal edges)
+    uint8_t *column_acc;  // 8-bit per-column counters, flushed every 255 rows
+    uint32_t *column_hits;
+    uint32_t *row_hits;
+    uint32_t stride;      // Scratch row size, padded for 16-byte loads
+    uint32_t scratch_w;
+    uint32_t scratch_h;
+
+    // Published results
+    pthread_mutex_t result_mutex;
+    struct analyzer_result results[ANALYZER_MAX_RESULTS];
+    size_t result_count;
+    uint64_t generation;
+};
+
+// ============================================================================
+// SIMD passes
+// ============================================================================
+
+// Rec. 601 luma in 8.8 fixed point, 16 pixels per iteration
+static void luma_row(const uint8_t *rgba, uint8_t *luma, uint32_t width)
+{
+    const __m128i mask = _mm_set1_epi32(0xFF);
+    const __m128i wr = _mm_set1_epi32(77);
+    const __m128i wg = _mm_set1_epi32(150);
+    const __m128i wb = _mm_set1_epi32(29);
+    uint32_t x = 0;
+    
+    for (; x + 16 <= width; x += 16) {
+        __m128i y4[4];
+        for (int i = 0; i < 4; i++) {
+            const __m128i px = _mm_loadu_si128((const __m128i *)(rgba + (x + i * 4) * 4));
+            const __m128i r = _mm_and_si128(px, mask);
+            const __m128i g = _mm_and_si128(_mm_srli_epi32(px, 8), mask);
+            const __m128i b = _mm_and_si128(_mm_srli_epi32(px, 16), mask);
+            
+            // Products fit the low 16 bits of each 32-bit lane, the sum stays below 65536
+            __m128i sum = _mm_mullo_epi16(r, wr);
+            sum = _mm_add_epi16(sum, _mm_mullo_epi16(g, wg));
+            sum = _mm_add_epi16(sum, _mm_mullo_epi16(b, wb));
+            y4[i] = _mm_srli_epi16(sum, 8);
+        }
+        
+        const __m128i lo = _mm_packs_epi32(y4[0], y4[1]);
+        const __m128i hi = _mm_packs_epi32(y4[2], y4[3]);
+        _mm_storeu_si128((__m128i *)(luma + x), _mm_packus_epi16(lo, hi));
+    }
+    
+    for (; x < width; x++) {
+        const uint8_t *px = rgba + x * 4;
+        luma[x] = (uint8_t)((px[0] * 77 + px[1] * 150 + px[2] * 29) >> 8);
+    }
+}
+
+// dst = |a - b| >= threshold ? 0xFF : 0, returns the number of set bytes
+static uint32_t edge_row(const uint8_t *a, const uint8_t *b, uint8_t *dst, uint32_t stride,
+                         uint8_t threshold)
+{
+    const __m128i thr = _mm_set1_epi8((char)threshold);
+    const __m128i one = _mm_set1_epi8(1);
+    __m128i count = _mm_setzero_si128();
+    
+    for (uint32_t x = 0; x < stride; x += 16) {
+        const __m128i va = _mm_loadu_si128((const __m128i *)(a + x));
+        const __m128i vb = _mm_loadu_si128((const __m128i *)(b + x));
+        const __m128i diff = _mm_or_si128(_mm_subs_epu8(va, vb), _mm_subs_epu8(vb, va));
+        const __m128i edge = _mm_cmpeq_epi8(_mm_max_epu8(diff, thr), diff);
+        
+        _mm_storeu_si128((__m128i *)(dst + x), edge);
+        count = _mm_add_epi64(count, _mm_sad_epu8(_mm_and_si128(edge, one), _mm_setzero_si128()));
+    }
+    
+    return (uint32_t)(_mm_cvtsi128_si32(count) + _mm_cvtsi128_si32(_mm_srli_si128(count, 8)));
+}
+
+// acc[x] += 1 for every set byte of mask (mask bytes are 0 or 0xFF)
+static void accumulate_row(uint8_t *acc, const uint8_t *mask, uint32_t stride)
+{
+    for (uint32_t x = 0; x < stride; x += 16) {
+        const __m128i a = _mm_loadu_si128((const __m128i *)(acc + x));
+        const __m128i m = _mm_loadu_si128((const __m128i *)(mask + x));
+        _mm_storeu_si128((__m128i *)(acc + x), _mm_sub_epi8(a, m));
+    }
+}
+
+static void flush_columns(struct overlay_analyzer *a)
+{
+    for (uint32_t x = 0; x < a->scratch_w; x++) {
+        a->column_hits[x] += a->column_acc[x];
+    }
+    memset(a->column_acc, 0, a->stride);
+}
+
+// ============================================================================
+// Analysis
+// ============================================================================
+
+static void ensure_scratch(struct overlay_analyzer *a)
+{
+    if (a->scratch_w == a->width && a->scratch_h == a->height) return;
+    
+    bfree(a->luma);
+    bfree(a->edge_x);
+    bfree(a->edge_y);
+    bfree(a->column_acc);
+    bfree(a->column_hits);
+    bfree(a->row_hits);
+    
+    // One spare block per row so unaligned 16-byte loads at x + 1 stay in bounds
+    a->stride = ((a->width + 15) & ~15u) + 16;
+    const size_t plane = (size_t)a->stride * a->height;
+    
+    a->luma = bzalloc(plane + 16);
+    a->edge_x = bzalloc(plane);
+    a->edge_y = bzalloc(plane);
+    a->column_acc = bzalloc(a->stride);
+    a->column_hits = bzalloc(sizeof(uint32_t) * a->stride);
+    a->row_hits = bzalloc(sizeof(uint32_t) * a->height);
+    a->scratch_w = a->width;
+    a->scratch_h = a->height;
+}
+
+static bool add_result(struct analyzer_result *results, size_t *count, enum analyzer_issue issue,
+                       float x, float y, float w, float h)
+{
+    if (*count >= ANALYZER_MAX_RESULTS) return false;
+    
+    struct analyzer_result *result = &results[(*count)++];
+    result->issue = issue;
+    result->x = x;
+    result->y = y;
+    result->w = w;
+    result->h = h;
+    return true;
+}
+
+static bool off_grid(float position, int grid_size, float tolerance)
+{
+    if (grid_size <= 0) return false;
+    
+    float d = fmodf(position, (float)grid_size);
+    d = fminf(d, (float)grid_size - d);
+    return d > tolerance;
+}
+
+static void analyze_frame(struct overlay_analyzer *a)
+{
+    const struct analyzer_config *config = &a->config;
+    const uint32_t w = a->width;
+    const uint32_t h = a->height;
+    const uint32_t stride = a->stride;
+    const float scale = config->canvas_scale;
+    
+    struct analyzer_result results[ANALYZER_MAX_RESULTS];
+    size_t count = 0;
+    
+    // Luma plane
+    for (uint32_t y = 0; y < h; y++) {
+        luma_row(a->frame + (size_t)y * w * 4, a->luma + (size_t)y * stride, w);
+    }
+    
+    // Edge masks and column/row profiles
+    memset(a->column_acc, 0, stride);
+    memset(a->column_hits, 0, sizeof(uint32_t) * stride);
+    
+    for (uint32_t y = 0; y < h; y++) {
+        const uint8_t *row = a->luma + (size_t)y * stride;
+        uint8_t *ex = a->edge_x + (size_t)y * stride;
+        uint8_t *ey = a->edge_y + (size_t)y * stride;
+        
+        edge_row(row, row + 1, ex, stride, config->edge_threshold);
+        memset(ex + w - 1, 0, stride - (w - 1));  // No neighbor past the last column
+        
+        if (y + 1 < h) {
+            edge_row(row, row + stride, ey, stride, config->edge_threshold);
+            memset(ey + w, 0, stride - w);
+            uint32_t hits = 0;
+            for (uint32_t x = 0; x < w; x++) hits += ey[x] & 1;
+            a->row_hits[y] = hits;
+        } else {
+            memset(ey, 0, stride);
+            a->row_hits[y] = 0;
+        }
+        
+        accumulate_row(a->column_acc, ex, stride);
+        if (y % 255 == 254) flush_columns(a);
+    }
+    flush_columns(a);
+    
+    // Content bounding box from both profiles
+    uint32_t min_x = w, max_x = 0, min_y = h, max_y = 0;
+    for (uint32_t x = 0; x < w; x++) {
+        if (a->column_hits[x] < MIN_EDGE_RUN) continue;
+        if (x < min_x) min_x = x;
+        max_x = x;
+    }
+    for (uint32_t y = 0; y < h; y++) {
+        if (a->row_hits[y] < MIN_EDGE_RUN) continue;
+        if (y < min_y) min_y = y;
+        max_y = y;
+    }
+    
+    // Vertical content edges sit between column x and x + 1
+    for (uint32_t x = 1; x + 1 < w; x++) {
+        const uint32_t hits = a->column_hits[x];
+        if (hits < MIN_EDGE_RUN || hits < a->column_hits[x - 1] || hits <= a->column_hits[x + 1]) continue;
+        
+        const float edge = (float)(x + 1) * scale;
+        if (!off_grid(edge, config->grid_size, scale)) continue;
+        
+        uint32_t first = h, last = 0;
+        for (uint32_t y = 0; y < h; y++) {
+            if (!a->edge_x[(size_t)y * stride + x]) continue;
+            if (y < first) first = y;
+            last = y;
+        }
+        if (first > last) continue;
+        
+        if (!add_result(results, &count, ANALYZER_OFF_GRID, edge - scale, (float)first * scale,
+                        2.0f * scale, (float)(last - first + 1) * scale)) break;
+    }
+    
+    // Horizontal content edges sit between row y and y + 1
+    for (uint32_t y = 1; y + 1 < h; y++) {
+        const uint32_t hits = a->row_hits[y];
+        if (hits < MIN_EDGE_RUN || hits < a->row_hits[y - 1] || hits <= a->row_hits[y + 1]) continue;
+        
+        const float edge = (float)(y + 1) * scale;
+        if (!off_grid(edge, config->grid_size, scale)) continue;
+        
+        const uint8_t *row = a->edge_y + (size_t)y * stride;
+        uint32_t first = w, last = 0;
+        for (uint32_t x = 0; x < w; x++) {
+            if (!row[x]) continue;
+            if (x < first) first = x;
+            last = x;
+        }
+        if (first > last) continue;
+        
+        if (!add_result(results, &count, ANALYZER_OFF_GRID, (float)first * scale, edge - scale,
+                        (float)(last - first + 1) * scale, 2.0f * scale)) break;
+    }
+    
+    // Parts of the content box outside the safe zone
+    if (min_x <= max_x && min_y <= max_y) {
+        const float x0 = (float)min_x * scale;
+        const float x1 = (float)(max_x + 1) * scale;
+        const float y0 = (float)min_y * scale;
+        const float y1 = (float)(max_y + 1) * scale;
+        const float sx0 = config->safe_x;
+        const float sx1 = config->safe_x + config->safe_w;
+        const float sy0 = config->safe_y;
+        const float sy1 = config->safe_y + config->safe_h;
+        
+        if (x0 < sx0) add_result(results, &count, ANALYZER_OUTSIDE_SAFE, x0, y0, sx0 - x0, y1 - y0);
+        if (x1 > sx1) add_result(results, &count, ANALYZER_OUTSIDE_SAFE, sx1, y0, x1 - sx1, y1 - y0);
+        if (y0 < sy0) add_result(results, &count, ANALYZER_OUTSIDE_SAFE, x0, y0, x1 - x0, sy0 - y0);
+        if (y1 > sy1) add_result(results, &count, ANALYZER_OUTSIDE_SAFE, x0, sy1, x1 - x0, y1 - sy1);
+    }
+    
+    pthread_mutex_lock(&a->result_mutex);
+    memcpy(a->results, results, sizeof(struct analyzer_result) * count);
+    a->result_count = count;
+    a->generation++;
+    pthread_mutex_unlock(&a->result_mutex);
+}
+
+static void *analyzer_thread(void *param)
+{
+    struct overlay_analyzer *a = param;
+    os_set_thread_name("design-overlay: analyzer");
+    
+    while (os_event_wait(a->work_event) == 0) {
+        if (os_atomic_load_bool(&a->exiting)) break;
+        
+        ensure_scratch(a);
+        analyze_frame(a);
+        os_atomic_set_bool(&a->busy, false);
+    }
+    
+    return NULL;
+}
+
+// ============================================================================
+// Public interface
+// ============================================================================
+
+struct overlay_analyzer *analyzer_create(void)
+{
+    struct overlay_analyzer *a = bzalloc(sizeof(struct overlay_analyzer));
+    
+    if (pthread_mutex_init(&a->result_mutex, NULL) != 0) {
+        bfree(a);
+        return NULL;
+    }
+    
+    if (os_event_init(&a->work_event, OS_EVENT_TYPE_AUTO) != 0) {
+        pthread_mutex_destroy(&a->result_mutex);
+        bfree(a);
+        return NULL;
+    }
+    
+    if (pthread_create(&a->thread, NULL, analyzer_thread, a) != 0) {
+        analyzer_destroy(a);
+        return NULL;
+    }
+    
+    a->thread_created = true;
+    return a;
+}
+
+void analyzer_destroy(struct overlay_analyzer *a)
+{
+    if (!a) return;
+    
+    if (a->thread_created) {
+        os_atomic_set_bool(&a->exiting, true);
+        os_event_signal(a->work_event);
+        pthread_join(a->thread, NULL);
+    }
+    
+    os_event_destroy(a->work_event);
+    pthread_mutex_destroy(&a->result_mutex);
+    
+    bfree(a->frame);
+    bfree(a->luma);
+    bfree(a->edge_x);
+    bfree(a->edge_y);
+    bfree(a->column_acc);
+    bfree(a->column_hits);
+    bfree(a->row_hits);
+    bfree(a);
+}
+
+bool analyzer_submit(struct overlay_analyzer *a, const uint8_t *data, uint32_t linesize,
+                     uint32_t width, uint32_t height, const struct analyzer_config *config)
+{
+    if (!a || width < 3 || height < 3) return false;
+    if (os_atomic_load_bool(&a->busy)) return false;
+    
+    const size_t size = (size_t)width * height * 4;
+    if (size > a->frame_capacity) {
+        bfree(a->frame);
+        a->frame = bmalloc(size);
+        a->frame_capacity = size;
+    }
+    
+    for (uint32_t y = 0; y < height; y++) {
+        memcpy(a->frame + (size_t)y * width * 4, data + (size_t)y * linesize, (size_t)width * 4);
+    }
+    
+    a->width = width;
+    a->height = height;
+    a->config = *config;
+    
+    os_atomic_set_bool(&a->busy, true);
+    os_event_signal(a->work_event);
+    return true;
+}
+
+uint64_t analyzer_get_results(struct overlay_analyzer *a, struct analyzer_result *results,
+                              size_t *count)
+{
+    pthread_mutex_lock(&a->result_mutex);
+    memcpy(results, a->results, sizeof(struct analyzer_result) * a->result_count);
+    *count = a->result_count;
+    const uint64_t generation = a->generation;
+    pthread_mutex_unlock(&a->result_mutex);
+    
+    return generation;
+}
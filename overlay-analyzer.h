@@ -0,0 +1,53 @@
+#pragma once
+
+// Grid-conformance and safe-zone analyzer.
+// Downscaled canvas frames are handed over from the graphics thread and
+// analyzed on a worker thread; results are polled without blocking.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ANALYZER_MAX_RESULTS 128
+
+enum analyzer_issue {
+    ANALYZER_OFF_GRID,       // Content edge not on a grid multiple
+    ANALYZER_OUTSIDE_SAFE,   // Content crossing the safe zone
+};
+
+struct analyzer_config {
+    float canvas_scale;      // Canvas pixels per analysis pixel
+    int grid_size;           // Canvas pixels
+    uint8_t edge_threshold;  // Minimum luma step for an edge
+    float safe_x;            // Safe zone, canvas pixels
+    float safe_y;
+    float safe_w;
+    float safe_h;
+};
+
+struct analyzer_result {
+    enum analyzer_issue issue;
+    float x, y, w, h;        // Canvas pixels
+};
+
+struct overlay_analyzer;
+
+struct overlay_analyzer *analyzer_create(void);
+void analyzer_destroy(struct overlay_analyzer *analyzer);
+
+// Copies an RGBA frame for the worker. Returns false, dropping the frame,
+// while the previous one is still being analyzed.
+bool analyzer_submit(struct overlay_analyzer *analyzer, const uint8_t *data, uint32_t linesize,
+                     uint32_t width, uint32_t height, const struct analyzer_config *config);
+
+// Copies the latest results; returns the result generation (0 = none yet)
+uint64_t analyzer_get_results(struct overlay_analyzer *analyzer, struct analyzer_result *results,
+                              size_t *count);
+
+#ifdef __cplusplus
+}
+#endif
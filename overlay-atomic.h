@@ -0,0 +1,56 @@
+#pragma once
+
+// Pointer and bitwise atomics that util/threading.h does not provide.
+// Sequentially consistent, like the os_atomic_* helpers.
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+
+static inline void *overlay_atomic_exchange_ptr(void *volatile *ptr, void *val)
+{
+    return _InterlockedExchangePointer(ptr, val);
+}
+
+static inline void *overlay_atomic_load_ptr(void *volatile *ptr)
+{
+    return _InterlockedCompareExchangePointer(ptr, NULL, NULL);
+}
+
+static inline bool overlay_atomic_compare_swap_ptr(void *volatile *ptr, void *old_val, void *new_val)
+{
+    return _InterlockedCompareExchangePointer(ptr, new_val, old_val) == old_val;
+}
+
+// Returns the previous value
+static inline long overlay_atomic_xor_long(volatile long *ptr, long bits)
+{
+    return _InterlockedXor(ptr, bits);
+}
+
+#else
+
+static inline void *overlay_atomic_exchange_ptr(void *volatile *ptr, void *val)
+{
+    return __atomic_exchange_n(ptr, val, __ATOMIC_SEQ_CST);
+}
+
+static inline void *overlay_atomic_load_ptr(void *volatile *ptr)
+{
+    return __atomic_load_n(ptr, __ATOMIC_SEQ_CST);
+}
+
+static inline bool overlay_atomic_compare_swap_ptr(void *volatile *ptr, void *old_val, void *new_val)
+{
+    return __atomic_compare_exchange_n(ptr, &old_val, new_val, false, __ATOMIC_SEQ_CST,
+                                       __ATOMIC_SEQ_CST);
+}
+
+static inline long overlay_atomic_xor_long(volatile long *ptr, long bits)
+{
+    return __atomic_fetch_xor(ptr, bits, __ATOMIC_SEQ_CST);
+}
+
+#endif
@@ -0,0 +1,136 @@
+#include "overlay-cache.h"
+
+#include <util/bmem.h>
+#include <string.h>
+
+// Protected by the graphics context, like everything else that touches GPU objects
+static struct shared_geometry *cache_head = NULL;
+static size_t cache_count = 0;
+
+static uint64_t hash_key(const struct geometry_key *key)
+{
+    // FNV-1a
+    const uint8_t *bytes = (const uint8_t *)key;
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    
+    for (size_t i = 0; i < sizeof(*key); i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+void geometry_key_init(struct geometry_key *key, const struct overlay_params *params,
+                       uint32_t layer_mask, uint32_t flags, float line_width)
+{
+    memset(key, 0, sizeof(*key));
+    key->params.canvas_width = params->canvas_width;
+    key->params.canvas_height = params->canvas_height;
+    key->params.material_grid_size = params->material_grid_size;
+    key->params.grid_lod = params->grid_lod;
+    key->params.grid_halfway = params->grid_halfway;
+    key->params.bootstrap_columns = params->bootstrap_columns;
+    key->params.bootstrap_gutter = params->bootstrap_gutter;
+    key->params.safe_zone_type = params->safe_zone_type;
+    key->params.custom_safe_zone_percent = params->custom_safe_zone_percent;
+    key->params.grid_opacity = params->grid_opacity;
+    key->params.safe_zone_opacity = params->safe_zone_opacity;
+    key->params.crosshair_opacity = params->crosshair_opacity;
+    key->params.grid_color = params->grid_color;
+    key->params.safe_zone_color = params->safe_zone_color;
+    key->params.measurement_labels = params->measurement_labels;
+    key->params.custom_layout_id = params->custom_layout_id;
+    key->params.custom_lines = params->custom_lines;
+    key->params.custom_line_count = params->custom_line_count;
+    key->params.custom_scale_x = params->custom_scale_x;
+    key->params.custom_scale_y = params->custom_scale_y;
+    key->layer_mask = layer_mask;
+    key->flags = flags;
+    key->line_width = line_width;
+}
+
+struct shared_geometry *shared_geometry_acquire(const struct geometry_key *key, bool *created)
+{
+    const uint64_t hash = hash_key(key);
+    
+    for (struct shared_geometry *entry = cache_head; entry; entry = entry->next) {
+        if (entry->hash == hash && memcmp(&entry->key, key, sizeof(*key)) == 0) {
+            entry->refs++;
+            *created = false;
+            return entry;
+        }
+    }
+    
+    struct shared_geometry *entry = bzalloc(sizeof(struct shared_geometry));
+    entry->hash = hash;
+    entry->key = *key;
+    entry->refs = 1;
+    overlay_prims_init(&entry->prims);
+    
+    entry->next = cache_head;
+    cache_head = entry;
+    cache_count++;
+    
+    *created = true;
+    return entry;
+}
+
+void shared_geometry_release(struct shared_geometry *geometry)
+{
+    if (!geometry || --geometry->refs > 0) return;
+    
+    struct shared_geometry **link = &cache_head;
+    while (*link != geometry) link = &(*link)->next;
+    *link = geometry->next;
+    cache_count--;
+    
+    gs_vertexbuffer_destroy(geometry->line_vb);
+    gs_vertexbuffer_destroy(geometry->quad_vb);
+    gs_indexbuffer_destroy(geometry->quad_ib);
+    gs_vertexbuffer_destroy(geometry->text_vb);
+    gs_indexbuffer_destroy(geometry->text_ib);
+    for (int i = 0; i < GEOMETRY_TEXTURE_SLOTS; i++) {
+        gs_texrender_destroy(geometry->textures[i].texrender);
+    }
+    overlay_prims_free(&geometry->prims);
+    bfree(geometry);
+}
+
+static bool texture_key_equal(const struct geometry_texture_key *a, const struct geometry_texture_key *b)
+{
+    return a->layers == b->layers && a->output_scale == b->output_scale && a->grid_lod == b->grid_lod &&
+           a->grid_halfway == b->grid_halfway;
+}
+
+struct geometry_texture *shared_geometry_texture(struct shared_geometry *geometry,
+                                                 const struct geometry_texture_key *key)
+{
+    struct geometry_texture *slot = NULL;
+    for (int i = 0; i < GEOMETRY_TEXTURE_SLOTS; i++) {
+        struct geometry_texture *texture = &geometry->textures[i];
+        if (texture->valid && texture_key_equal(&texture->key, key)) {
+            slot = texture;
+            break;
+        }
+        // Prefer slots that were never drawn, then the one unused the longest
+        if (!slot || (slot->valid && (!texture->valid || texture->last_used < slot->last_used))) {
+            slot = texture;
+        }
+    }
+    
+    if (!slot->texrender) {
+        slot->texrender = gs_texrender_create(GS_RGBA, GS_ZS_NONE);
+        if (!slot->texrender) return NULL;
+    }
+    if (!slot->valid || !texture_key_equal(&slot->key, key)) {
+        slot->valid = false;
+        slot->key = *key;
+    }
+    slot->last_used = ++geometry->texture_clock;
+    return slot;
+}
+
+size_t shared_geometry_count(void)
+{
+    return cache_count;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+// Module-wide cache of built overlay geometry.
+// Instances whose effective parameters match share one vertex buffer, and one
+// cached texture per combination of visible layers and output scale. All
+// functions need the graphics context.
+
+#include <obs-module.h>
+
+#include "overlay-geometry.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Everything the shared geometry and texture depend on
+struct geometry_key {
+    struct overlay_params params;
+    uint32_t layer_mask;
+    uint32_t flags;       // GEOMETRY_* build flags
+    float line_width;     // 0 = hairlines, otherwise anti-aliased quads of this screen width
+};
+
+// Textures kept per entry; instances with different hotkey toggles each get one
+#define GEOMETRY_TEXTURE_SLOTS 4
+
+// Range of one layer inside a buffer: vertices for hairlines, indices for quads and text
+struct layer_segment {
+    uint32_t first;
+    uint32_t count;
+};
+
+// What a cached texture depends on besides the geometry itself
+struct geometry_texture_key {
+    uint32_t layers;     // Visible layers
+    float output_scale;  // Output pixels per canvas pixel, read by the shader grid
+    int grid_lod;        // Level of the geometry grid, 0 with the shader grid
+    bool grid_halfway;
+};
+
+// The geometry drawn for one texture key, for texture mode
+struct geometry_texture {
+    gs_texrender_t *texrender;
+    struct geometry_texture_key key;  // What it was drawn with
+    bool valid;
+    uint64_t last_used;               // Slots are reused least recently used first
+};
+
+struct shared_geometry {
+    struct shared_geometry *next;
+    uint64_t hash;
+    struct geometry_key key;
+    long refs;
+
+    // Filled by the instance that created the entry
+    struct overlay_prim_list prims;
+    gs_vertbuffer_t *line_vb;
+    uint32_t line_vertex_count;
+    uint32_t layer_vertices[OVERLAY_LAYER_COUNT];
+    uint64_t layer_build_ns[OVERLAY_LAYER_COUNT];
+    struct layer_segment line_segments[OVERLAY_LAYER_COUNT];  // Into line_vb or quad_ib
+
+    // Anti-aliased variant: four vertices and six indices per line (line_width > 0)
+    gs_vertbuffer_t *quad_vb;
+    gs_indexbuffer_t *quad_ib;
+    uint32_t quad_index_count;
+
+    // Labels: one textured quad per glyph and shadow, drawn with the glyph atlas
+    gs_vertbuffer_t *text_vb;
+    gs_indexbuffer_t *text_ib;
+    uint32_t text_index_count;
+    struct layer_segment text_segments[OVERLAY_LAYER_COUNT];
+
+    // Texture cache, keyed by struct geometry_texture_key
+    struct geometry_texture textures[GEOMETRY_TEXTURE_SLOTS];
+    uint64_t texture_clock;
+};
+
+// Zeroes the padding so keys can be hashed and compared bytewise
+void geometry_key_init(struct geometry_key *key, const struct overlay_params *params,
+                       uint32_t layer_mask, uint32_t flags, float line_width);
+
+// Returns a referenced entry. *created is set when the entry is new and
+// still has to be built by the caller.
+struct shared_geometry *shared_geometry_acquire(const struct geometry_key *key, bool *created);
+void shared_geometry_release(struct shared_geometry *geometry);
+
+// Returns the texture slot for this key. A valid slot can be drawn as is;
+// otherwise the least recently used slot was handed over and the caller draws
+// into it and sets valid. NULL if no render target can be created.
+struct geometry_texture *shared_geometry_texture(struct shared_geometry *geometry,
+                                                 const struct geometry_texture_key *key);
+
+// Number of distinct configurations currently cached
+size_t shared_geometry_count(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,212 @@
+#include "overlay-capture.h"
+
+// Set while the program output is re-rendered for sampling (graphics thread only)
+static bool capturing = false;
+
+// Shared program frame and the video frame it was rendered for
+static gs_texrender_t *program_texrender = NULL;
+static uint64_t program_frame_time = 0;
+static bool program_frame_valid = false;
+
+// ============================================================================
+// Readback ring
+// ============================================================================
+
+void readback_ring_free(struct readback_ring *ring)
+{
+    for (size_t i = 0; i < READBACK_RING_SIZE; i++) {
+        gs_stagesurface_destroy(ring->surfaces[i]);
+        ring->surfaces[i] = NULL;
+        ring->pending[i] = false;
+    }
+    
+    ring->width = 0;
+    ring->height = 0;
+    ring->write_index = 0;
+    ring->tick = 0;
+}
+
+bool readback_ring_stage(struct readback_ring *ring, gs_texture_t *tex)
+{
+    if (!tex) return false;
+    
+    const uint32_t width = gs_texture_get_width(tex);
+    const uint32_t height = gs_texture_get_height(tex);
+    
+    if (width != ring->width || height != ring->height) {
+        readback_ring_free(ring);
+        
+        for (size_t i = 0; i < READBACK_RING_SIZE; i++) {
+            ring->surfaces[i] = gs_stagesurface_create(width, height, GS_RGBA);
+            if (!ring->surfaces[i]) {
+                readback_ring_free(ring);
+                return false;
+            }
+        }
+        
+        ring->width = width;
+        ring->height = height;
+    }
+    
+    const size_t index = ring->write_index;
+    gs_stage_texture(ring->surfaces[index], tex);
+    ring->pending[index] = true;
+    ring->staged_tick[index] = ring->tick;
+    ring->write_index = (index + 1) % READBACK_RING_SIZE;
+    return true;
+}
+
+bool readback_ring_collect(struct readback_ring *ring, readback_func func, void *param)
+{
+    const uint64_t tick = ring->tick++;
+    
+    // Oldest pending surface first, only once its copy has had time to finish
+    size_t index = READBACK_RING_SIZE;
+    for (size_t i = 0; i < READBACK_RING_SIZE; i++) {
+        if (!ring->pending[i] || tick - ring->staged_tick[i] < READBACK_RING_SIZE - 1) continue;
+        if (index == READBACK_RING_SIZE || ring->staged_tick[i] < ring->staged_tick[index]) {
+            index = i;
+        }
+    }
+    
+    if (index == READBACK_RING_SIZE) return false;
+    
+    uint8_t *data;
+    uint32_t linesize;
+    ring->pending[index] = false;
+    
+    if (!gs_stagesurface_map(ring->surfaces[index], &data, &linesize)) {
+        return false;
+    }
+    
+    func(param, data, linesize, ring->width, ring->height);
+    gs_stagesurface_unmap(ring->surfaces[index]);
+    return true;
+}
+
+// ============================================================================
+// Canvas capture
+// ============================================================================
+
+bool capture_in_progress(void)
+{
+    return capturing;
+}
+
+// The main texture already contains the overlays, so the program is rendered
+// once more with every overlay skipping itself
+gs_texture_t *capture_program_frame(void)
+{
+    if (capturing) return NULL;
+    
+    const uint64_t frame_time = obs_get_video_frame_time();
+    if (program_frame_valid && program_frame_time == frame_time) {
+        return gs_texrender_get_texture(program_texrender);
+    }
+    
+    struct obs_video_info ovi;
+    if (!obs_get_video_info(&ovi) || !ovi.base_width || !ovi.base_height) return NULL;
+    
+    if (!program_texrender) {
+        program_texrender = gs_texrender_create(GS_RGBA, GS_ZS_NONE);
+        if (!program_texrender) return NULL;
+    }
+    
+    obs_source_t *program = obs_get_output_source(0);
+    if (!program) return NULL;
+    
+    program_frame_valid = false;
+    gs_texrender_reset(program_texrender);
+    
+    if (gs_texrender_begin(program_texrender, ovi.base_width, ovi.base_height)) {
+        struct vec4 clear_color;
+        vec4_zero(&clear_color);
+        gs_clear(GS_CLEAR_COLOR, &clear_color, 0.0f, 0);
+        gs_ortho(0.0f, (float)ovi.base_width, 0.0f, (float)ovi.base_height, -100.0f, 100.0f);
+        
+        gs_blend_state_push();
+        gs_reset_blend_state();
+        
+        // Overlays check capture_in_progress() and skip themselves
+        capturing = true;
+        obs_source_video_render(program);
+        capturing = false;
+        
+        gs_blend_state_pop();
+        gs_texrender_end(program_texrender);
+        
+        program_frame_valid = true;
+        program_frame_time = frame_time;
+    }
+    
+    obs_source_release(program);
+    return program_frame_valid ? gs_texrender_get_texture(program_texrender) : NULL;
+}
+
+bool capture_canvas_region(gs_texrender_t *target, float x, float y, float width, float height,
+                           uint32_t out_width, uint32_t out_height)
+{
+    if (capturing || !target || !out_width || !out_height) return false;
+    
+    gs_texture_t *frame = capture_program_frame();
+    if (!frame) return false;
+    
+    gs_effect_t *effect = obs_get_base_effect(OBS_EFFECT_DEFAULT);
+    gs_eparam_t *image_param = gs_effect_get_param_by_name(effect, "image");
+    gs_texrender_reset(target);
+    if (!gs_texrender_begin(target, out_width, out_height)) return false;
+    
+    struct vec4 clear_color;
+    vec4_zero(&clear_color);
+    gs_clear(GS_CLEAR_COLOR, &clear_color, 0.0f, 0);
+    gs_ortho(x, x + width, y, y + height, -100.0f, 100.0f);
+    
+    // Copy, not composite: the alpha of the canvas is kept
+    gs_blend_state_push();
+    gs_enable_blending(false);
+    
+    gs_effect_set_texture(image_param, frame);
+    while (gs_effect_loop(effect, "Draw")) {
+        gs_draw_sprite(frame, 0, gs_texture_get_width(frame), gs_texture_get_height(frame));
+    }
+    
+    gs_blend_state_pop();
+    gs_texrender_end(target);
+    return true;
+}
+
+bool capture_copy_region(gs_texture_t **dst, int x, int y, uint32_t width, uint32_t height)
+{
+    gs_texture_t *frame = capture_program_frame();
+    if (!frame) return false;
+    
+    const uint32_t frame_width = gs_texture_get_width(frame);
+    const uint32_t frame_height = gs_texture_get_height(frame);
+    if (width > frame_width) width = frame_width;
+    if (height > frame_height) height = frame_height;
+    if (!width || !height) return false;
+    
+    if (x < 0) x = 0;
+    if (y < 0) y = 0;
+    if ((uint32_t)x + width > frame_width) x = (int)(frame_width - width);
+    if ((uint32_t)y + height > frame_height) y = (int)(frame_height - height);
+    
+    if (*dst && (gs_texture_get_width(*dst) != width || gs_texture_get_height(*dst) != height)) {
+        gs_texture_destroy(*dst);
+        *dst = NULL;
+    }
+    if (!*dst) {
+        *dst = gs_texture_create(width, height, GS_RGBA, 1, NULL, 0);
+        if (!*dst) return false;
+    }
+    
+    gs_copy_texture_region(*dst, 0, 0, frame, (uint32_t)x, (uint32_t)y, width, height);
+    return true;
+}
+
+void capture_free(void)
+{
+    gs_texrender_destroy(program_texrender);
+    program_texrender = NULL;
+    program_frame_valid = false;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+// Canvas capture and asynchronous GPU readback.
+// All functions run on the graphics thread.
+
+#include <obs-module.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define READBACK_RING_SIZE 3
+
+// Ring of staging surfaces; a surface is mapped RING_SIZE - 1 frames after
+// its copy was queued, so the map never waits on the GPU
+struct readback_ring {
+    gs_stagesurf_t *surfaces[READBACK_RING_SIZE];
+    bool pending[READBACK_RING_SIZE];
+    uint64_t staged_tick[READBACK_RING_SIZE];
+    uint64_t tick;  // Advanced once per readback_ring_collect call
+    uint32_t width;
+    uint32_t height;
+    size_t write_index;
+};
+
+typedef void (*readback_func)(void *param, const uint8_t *data, uint32_t linesize,
+                              uint32_t width, uint32_t height);
+
+void readback_ring_free(struct readback_ring *ring);
+
+// Queues a copy of tex (GS_RGBA) into the next surface
+bool readback_ring_stage(struct readback_ring *ring, gs_texture_t *tex);
+
+// Call once per frame. Maps the oldest surface that is old enough, if any,
+// and hands it to func.
+bool readback_ring_collect(struct readback_ring *ring, readback_func func, void *param);
+
+// The program canvas at base size, without any design overlay. Rendered at most
+// once per video frame and shared by every tool of every instance; NULL if the
+// program cannot be rendered.
+gs_texture_t *capture_program_frame(void);
+
+// Scales a region of the program frame (base canvas pixels) into target at
+// out_width x out_height
+bool capture_canvas_region(gs_texrender_t *target, float x, float y, float width, float height,
+                           uint32_t out_width, uint32_t out_height);
+
+// Copies a region of the program frame 1:1 into *dst (GS_RGBA), moved inside the
+// frame if it sticks out. *dst is recreated when the region size changes.
+bool capture_copy_region(gs_texture_t **dst, int x, int y, uint32_t width, uint32_t height);
+
+// Module unload
+void capture_free(void);
+
+// True while the program frame is rendering; overlays must not draw
+bool capture_in_progress(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,493 @@
+#include "overlay-export.h"
+#include "overlay-raster.h"
+
+#include <obs.h>
+#include <util/bmem.h>
+#include <util/dstr.h>
+#include <util/platform.h>
+#include <util/threading.h>
+#include <string.h>
+
+#define EXPORT_FILENAME_FORMAT "Design Overlay %CCYY-%MM-%DD %hh-%mm-%ss"
+
+struct export_job {
+    struct export_job *next;
+    uint8_t *pixels;  // RGBA8, tightly packed
+    uint32_t width;
+    uint32_t height;
+    struct overlay_params params;
+    uint32_t layer_mask;
+    char *directory;
+    struct overlay_line *custom_lines;  // Owned copy behind params.custom_lines
+};
+
+struct overlay_exporter {
+    pthread_t thread;
+    bool thread_created;
+    os_event_t *work_event;
+    volatile bool exiting;
+
+    pthread_mutex_t queue_mutex;
+    struct export_job *head;
+    struct export_job *tail;
+    size_t queued;
+};
+
+// ============================================================================
+// PNG encoder
+// ============================================================================
+
+// Uncompressed (stored deflate) PNG, streamed to disk row by row
+struct png_writer {
+    FILE *file;
+    uint32_t crc_table[256];
+    uint32_t crc;
+    uint32_t adler_a;
+    uint32_t adler_b;
+    size_t block_left;  // Bytes left in the current stored block
+    size_t raw_left;    // Uncompressed bytes still to come
+    bool failed;
+};
+
+static void png_put(struct png_writer *w, const void *data, size_t size)
+{
+    const uint8_t *bytes = data;
+    uint32_t crc = w->crc;
+    
+    for (size_t i = 0; i < size; i++) {
+        crc = w->crc_table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    w->crc = crc;
+    
+    if (fwrite(data, 1, size, w->file) != size) w->failed = true;
+}
+
+static void png_put_u32(struct png_writer *w, uint32_t value)
+{
+    const uint8_t bytes[4] = {
+        (uint8_t)(value >> 24), (uint8_t)(value >> 16), (uint8_t)(value >> 8), (uint8_t)value,
+    };
+    png_put(w, bytes, sizeof(bytes));
+}
+
+static void png_chunk_begin(struct png_writer *w, const char *type, uint32_t length)
+{
+    png_put_u32(w, length);  // The length is not part of the chunk CRC
+    w->crc = 0xFFFFFFFF;
+    png_put(w, type, 4);
+}
+
+static void png_chunk_end(struct png_writer *w)
+{
+    png_put_u32(w, w->crc ^ 0xFFFFFFFF);
+}
+
+static void zlib_put(struct png_writer *w, const uint8_t *data, size_t size)
+{
+    while (size > 0) {
+        if (w->block_left == 0) {
+            const size_t len = w->raw_left < 65535 ? w->raw_left : 65535;
+            const uint8_t header[5] = {
+                (uint8_t)(len == w->raw_left),  // BFINAL, BTYPE = stored
+                (uint8_t)len, (uint8_t)(len >> 8),
+                (uint8_t)~len, (uint8_t)(~len >> 8),
+            };
+            png_put(w, header, sizeof(header));
+            w->block_left = len;
+        }
+        
+        size_t n = size < w->block_left ? size : w->block_left;
+        png_put(w, data, n);
+        
+        // Adler-32, reduced at most every 5552 bytes so the sums cannot overflow
+        for (size_t i = 0; i < n;) {
+            const size_t end = i + 5552 < n ? i + 5552 : n;
+            for (; i < end; i++) {
+                w->adler_a += data[i];
+                w->adler_b += w->adler_a;
+            }
+            w->adler_a %= 65521;
+            w->adler_b %= 65521;
+        }
+        
+        data += n;
+        size -= n;
+        w->block_left -= n;
+        w->raw_left -= n;
+    }
+}
+
+static bool write_png(const char *path, const uint8_t *pixels, uint32_t width, uint32_t height)
+{
+    const size_t row_size = (size_t)width * 4;
+    const size_t raw_size = (row_size + 1) * height;
+    const size_t blocks = (raw_size + 65534) / 65535;
+    const size_t zlib_size = 2 + blocks * 5 + raw_size + 4;
+    if (zlib_size > 0x7FFFFFFF) return false;
+    
+    struct png_writer w;
+    memset(&w, 0, sizeof(w));
+    for (uint32_t n = 0; n < 256; n++) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+        w.crc_table[n] = c;
+    }
+    w.adler_a = 1;
+    w.raw_left = raw_size;
+    
+    w.file = os_fopen(path, "wb");
+    if (!w.file) return false;
+    
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    png_put(&w, signature, sizeof(signature));
+    
+    // 8-bit RGBA, no interlace
+    const uint8_t ihdr_tail[5] = {8, 6, 0, 0, 0};
+    png_chunk_begin(&w, "IHDR", 13);
+    png_put_u32(&w, width);
+    png_put_u32(&w, height);
+    png_put(&w, ihdr_tail, sizeof(ihdr_tail));
+    png_chunk_end(&w);
+    
+    static const uint8_t zlib_header[2] = {0x78, 0x01};
+    static const uint8_t filter_none = 0;
+    png_chunk_begin(&w, "IDAT", (uint32_t)zlib_size);
+    png_put(&w, zlib_header, sizeof(zlib_header));
+    for (uint32_t y = 0; y < height && !w.failed; y++) {
+        zlib_put(&w, &filter_none, 1);
+        zlib_put(&w, pixels + (size_t)y * row_size, row_size);
+    }
+    png_put_u32(&w, (w.adler_b << 16) | w.adler_a);
+    png_chunk_end(&w);
+    
+    png_chunk_begin(&w, "IEND", 0);
+    png_chunk_end(&w);
+    
+    if (fclose(w.file) != 0) w.failed = true;
+    return !w.failed;
+}
+
+// ============================================================================
+// JSON spec sidecar
+// ============================================================================
+
+static obs_data_t *rect_data(float x, float y, float w, float h)
+{
+    obs_data_t *rect = obs_data_create();
+    obs_data_set_double(rect, "x", x);
+    obs_data_set_double(rect, "y", y);
+    obs_data_set_double(rect, "width", w);
+    obs_data_set_double(rect, "height", h);
+    return rect;
+}
+
+static void set_rect(obs_data_t *data, const char *name, float x, float y, float w, float h)
+{
+    obs_data_t *rect = rect_data(x, y, w, h);
+    obs_data_set_obj(data, name, rect);
+    obs_data_release(rect);
+}
+
+static void push_rect(obs_data_array_t *array, float x, float y, float w, float h)
+{
+    obs_data_t *rect = rect_data(x, y, w, h);
+    obs_data_array_push_back(array, rect);
+    obs_data_release(rect);
+}
+
+static void set_bootstrap_spec(obs_data_t *spec, const struct overlay_layout *layout, float height)
+{
+    obs_data_t *grid = obs_data_create();
+    obs_data_array_t *columns = obs_data_array_create();
+    obs_data_array_t *gutters = obs_data_array_create();
+    
+    obs_data_set_int(grid, "columns", layout->columns);
+    obs_data_set_double(grid, "column_width", layout->column_w);
+    obs_data_set_double(grid, "gutter", layout->gutter);
+    set_rect(grid, "container", layout->container_x, 0.0f, layout->container_w, height);
+    
+    // Same column positions as geometry_bootstrap_grid
+    for (int i = 0; i < layout->columns; i++) {
+        const float x = layout->container_x + i * (layout->column_w + layout->gutter);
+        push_rect(columns, x, 0.0f, layout->column_w, height);
+        if (i + 1 < layout->columns) push_rect(gutters, x + layout->column_w, 0.0f, layout->gutter, height);
+    }
+    
+    obs_data_set_array(grid, "column_rects", columns);
+    obs_data_set_array(grid, "gutter_rects", gutters);
+    obs_data_set_obj(spec, "bootstrap_grid", grid);
+    
+    obs_data_array_release(gutters);
+    obs_data_array_release(columns);
+    obs_data_release(grid);
+}
+
+static void set_safe_zone_spec(obs_data_t *spec, const struct overlay_params *params,
+                               const struct overlay_layout *layout)
+{
+    static const char *presets[] = {"mobile", "desktop", "broadcast", "custom"};
+    const int type = params->safe_zone_type;
+    
+    obs_data_t *zone = obs_data_create();
+    obs_data_set_string(zone, "preset", type >= 0 && type <= 3 ? presets[type] : "desktop");
+    obs_data_set_double(zone, "x", layout->safe_x);
+    obs_data_set_double(zone, "y", layout->safe_y);
+    obs_data_set_double(zone, "width", layout->safe_w);
+    obs_data_set_double(zone, "height", layout->safe_h);
+    obs_data_set_obj(spec, "safe_zone", zone);
+    obs_data_release(zone);
+}
+
+static bool write_spec(const char *path, const char *screenshot, const struct export_job *job)
+{
+    const struct overlay_params *params = &job->params;
+    struct overlay_layout layout;
+    overlay_compute_layout(params, &layout);
+    
+    obs_data_t *spec = obs_data_create();
+    obs_data_set_string(spec, "screenshot", screenshot);
+    obs_data_set_int(spec, "canvas_width", params->canvas_width);
+    obs_data_set_int(spec, "canvas_height", params->canvas_height);
+    
+    if (job->layer_mask & OVERLAY_LAYER_BIT(OVERLAY_LAYER_MATERIAL_GRID)) {
+        obs_data_set_int(spec, "material_grid_size", params->material_grid_size);
+    }
+    
+    if (job->layer_mask & OVERLAY_LAYER_BIT(OVERLAY_LAYER_BOOTSTRAP_GRID)) {
+        set_bootstrap_spec(spec, &layout, (float)params->canvas_height);
+    }
+    
+    if (job->layer_mask & OVERLAY_LAYER_BIT(OVERLAY_LAYER_SAFE_ZONES)) {
+        set_safe_zone_spec(spec, params, &layout);
+    }
+    
+    if (job->layer_mask & OVERLAY_LAYER_BIT(OVERLAY_LAYER_RULE_OF_THIRDS)) {
+        obs_data_t *thirds = obs_data_create();
+        obs_data_set_double(thirds, "x1", layout.thirds[0]);
+        obs_data_set_double(thirds, "x2", layout.thirds[1]);
+        obs_data_set_double(thirds, "y1", layout.thirds[2]);
+        obs_data_set_double(thirds, "y2", layout.thirds[3]);
+        obs_data_set_obj(spec, "rule_of_thirds", thirds);
+        obs_data_release(thirds);
+    }
+    
+    obs_data_t *center = obs_data_create();
+    obs_data_set_double(center, "x", layout.center_x);
+    obs_data_set_double(center, "y", layout.center_y);
+    obs_data_set_obj(spec, "center", center);
+    obs_data_release(center);
+    
+    const bool ok = obs_data_save_json(spec, path);
+    obs_data_release(spec);
+    return ok;
+}
+
+// ============================================================================
+// Worker
+// ============================================================================
+
+// "<directory>/Design Overlay <date> <time>[ (n)]", without extension
+static void make_export_stem(struct dstr *stem, const char *directory)
+{
+    char *name = os_generate_formatted_filename("png", true, EXPORT_FILENAME_FORMAT);
+    const size_t name_len = strlen(name) - strlen(".png");
+    struct dstr path;
+    dstr_init(&path);
+    
+    for (int n = 1;; n++) {
+        dstr_copy(stem, directory);
+        dstr_cat_ch(stem, '/');
+        dstr_ncat(stem, name, name_len);
+        if (n > 1) dstr_catf(stem, " (%d)", n);
+        
+        dstr_copy_dstr(&path, stem);
+        dstr_cat(&path, ".png");
+        if (!os_file_exists(path.array)) break;
+    }
+    
+    dstr_free(&path);
+    bfree(name);
+}
+
+static void run_export(struct export_job *job)
+{
+    // The capture carries the canvas alpha, screenshots are opaque
+    const size_t pixel_count = (size_t)job->width * job->height;
+    for (size_t i = 0; i < pixel_count; i++) job->pixels[i * 4 + 3] = 0xFF;
+    
+    struct overlay_prim_list prims;
+    overlay_prims_init(&prims);
+    geometry_build(&prims, &job->params, job->layer_mask, 0);
+    
+    struct overlay_image image = {
+        .pixels = job->pixels,
+        .width = job->width,
+        .height = job->height,
+        .linesize = job->width * 4,
+    };
+    overlay_raster_prims(&image, &prims);
+    overlay_prims_free(&prims);
+    
+    if (os_mkdirs(job->directory) == MKDIR_ERROR) {
+        blog(LOG_WARNING, "[Design Overlay] Export failed: cannot create '%s'", job->directory);
+        return;
+    }
+    
+    struct dstr stem;
+    struct dstr png_path;
+    struct dstr json_path;
+    dstr_init(&stem);
+    dstr_init(&png_path);
+    dstr_init(&json_path);
+    make_export_stem(&stem, job->directory);
+    dstr_copy_dstr(&png_path, &stem);
+    dstr_cat(&png_path, ".png");
+    dstr_copy_dstr(&json_path, &stem);
+    dstr_cat(&json_path, ".json");
+    
+    const uint64_t start_ns = os_gettime_ns();
+    
+    if (!write_png(png_path.array, job->pixels, job->width, job->height)) {
+        blog(LOG_WARNING, "[Design Overlay] Export failed: cannot write '%s'", png_path.array);
+    } else {
+        const char *screenshot = strrchr(png_path.array, '/') + 1;
+        if (!write_spec(json_path.array, screenshot, job)) {
+            blog(LOG_WARNING, "[Design Overlay] Export failed: cannot write '%s'", json_path.array);
+        }
+        
+        blog(LOG_INFO, "[Design Overlay] Exported %ux%u screenshot to '%s' in %.1f ms", job->width,
+             job->height, png_path.array, (double)(os_gettime_ns() - start_ns) / 1000000.0);
+    }
+    
+    dstr_free(&json_path);
+    dstr_free(&png_path);
+    dstr_free(&stem);
+}
+
+static void free_job(struct export_job *job)
+{
+    bfree(job->pixels);
+    bfree(job->custom_lines);
+    bfree(job->directory);
+    bfree(job);
+}
+
+static struct export_job *pop_job(struct overlay_exporter *e)
+{
+    pthread_mutex_lock(&e->queue_mutex);
+    struct export_job *job = e->head;
+    if (job) {
+        e->head = job->next;
+        if (!e->head) e->tail = NULL;
+        e->queued--;
+    }
+    pthread_mutex_unlock(&e->queue_mutex);
+    return job;
+}
+
+static void *exporter_thread(void *param)
+{
+    struct overlay_exporter *e = param;
+    os_set_thread_name("design-overlay: export");
+    
+    while (os_event_wait(e->work_event) == 0) {
+        struct export_job *job;
+        while ((job = pop_job(e)) != NULL) {
+            run_export(job);
+            free_job(job);
+        }
+        
+        if (os_atomic_load_bool(&e->exiting)) break;
+    }
+    
+    return NULL;
+}
+
+// ============================================================================
+// Public interface
+// ============================================================================
+
+struct overlay_exporter *exporter_create(void)
+{
+    struct overlay_exporter *e = bzalloc(sizeof(struct overlay_exporter));
+    
+    if (pthread_mutex_init(&e->queue_mutex, NULL) != 0) {
+        bfree(e);
+        return NULL;
+    }
+    
+    if (os_event_init(&e->work_event, OS_EVENT_TYPE_AUTO) != 0) {
+        pthread_mutex_destroy(&e->queue_mutex);
+        bfree(e);
+        return NULL;
+    }
+    
+    if (pthread_create(&e->thread, NULL, exporter_thread, e) != 0) {
+        exporter_destroy(e);
+        return NULL;
+    }
+    
+    e->thread_created = true;
+    return e;
+}
+
+void exporter_destroy(struct overlay_exporter *e)
+{
+    if (!e) return;
+    
+    if (e->thread_created) {
+        os_atomic_set_bool(&e->exiting, true);
+        os_event_signal(e->work_event);
+        pthread_join(e->thread, NULL);
+    }
+    
+    struct export_job *job;
+    while ((job = pop_job(e)) != NULL) free_job(job);
+    
+    os_event_destroy(e->work_event);
+    pthread_mutex_destroy(&e->queue_mutex);
+    bfree(e);
+}
+
+bool exporter_submit(struct overlay_exporter *e, const uint8_t *data, uint32_t linesize,
+                     uint32_t width, uint32_t height, const struct export_request *request)
+{
+    if (!e || !width || !height) return false;
+    
+    pthread_mutex_lock(&e->queue_mutex);
+    const bool full = e->queued >= EXPORT_MAX_QUEUED;
+    pthread_mutex_unlock(&e->queue_mutex);
+    if (full) return false;
+    
+    struct export_job *job = bzalloc(sizeof(struct export_job));
+    job->pixels = bmalloc((size_t)width * height * 4);
+    job->width = width;
+    job->height = height;
+    job->params = request->params;
+    job->layer_mask = request->layer_mask;
+    job->directory = bstrdup(request->directory);
+    
+    // The layout's lines may be released before the worker gets to the job
+    if (job->params.custom_line_count > 0) {
+        job->custom_lines = bmemdup(request->params.custom_lines,
+                                    sizeof(struct overlay_line) * request->params.custom_line_count);
+        job->params.custom_lines = job->custom_lines;
+    }
+    
+    for (uint32_t y = 0; y < height; y++) {
+        memcpy(job->pixels + (size_t)y * width * 4, data + (size_t)y * linesize, (size_t)width * 4);
+    }
+    
+    pthread_mutex_lock(&e->queue_mutex);
+    if (e->tail) {
+        e->tail->next = job;
+    } else {
+        e->head = job;
+    }
+    e->tail = job;
+    e->queued++;
+    pthread_mutex_unlock(&e->queue_mutex);
+    
+    os_event_signal(e->work_event);
+    return true;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+// Annotated screenshot export.
+// Frames read back on the graphics thread are queued for a worker thread,
+// which draws the overlay with the CPU rasterizer, encodes a PNG and writes a
+// JSON sidecar with the exact layout rectangles next to it.
+
+#include "overlay-geometry.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EXPORT_MAX_QUEUED 4
+
+struct export_request {
+    struct overlay_params params;  // Canvas size must match the submitted frame
+    uint32_t layer_mask;           // Layers drawn onto the screenshot and described in the sidecar
+    const char *directory;
+};
+
+struct overlay_exporter;
+
+struct overlay_exporter *exporter_create(void);
+
+// Finishes queued exports before returning
+void exporter_destroy(struct overlay_exporter *exporter);
+
+// Copies an RGBA frame and queues it. Returns false when EXPORT_MAX_QUEUED
+// exports are already waiting.
+bool exporter_submit(struct overlay_exporter *exporter, const uint8_t *data, uint32_t linesize,
+                     uint32_t width, uint32_t height, const struct export_request *request);
+
+#ifdef __cplusplus
+}
+#endif
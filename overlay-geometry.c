@@ -0,0 +1,508 @@
+#include "overlay-geometry.h"
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// Primitive list
+// ============================================================================
+
+void overlay_prims_init(struct overlay_prim_list *list)
+{
+    memset(list, 0, sizeof(*list));
+}
+
+void overlay_prims_free(struct overlay_prim_list *list)
+{
+    free(list->lines);
+    free(list->labels);
+    overlay_prims_init(list);
+}
+
+void overlay_prims_clear(struct overlay_prim_list *list)
+{
+    list->num = 0;
+    list->label_num = 0;
+    memset(list->layer_start, 0, sizeof(list->layer_start));
+    memset(list->layer_count, 0, sizeof(list->layer_count));
+    memset(list->label_layer_start, 0, sizeof(list->label_layer_start));
+    memset(list->label_layer_count, 0, sizeof(list->label_layer_count));
+}
+
+void overlay_prims_add_line(struct overlay_prim_list *list, float x1, float y1, float x2, float y2,
+                            uint32_t color, float opacity)
+{
+    if (list->num == list->capacity) {
+        const size_t capacity = list->capacity ? list->capacity * 2 : 256;
+        struct overlay_line *lines = realloc(list->lines, capacity * sizeof(struct overlay_line));
+        if (!lines) return;
+        
+        list->lines = lines;
+        list->capacity = capacity;
+    }
+    
+    float a = ((color >> 24) & 0xFF) / 255.0f;
+    a *= opacity;
+    a = fmaxf(0.0f, fminf(1.0f, a));
+    
+    struct overlay_line *line = &list->lines[list->num++];
+    line->x1 = x1;
+    line->y1 = y1;
+    line->x2 = x2;
+    line->y2 = y2;
+    line->color = ((uint32_t)(a * 255.0f + 0.5f) << 24) | (color & 0x00FFFFFF);
+}
+
+void overlay_prims_add_label(struct overlay_prim_list *list, float x, float y, float scale, int align,
+                             uint32_t color, float opacity, const char *format, ...)
+{
+    if (list->label_num == list->label_capacity) {
+        const size_t capacity = list->label_capacity ? list->label_capacity * 2 : 16;
+        struct overlay_label *labels = realloc(list->labels, capacity * sizeof(struct overlay_label));
+        if (!labels) return;
+        
+        list->labels = labels;
+        list->label_capacity = capacity;
+    }
+    
+    float a = ((color >> 24) & 0xFF) / 255.0f;
+    a = fmaxf(0.0f, fminf(1.0f, a * opacity));
+    
+    struct overlay_label *label = &list->labels[list->label_num++];
+    label->x = x;
+    label->y = y;
+    label->scale = scale;
+    label->align = align;
+    label->color = ((uint32_t)(a * 255.0f + 0.5f) << 24) | (color & 0x00FFFFFF);
+    
+    va_list args;
+    va_start(args, format);
+    vsnprintf(label->text, sizeof(label->text), format, args);
+    va_end(args);
+}
+
+// Whole font pixels: 2 at 1080p, 4 at 2160p, never below 1
+static float label_scale(const struct overlay_params *params)
+{
+    return fmaxf(1.0f, floorf((float)params->canvas_height / 540.0f));
+}
+
+// ============================================================================
+// Layout calculations
+// ============================================================================
+
+void overlay_compute_layout(const struct overlay_params *params, struct overlay_layout *layout)
+{
+    const float canvas_w = (float)params->canvas_width;
+    const float canvas_h = (float)params->canvas_height;
+    
+    // Bootstrap container calculation (exact 90% width, centered)
+    const int cols = params->bootstrap_columns > 0 ? params->bootstrap_columns : 1;
+    layout->columns = cols;
+    layout->gutter = params->bootstrap_gutter;
+    layout->container_w = floorf(canvas_w * 0.9f);
+    layout->column_w = floorf((layout->container_w - ((cols - 1) * layout->gutter)) / cols);
+    layout->container_x = floorf((canvas_w - layout->container_w) / 2.0f);
+    
+    // Safe zone presets
+    float percent;
+    switch (params->safe_zone_type) {
+        case 0: // Mobile
+            percent = 0.8f;
+            layout->safe_color = COLOR_SAFE_ORANGE;
+            break;
+        case 1: // Desktop
+            percent = 0.9f;
+            layout->safe_color = COLOR_SAFE_GREEN;
+            break;
+        case 2: // Broadcast SMPTE
+            percent = 0.93f;
+            layout->safe_color = COLOR_SAFE_ORANGE;
+            break;
+        case 3: // Custom
+            percent = params->custom_safe_zone_percent;
+            layout->safe_color = params->safe_zone_color;
+            break;
+        default:
+            percent = 0.9f;
+            layout->safe_color = COLOR_SAFE_GREEN;
+    }
+    
+    percent = fmaxf(0.1f, fminf(0.99f, percent));
+    
+    layout->safe_w = floorf(canvas_w * percent);
+    layout->safe_h = floorf(canvas_h * percent);
+    layout->safe_x = floorf((canvas_w - layout->safe_w) / 2.0f);
+    layout->safe_y = floorf((canvas_h - layout->safe_h) / 2.0f);
+    
+    // Precise mathematical positioning
+    layout->thirds[0] = floorf(canvas_w / 3.0f);
+    layout->thirds[1] = floorf(canvas_w * 2.0f / 3.0f);
+    layout->thirds[2] = floorf(canvas_h / 3.0f);
+    layout->thirds[3] = floorf(canvas_h * 2.0f / 3.0f);
+    
+    layout->center_x = floorf(canvas_w / 2.0f);
+    layout->center_y = floorf(canvas_h / 2.0f);
+}
+
+// ============================================================================
+// Layer generators
+// ============================================================================
+
+void geometry_material_grid(struct overlay_prim_list *list, const struct overlay_params *params)
+{
+    const int size = params->material_grid_size;
+    if (size <= 0) return;
+    
+    const uint32_t color = params->grid_color;
+    const float opacity = params->grid_opacity;
+    
+    // Coarser levels keep only the multiples of size * lod as major lines; the
+    // lines halfway between are the next finer level and are added, faded, only
+    // when the caller found them far enough apart. Everything finer is dropped
+    const int lod = params->grid_lod > 1 ? params->grid_lod : 1;
+    const bool halfway = lod > 1 && params->grid_halfway;
+    const int step = halfway ? size * lod / 2 : size * lod;
+    const float minor_opacity = opacity * GRID_MINOR_FADE;
+    
+    // Vertical lines
+    for (int i = 0, x = 0; x <= (int)params->canvas_width; i++, x += step) {
+        overlay_prims_add_line(list, (float)x, 0.0f, (float)x, (float)params->canvas_height,
+                        color, halfway && i % 2 ? minor_opacity : opacity);
+    }
+    
+    // Horizontal lines
+    for (int i = 0, y = 0; y <= (int)params->canvas_height; i++, y += step) {
+        overlay_prims_add_line(list, 0.0f, (float)y, (float)params->canvas_width, (float)y,
+                        color, halfway && i % 2 ? minor_opacity : opacity);
+    }
+}
+
+void geometry_bootstrap_grid(struct overlay_prim_list *list, const struct overlay_params *params)
+{
+    const int cols = params->bootstrap_columns;
+    const float gutter = params->bootstrap_gutter;
+    
+    if (cols <= 0) return;
+    
+    struct overlay_layout layout;
+    overlay_compute_layout(params, &layout);
+    const float container_w = layout.container_w;
+    const float col_w = layout.column_w;
+    const float start_x = layout.container_x;
+    
+    const uint32_t color = COLOR_BOOTSTRAP_PINK;
+    const float opacity = params->grid_opacity;
+    
+    // Container boundaries (outer lines)
+    overlay_prims_add_line(list, start_x, 0.0f, start_x, (float)params->canvas_height,
+                    color, opacity * 0.5f);
+    overlay_prims_add_line(list, start_x + container_w, 0.0f, start_x + container_w, (float)params->canvas_height,
+                    color, opacity * 0.5f);
+    
+    // Column dividers
+    for (int i = 1; i < cols; i++) {
+        float x = start_x + (i * (col_w + gutter));
+        overlay_prims_add_line(list, x, 0.0f, x, (float)params->canvas_height,
+                        color, opacity);
+    }
+}
+
+// Column widths along the top, gutter widths one line below; also used when
+// the shader draws the columns themselves
+void geometry_bootstrap_labels(struct overlay_prim_list *list, const struct overlay_params *params)
+{
+    if (!params->measurement_labels || params->bootstrap_columns <= 0) return;
+    
+    struct overlay_layout layout;
+    overlay_compute_layout(params, &layout);
+    const float scale = label_scale(params);
+    const float top = 2.0f * scale;
+    const float pitch = layout.column_w + layout.gutter;
+    
+    for (int i = 0; i < layout.columns; i++) {
+        const float x = layout.container_x + i * pitch;
+        overlay_prims_add_label(list, x + layout.column_w / 2.0f, top, scale, OVERLAY_ALIGN_CENTER,
+                                COLOR_BOOTSTRAP_PINK, 1.0f, "%d", (int)layout.column_w);
+        
+        if (i + 1 < layout.columns) {
+            overlay_prims_add_label(list, x + layout.column_w + layout.gutter / 2.0f,
+                                    top + OVERLAY_LABEL_LINE * scale, scale, OVERLAY_ALIGN_CENTER,
+                                    COLOR_BOOTSTRAP_PINK, 0.8f, "%d", (int)layout.gutter);
+        }
+    }
+}
+
+void geometry_safe_zones(struct overlay_prim_list *list, const struct overlay_params *params)
+{
+    struct overlay_layout layout;
+    overlay_compute_layout(params, &layout);
+    
+    const float safe_w = layout.safe_w;
+    const float safe_h = layout.safe_h;
+    const float margin_x = layout.safe_x;
+    const float margin_y = layout.safe_y;
+    const uint32_t color = layout.safe_color;
+    const float opacity = params->safe_zone_opacity;
+    
+    // Main safe zone rectangle
+    // Top
+    overlay_prims_add_line(list, margin_x, margin_y, margin_x + safe_w, margin_y,
+                    color, opacity);
+    // Right
+    overlay_prims_add_line(list, margin_x + safe_w, margin_y, margin_x + safe_w, margin_y + safe_h,
+                    color, opacity);
+    // Bottom
+    overlay_prims_add_line(list, margin_x + safe_w, margin_y + safe_h, margin_x, margin_y + safe_h,
+                    color, opacity);
+    // Left
+    overlay_prims_add_line(list, margin_x, margin_y + safe_h, margin_x, margin_y,
+                    color, opacity);
+    
+    // Corner markers for professional look
+    const float marker_size = 20.0f;
+    
+    // Top-left
+    overlay_prims_add_line(list, margin_x - marker_size, margin_y, margin_x + marker_size, margin_y,
+                    color, opacity);
+    overlay_prims_add_line(list, margin_x, margin_y - marker_size, margin_x, margin_y + marker_size,
+                    color, opacity);
+    
+    // Top-right
+    overlay_prims_add_line(list, margin_x + safe_w - marker_size, margin_y, margin_x + safe_w + marker_size, margin_y,
+                    color, opacity);
+    overlay_prims_add_line(list, margin_x + safe_w, margin_y - marker_size, margin_x + safe_w, margin_y + marker_size,
+                    color, opacity);
+    
+    // Bottom-right
+    overlay_prims_add_line(list, margin_x + safe_w - marker_size, margin_y + safe_h, margin_x + safe_w + marker_size, margin_y + safe_h,
+                    color, opacity);
+    overlay_prims_add_line(list, margin_x + safe_w, margin_y + safe_h - marker_size, margin_x + safe_w, margin_y + safe_h + marker_size,
+                    color, opacity);
+    
+    // Bottom-left
+    overlay_prims_add_line(list, margin_x - marker_size, margin_y + safe_h, margin_x + marker_size, margin_y + safe_h,
+                    color, opacity);
+    overlay_prims_add_line(list, margin_x, margin_y + safe_h - marker_size, margin_x, margin_y + safe_h + marker_size,
+                    color, opacity);
+    
+    if (!params->measurement_labels) return;
+    
+    // Margins centered in the gap at a quarter of the canvas, clear of the column labels
+    const float scale = label_scale(params);
+    const float text_h = 7.0f * scale;
+    if (margin_y >= text_h + 2.0f * scale) {
+        overlay_prims_add_label(list, (float)params->canvas_width * 0.25f, (margin_y - text_h) / 2.0f, scale,
+                                OVERLAY_ALIGN_CENTER, color, opacity, "%d", (int)margin_y);
+    }
+    if (margin_x >= 4.0f * 6.0f * scale) {
+        overlay_prims_add_label(list, margin_x / 2.0f, (float)params->canvas_height * 0.25f - text_h / 2.0f,
+                                scale, OVERLAY_ALIGN_CENTER, color, opacity, "%d", (int)margin_x);
+    }
+    
+    // Zone size inside the bottom-left corner
+    overlay_prims_add_label(list, margin_x + 4.0f * scale, margin_y + safe_h - text_h - 4.0f * scale, scale,
+                            OVERLAY_ALIGN_LEFT, color, opacity, "%dx%d", (int)safe_w, (int)safe_h);
+}
+
+void geometry_rule_of_thirds(struct overlay_prim_list *list, const struct overlay_params *params,
+                             bool include_lines)
+{
+    const uint32_t color = COLOR_CROSSHAIR_YELLOW;
+    const float opacity = params->crosshair_opacity * 0.6f;
+    
+    struct overlay_layout layout;
+    overlay_compute_layout(params, &layout);
+    const float third_x1 = layout.thirds[0];
+    const float third_x2 = layout.thirds[1];
+    const float third_y1 = layout.thirds[2];
+    const float third_y2 = layout.thirds[3];
+    
+    // Full-length lines come from the shader when the procedural engine is active
+    if (include_lines) {
+        // Vertical lines
+        overlay_prims_add_line(list, third_x1, 0.0f, third_x1, (float)params->canvas_height,
+                        color, opacity);
+        overlay_prims_add_line(list, third_x2, 0.0f, third_x2, (float)params->canvas_height,
+                        color, opacity);
+        
+        // Horizontal lines
+        overlay_prims_add_line(list, 0.0f, third_y1, (float)params->canvas_width, third_y1,
+                        color, opacity);
+        overlay_prims_add_line(list, 0.0f, third_y2, (float)params->canvas_width, third_y2,
+                        color, opacity);
+    }
+    
+    // Intersection dots for precision
+    const float dot_size = 4.0f;
+    
+    // Four intersection points
+    for (int i = 0; i < 2; i++) {
+        for (int j = 0; j < 2; j++) {
+            float x = (i == 0) ? third_x1 : third_x2;
+            float y = (j == 0) ? third_y1 : third_y2;
+            
+            // Small cross at intersection
+            overlay_prims_add_line(list, x - dot_size, y, x + dot_size, y,
+                           color, opacity);
+            overlay_prims_add_line(list, x, y - dot_size, x, y + dot_size,
+                           color, opacity);
+        }
+    }
+}
+
+void geometry_crosshair_marker(struct overlay_prim_list *list, float cx, float cy, float size,
+                               float opacity)
+{
+    const uint32_t color = COLOR_CROSSHAIR_YELLOW;
+    
+    // Main crosshair lines
+    overlay_prims_add_line(list, cx - size, cy, cx + size, cy,
+                    color, opacity);
+    overlay_prims_add_line(list, cx, cy - size, cx, cy + size,
+                    color, opacity);
+    
+    // Center dot
+    const float dot_size = size * 0.075f;
+    overlay_prims_add_line(list, cx - dot_size, cy, cx + dot_size, cy,
+                    color, opacity);
+    overlay_prims_add_line(list, cx, cy - dot_size, cx, cy + dot_size,
+                    color, opacity);
+    
+    // Tick marks for precision
+    const float tick_size = size * 0.2f;
+    const float tick_offset = size * 1.125f;
+    
+    // Horizontal ticks
+    overlay_prims_add_line(list, cx - tick_offset, cy - tick_size, cx - tick_offset, cy + tick_size,
+                    color, opacity * 0.7f);
+    overlay_prims_add_line(list, cx + tick_offset, cy - tick_size, cx + tick_offset, cy + tick_size,
+                    color, opacity * 0.7f);
+    
+    // Vertical ticks
+    overlay_prims_add_line(list, cx - tick_size, cy - tick_offset, cx + tick_size, cy - tick_offset,
+                    color, opacity * 0.7f);
+    overlay_prims_add_line(list, cx - tick_size, cy + tick_offset, cx + tick_size, cy + tick_offset,
+                    color, opacity * 0.7f);
+}
+
+void geometry_crosshair(struct overlay_prim_list *list, const struct overlay_params *params)
+{
+    struct overlay_layout layout;
+    overlay_compute_layout(params, &layout);
+    const float cx = layout.center_x;
+    const float cy = layout.center_y;
+    const uint32_t color = COLOR_CROSSHAIR_YELLOW;
+    const float opacity = params->crosshair_opacity;
+    
+    geometry_crosshair_marker(list, cx, cy, 40.0f, opacity);
+    
+    if (params->measurement_labels) {
+        const float scale = label_scale(params);
+        overlay_prims_add_label(list, cx + 4.0f * scale, cy + 4.0f * scale, scale, OVERLAY_ALIGN_LEFT,
+                                color, opacity, "%d, %d", (int)cx, (int)cy);
+    }
+}
+
+void geometry_center_guides(struct overlay_prim_list *list, const struct overlay_params *params)
+{
+    struct overlay_layout layout;
+    overlay_compute_layout(params, &layout);
+    const float cx = layout.center_x;
+    const float cy = layout.center_y;
+    const uint32_t color = COLOR_GUIDE_GRAY;
+    const float opacity = params->crosshair_opacity * 0.4f;
+    
+    // Full-screen center lines
+    overlay_prims_add_line(list, cx, 0.0f, cx, (float)params->canvas_height,
+                    color, opacity);
+    overlay_prims_add_line(list, 0.0f, cy, (float)params->canvas_width, cy,
+                    color, opacity);
+}
+
+void geometry_branding(struct overlay_prim_list *list, const struct overlay_params *params)
+{
+    const float margin = 20.0f;
+    const float scale = label_scale(params);
+    
+    overlay_prims_add_label(list, (float)params->canvas_width - margin,
+                            (float)params->canvas_height - margin - 7.0f * scale, scale, OVERLAY_ALIGN_RIGHT,
+                            COLOR_BRAND_BLUE, 0.7f, "design.rip");
+}
+
+void geometry_custom_layout(struct overlay_prim_list *list, const struct overlay_params *params)
+{
+    const float sx = params->custom_scale_x;
+    const float sy = params->custom_scale_y;
+    
+    // Colors come from the layout file with opacity already baked in
+    for (size_t i = 0; i < params->custom_line_count; i++) {
+        const struct overlay_line *line = &params->custom_lines[i];
+        overlay_prims_add_line(list, line->x1 * sx, line->y1 * sy, line->x2 * sx, line->y2 * sy,
+                               line->color, 1.0f);
+    }
+}
+
+// ============================================================================
+// Whole overlay
+// ============================================================================
+
+void geometry_build_layer(struct overlay_prim_list *list, const struct overlay_params *params,
+                          enum overlay_layer layer, uint32_t flags)
+{
+    const bool procedural = (flags & GEOMETRY_SKIP_PROCEDURAL) != 0;
+    
+    list->layer_start[layer] = list->num;
+    list->label_layer_start[layer] = list->label_num;
+    
+    switch (layer) {
+        case OVERLAY_LAYER_CENTER_GUIDES:
+            geometry_center_guides(list, params);
+            break;
+        case OVERLAY_LAYER_RULE_OF_THIRDS:
+            geometry_rule_of_thirds(list, params, !procedural);
+            break;
+        case OVERLAY_LAYER_MATERIAL_GRID:
+            if (!procedural) geometry_material_grid(list, params);
+            break;
+        case OVERLAY_LAYER_BOOTSTRAP_GRID:
+            if (!procedural) geometry_bootstrap_grid(list, params);
+            geometry_bootstrap_labels(list, params);
+            break;
+        case OVERLAY_LAYER_SAFE_ZONES:
+            geometry_safe_zones(list, params);
+            break;
+        case OVERLAY_LAYER_CUSTOM:
+            geometry_custom_layout(list, params);
+            break;
+        case OVERLAY_LAYER_CROSSHAIR:
+            geometry_crosshair(list, params);
+            break;
+        case OVERLAY_LAYER_BRANDING:
+            geometry_branding(list, params);
+            break;
+        default:
+            break;
+    }
+    
+    list->layer_count[layer] = list->num - list->layer_start[layer];
+    list->label_layer_count[layer] = list->label_num - list->label_layer_start[layer];
+}
+
+void geometry_build(struct overlay_prim_list *list, const struct overlay_params *params,
+                    uint32_t layer_mask, uint32_t flags)
+{
+    overlay_prims_clear(list);
+    
+    for (int layer = 0; layer < OVERLAY_LAYER_COUNT; layer++) {
+        if (layer_mask & OVERLAY_LAYER_BIT(layer)) {
+            geometry_build_layer(list, params, (enum overlay_layer)layer, flags);
+        } else {
+            list->layer_start[layer] = list->num;
+            list->label_layer_start[layer] = list->label_num;
+        }
+    }
+}
@@ -0,0 +1,179 @@
+#pragma once
+
+// Backend-neutral overlay geometry.
+// Layer generators emit plain line primitives; nothing here depends on libobs,
+// so the same geometry feeds the GPU vertex buffer and the CPU rasterizer.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Professional color constants (0xAARRGGBB)
+#define COLOR_GRID_BLUE       0xFF0096FF  // Material Design Blue
+#define COLOR_BOOTSTRAP_PINK  0xFFFF0096  // Bootstrap Pink
+#define COLOR_SAFE_ORANGE     0xFFFF6B35  // Safe Zone Orange
+#define COLOR_SAFE_GREEN      0xFF4CAF50  // Desktop Safe Green
+#define COLOR_CROSSHAIR_YELLOW 0xFFFFFF00 // Bright Yellow
+#define COLOR_BRAND_BLUE      0xFF00D4FF  // Brand Blue
+#define COLOR_GUIDE_GRAY      0xFF888888  // Center guide Gray
+#define COLOR_ANALYZER_OFF_GRID 0xFFFF00FF // Off-grid Magenta
+#define COLOR_ANALYZER_UNSAFE 0xFFFF1744  // Outside safe zone Red
+
+// Layers in draw order
+enum overlay_layer {
+    OVERLAY_LAYER_CENTER_GUIDES,
+    OVERLAY_LAYER_RULE_OF_THIRDS,
+    OVERLAY_LAYER_MATERIAL_GRID,
+    OVERLAY_LAYER_BOOTSTRAP_GRID,
+    OVERLAY_LAYER_SAFE_ZONES,
+    OVERLAY_LAYER_CUSTOM,
+    OVERLAY_LAYER_CROSSHAIR,
+    OVERLAY_LAYER_BRANDING,
+    OVERLAY_LAYER_COUNT
+};
+
+#define OVERLAY_LAYER_BIT(layer) (1u << (layer))
+
+// Label text limit and line pitch in font pixels (7px glyphs, see overlay-text.h)
+#define OVERLAY_LABEL_MAX  32
+#define OVERLAY_LABEL_LINE 10
+
+// Grid level of detail: lines closer than this many output pixels are merged
+// into coarser power-of-two multiples; the level halfway between major lines is
+// kept at GRID_MINOR_FADE only while it is still this far apart
+#define GRID_LOD_MIN_SPACING 4.0f
+#define GRID_LOD_MAX         64
+#define GRID_MINOR_FADE      0.35f
+
+// Build flags
+#define GEOMETRY_SKIP_PROCEDURAL (1u << 0)  // Grid/column/thirds lines come from the shader
+
+struct overlay_line;
+
+// Everything the layer generators read
+struct overlay_params {
+    uint32_t canvas_width;
+    uint32_t canvas_height;
+
+    int material_grid_size;
+    int grid_lod;                    // Material grid level of detail: 2^n steps per major line, 0/1 = all
+    bool grid_halfway;               // Also draw the faded lines halfway between major lines
+    int bootstrap_columns;
+    float bootstrap_gutter;
+    int safe_zone_type;
+    float custom_safe_zone_percent;  // 0..1
+
+    float grid_opacity;              // 0..1
+    float safe_zone_opacity;
+    float crosshair_opacity;
+    uint32_t grid_color;
+    uint32_t safe_zone_color;
+    bool measurement_labels;         // Pixel measurements next to grids, zones and crosshair
+
+    // Custom layout lines in reference pixels, scaled onto the canvas (see overlay-layout-file.h)
+    uint64_t custom_layout_id;  // Content hash, so cache keys never match a freed layout's address
+    const struct overlay_line *custom_lines;
+    size_t custom_line_count;
+    float custom_scale_x;
+    float custom_scale_y;
+};
+
+// Derived positions shared by geometry, shaders and exports
+struct overlay_layout {
+    // Bootstrap container (exact 90% width, centered)
+    float container_x;
+    float container_w;
+    float column_w;
+    float gutter;
+    int columns;
+
+    // Safe zone rectangle
+    float safe_x;
+    float safe_y;
+    float safe_w;
+    float safe_h;
+    uint32_t safe_color;
+
+    // Rule of thirds (x1, x2, y1, y2) and center
+    float thirds[4];
+    float center_x;
+    float center_y;
+};
+
+struct overlay_line {
+    float x1, y1;
+    float x2, y2;
+    uint32_t color;  // 0xAARRGGBB, opacity already applied to alpha
+};
+
+enum overlay_align {
+    OVERLAY_ALIGN_LEFT,
+    OVERLAY_ALIGN_CENTER,
+    OVERLAY_ALIGN_RIGHT
+};
+
+struct overlay_label {
+    float x, y;      // Anchor, y is the top of the text
+    float scale;     // Canvas pixels per font pixel
+    uint32_t color;  // 0xAARRGGBB, opacity already applied to alpha
+    int align;       // enum overlay_align
+    char text[OVERLAY_LABEL_MAX];
+};
+
+struct overlay_prim_list {
+    struct overlay_line *lines;
+    size_t num;
+    size_t capacity;
+
+    struct overlay_label *labels;
+    size_t label_num;
+    size_t label_capacity;
+
+    // Per-layer line and label ranges of the last geometry_build()
+    size_t layer_start[OVERLAY_LAYER_COUNT];
+    size_t layer_count[OVERLAY_LAYER_COUNT];
+    size_t label_layer_start[OVERLAY_LAYER_COUNT];
+    size_t label_layer_count[OVERLAY_LAYER_COUNT];
+};
+
+void overlay_prims_init(struct overlay_prim_list *list);
+void overlay_prims_free(struct overlay_prim_list *list);
+void overlay_prims_clear(struct overlay_prim_list *list);
+void overlay_prims_add_line(struct overlay_prim_list *list, float x1, float y1, float x2, float y2,
+                            uint32_t color, float opacity);
+void overlay_prims_add_label(struct overlay_prim_list *list, float x, float y, float scale, int align,
+                             uint32_t color, float opacity, const char *format, ...);
+
+void overlay_compute_layout(const struct overlay_params *params, struct overlay_layout *layout);
+
+// Layer generators
+void geometry_material_grid(struct overlay_prim_list *list, const struct overlay_params *params);
+void geometry_bootstrap_grid(struct overlay_prim_list *list, const struct overlay_params *params);
+void geometry_bootstrap_labels(struct overlay_prim_list *list, const struct overlay_params *params);
+void geometry_safe_zones(struct overlay_prim_list *list, const struct overlay_params *params);
+void geometry_rule_of_thirds(struct overlay_prim_list *list, const struct overlay_params *params,
+                             bool include_lines);
+void geometry_crosshair(struct overlay_prim_list *list, const struct overlay_params *params);
+void geometry_center_guides(struct overlay_prim_list *list, const struct overlay_params *params);
+void geometry_branding(struct overlay_prim_list *list, const struct overlay_params *params);
+void geometry_custom_layout(struct overlay_prim_list *list, const struct overlay_params *params);
+
+// Crosshair lines, center dot and ticks around (cx, cy); size is the arm length
+void geometry_crosshair_marker(struct overlay_prim_list *list, float cx, float cy, float size,
+                               float opacity);
+
+// Appends one layer and records its range in the list
+void geometry_build_layer(struct overlay_prim_list *list, const struct overlay_params *params,
+                          enum overlay_layer layer, uint32_t flags);
+
+// Clears the list and generates every layer in layer_mask, in draw order
+void geometry_build(struct overlay_prim_list *list, const struct overlay_params *params,
+                    uint32_t layer_mask, uint32_t flags);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,575 @@
+#include "overlay-layout-file.h"
+
+#include <obs.h>
+#include <util/bmem.h>
+#include <util/dstr.h>
+#include <util/platform.h>
+#include <util/threading.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define LAYOUT_CACHE_MAGIC   0x424C4F44  // "DOLB"
+#define LAYOUT_CACHE_VERSION 1
+#define LAYOUT_CACHE_SUFFIX  ".bin"
+
+// Keep a runaway "spacing" grid from producing millions of lines
+#define LAYOUT_MAX_LINES       65536
+#define LAYOUT_MAX_BREAKPOINTS 32
+
+// Cache file: header, breakpoint table, then every breakpoint's lines back to back.
+// Native byte order; a foreign file fails the magic check and is recompiled.
+struct layout_cache_header {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t source_hash;  // FNV-1a of the JSON text it was compiled from
+    uint32_t reference_width;
+    uint32_t reference_height;
+    uint32_t breakpoint_count;
+    uint32_t line_count;
+};
+
+struct layout_breakpoint {
+    uint32_t min_width;
+    uint32_t first_line;
+    uint32_t line_count;
+    uint32_t reserved;
+};
+
+struct layout_file {
+    struct layout_file *next;
+    char *path;
+    uint64_t source_hash;
+    long refs;
+
+    // Either a read-only view of the cache file or a heap copy of the same bytes
+    void *data;
+    size_t size;
+    bool mapped;
+
+    const struct layout_cache_header *header;
+    const struct layout_breakpoint *breakpoints;
+    const struct overlay_line *lines;
+};
+
+// Loaded layouts, shared by every source that names the same unchanged file
+static pthread_mutex_t registry_mutex = PTHREAD_MUTEX_INITIALIZER;
+static struct layout_file *registry_head = NULL;
+
+static uint64_t hash_text(const char *text)
+{
+    // FNV-1a
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    
+    for (const uint8_t *p = (const uint8_t *)text; *p; p++) {
+        hash ^= *p;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+// ============================================================================
+// File mapping
+// ============================================================================
+
+static void *map_file(const char *path, size_t *size)
+{
+#ifdef _WIN32
+    wchar_t *wpath = NULL;
+    if (!os_utf8_to_wcs_ptr(path, 0, &wpath)) return NULL;
+    
+    HANDLE file = CreateFileW(wpath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, NULL);
+    bfree(wpath);
+    if (file == INVALID_HANDLE_VALUE) return NULL;
+    
+    void *data = NULL;
+    LARGE_INTEGER file_size;
+    if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0) {
+        HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping) {
+            // The view keeps the mapping alive after both handles are closed
+            data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+        }
+        *size = (size_t)file_size.QuadPart;
+    }
+    
+    CloseHandle(file);
+    return data;
+#else
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return NULL;
+    
+    void *data = NULL;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) data = NULL;
+        *size = (size_t)st.st_size;
+    }
+    
+    close(fd);
+    return data;
+#endif
+}
+
+static void unmap_file(void *data, size_t size)
+{
+#ifdef _WIN32
+    UNUSED_PARAMETER(size);
+    UnmapViewOfFile(data);
+#else
+    munmap(data, size);
+#endif
+}
+
+// Points the table pointers into layout->data, false if the bytes are not a usable cache
+static bool attach_cache(struct layout_file *layout)
+{
+    if (layout->size < sizeof(struct layout_cache_header)) return false;
+    
+    const struct layout_cache_header *header = layout->data;
+    if (header->magic != LAYOUT_CACHE_MAGIC || header->version != LAYOUT_CACHE_VERSION) return false;
+    if (header->source_hash != layout->source_hash) return false;
+    if (header->breakpoint_count == 0 || header->breakpoint_count > LAYOUT_MAX_BREAKPOINTS) return false;
+    if (header->line_count > LAYOUT_MAX_LINES) return false;
+    if (!header->reference_width || !header->reference_height) return false;
+    
+    const size_t table_size = sizeof(struct layout_breakpoint) * header->breakpoint_count;
+    const size_t expected = sizeof(*header) + table_size + sizeof(struct overlay_line) * header->line_count;
+    if (layout->size != expected) return false;
+    
+    const struct layout_breakpoint *breakpoints = (const void *)(header + 1);
+    for (uint32_t i = 0; i < header->breakpoint_count; i++) {
+        const struct layout_breakpoint *bp = &breakpoints[i];
+        if (bp->first_line > header->line_count || bp->line_count > header->line_count - bp->first_line) {
+            return false;
+        }
+    }
+    
+    layout->header = header;
+    layout->breakpoints = breakpoints;
+    layout->lines = (const void *)((const uint8_t *)breakpoints + table_size);
+    return true;
+}
+
+// ============================================================================
+// Compiler
+// ============================================================================
+
+static bool parse_hex_color(const char *text, uint32_t *color)
+{
+    if (!text || text[0] != '#') return false;
+    
+    const size_t len = strlen(text + 1);
+    if (len != 6 && len != 8) return false;
+    
+    char *end;
+    const unsigned long value = strtoul(text + 1, &end, 16);
+    if (*end) return false;
+    
+    *color = len == 6 ? 0xFF000000 | (uint32_t)value : (uint32_t)value;
+    return true;
+}
+
+// "#RRGGBB", "#AARRGGBB" or a name from the "colors" table
+static uint32_t item_color(obs_data_t *item, obs_data_t *palette, uint32_t fallback)
+{
+    const char *text = obs_data_get_string(item, "color");
+    if (!text || !*text) return fallback;
+    
+    uint32_t color;
+    if (parse_hex_color(text, &color)) return color;
+    if (palette && parse_hex_color(obs_data_get_string(palette, text), &color)) return color;
+    
+    blog(LOG_WARNING, "[Design Overlay] Layout color '%s' is not a hex color or palette name", text);
+    return fallback;
+}
+
+static float item_opacity(obs_data_t *item)
+{
+    return obs_data_has_user_value(item, "opacity") ? (float)obs_data_get_double(item, "opacity") : 1.0f;
+}
+
+struct layout_compiler {
+    struct overlay_prim_list lines;
+    obs_data_t *palette;
+    uint32_t default_color;
+    float ref_w;
+    float ref_h;
+    bool truncated;
+};
+
+static void emit_line(struct layout_compiler *c, float x1, float y1, float x2, float y2, uint32_t color,
+                      float opacity)
+{
+    if (c->lines.num >= LAYOUT_MAX_LINES) {
+        c->truncated = true;
+        return;
+    }
+    overlay_prims_add_line(&c->lines, x1, y1, x2, y2, color, opacity);
+}
+
+static void compile_guides(struct layout_compiler *c, obs_data_array_t *guides)
+{
+    const size_t count = obs_data_array_count(guides);
+    for (size_t i = 0; i < count; i++) {
+        obs_data_t *guide = obs_data_array_item(guides, i);
+        const uint32_t color = item_color(guide, c->palette, c->default_color);
+        const float opacity = item_opacity(guide);
+        
+        if (obs_data_has_user_value(guide, "x")) {
+            const float x = (float)obs_data_get_double(guide, "x");
+            emit_line(c, x, 0.0f, x, c->ref_h, color, opacity);
+        }
+        if (obs_data_has_user_value(guide, "y")) {
+            const float y = (float)obs_data_get_double(guide, "y");
+            emit_line(c, 0.0f, y, c->ref_w, y, color, opacity);
+        }
+        
+        obs_data_release(guide);
+    }
+}
+
+static void compile_zones(struct layout_compiler *c, obs_data_array_t *zones)
+{
+    const size_t count = obs_data_array_count(zones);
+    for (size_t i = 0; i < count; i++) {
+        obs_data_t *zone = obs_data_array_item(zones, i);
+        const uint32_t color = item_color(zone, c->palette, c->default_color);
+        const float opacity = item_opacity(zone);
+        const float x = (float)obs_data_get_double(zone, "x");
+        const float y = (float)obs_data_get_double(zone, "y");
+        const float w = (float)obs_data_get_double(zone, "width");
+        const float h = (float)obs_data_get_double(zone, "height");
+        
+        if (w > 0.0f && h > 0.0f) {
+            emit_line(c, x, y, x + w, y, color, opacity);
+            emit_line(c, x + w, y, x + w, y + h, color, opacity);
+            emit_line(c, x + w, y + h, x, y + h, color, opacity);
+            emit_line(c, x, y + h, x, y, color, opacity);
+        }
+        
+        obs_data_release(zone);
+    }
+}
+
+static void compile_grids(struct layout_compiler *c, obs_data_array_t *grids)
+{
+    const size_t count = obs_data_array_count(grids);
+    for (size_t i = 0; i < count; i++) {
+        obs_data_t *grid = obs_data_array_item(grids, i);
+        const uint32_t color = item_color(grid, c->palette, c->default_color);
+        const float opacity = item_opacity(grid);
+        
+        if (obs_data_has_user_value(grid, "spacing")) {
+            // Uniform square grid
+            const float spacing = (float)obs_data_get_double(grid, "spacing");
+            if (spacing >= 2.0f) {
+                for (float x = 0.0f; x <= c->ref_w; x += spacing) emit_line(c, x, 0.0f, x, c->ref_h, color, opacity);
+                for (float y = 0.0f; y <= c->ref_h; y += spacing) emit_line(c, 0.0f, y, c->ref_w, y, color, opacity);
+            }
+        } else {
+            // Column grid, every column edge inside the centered container
+            const int columns = (int)obs_data_get_int(grid, "columns");
+            const float gutter = (float)obs_data_get_double(grid, "gutter");
+            const float margin = obs_data_has_user_value(grid, "margin")
+                                     ? (float)obs_data_get_double(grid, "margin")
+                                     : c->ref_w * 0.05f;
+            const float container_w = c->ref_w - 2.0f * margin;
+            const float column_w = columns > 0 ? (container_w - (columns - 1) * gutter) / columns : 0.0f;
+            
+            if (column_w > 0.0f) {
+                for (int col = 0; col < columns; col++) {
+                    const float x = margin + col * (column_w + gutter);
+                    emit_line(c, x, 0.0f, x, c->ref_h, color, opacity);
+                    emit_line(c, x + column_w, 0.0f, x + column_w, c->ref_h, color, opacity);
+                }
+            }
+        }
+        
+        obs_data_release(grid);
+    }
+}
+
+static void compile_items(struct layout_compiler *c, obs_data_t *items)
+{
+    obs_data_array_t *grids = obs_data_get_array(items, "grids");
+    obs_data_array_t *zones = obs_data_get_array(items, "zones");
+    obs_data_array_t *guides = obs_data_get_array(items, "guides");
+    
+    // Grids underneath zones and guides
+    if (grids) compile_grids(c, grids);
+    if (zones) compile_zones(c, zones);
+    if (guides) compile_guides(c, guides);
+    
+    obs_data_array_release(guides);
+    obs_data_array_release(zones);
+    obs_data_array_release(grids);
+}
+
+struct breakpoint_entry {
+    uint32_t min_width;
+    obs_data_t *items;
+};
+
+static int compare_breakpoints(const void *a, const void *b)
+{
+    const struct breakpoint_entry *x = a;
+    const struct breakpoint_entry *y = b;
+    return (x->min_width > y->min_width) - (x->min_width < y->min_width);
+}
+
+// Parses the JSON text into the cache layout, in a heap buffer owned by the caller
+static void *compile_layout(const char *path, const char *text, uint64_t source_hash, size_t *size)
+{
+    obs_data_t *root = obs_data_create_from_json(text);
+    if (!root) {
+        blog(LOG_WARNING, "[Design Overlay] Layout '%s' is not valid JSON", path);
+        return NULL;
+    }
+    
+    struct layout_compiler c;
+    memset(&c, 0, sizeof(c));
+    overlay_prims_init(&c.lines);
+    c.palette = obs_data_get_obj(root, "colors");
+    c.ref_w = (float)obs_data_get_int(root, "reference_width");
+    c.ref_h = (float)obs_data_get_int(root, "reference_height");
+    if (c.ref_w < 1.0f) c.ref_w = 1920.0f;
+    if (c.ref_h < 1.0f) c.ref_h = 1080.0f;
+    c.default_color = item_color(root, c.palette, COLOR_GUIDE_GRAY);
+    
+    // Entry 0 is the top level, active at every width
+    struct breakpoint_entry entries[LAYOUT_MAX_BREAKPOINTS];
+    size_t entry_count = 1;
+    entries[0].min_width = 0;
+    entries[0].items = root;
+    
+    obs_data_array_t *breakpoints = obs_data_get_array(root, "breakpoints");
+    const size_t breakpoint_count = breakpoints ? obs_data_array_count(breakpoints) : 0;
+    for (size_t i = 0; i < breakpoint_count && entry_count < LAYOUT_MAX_BREAKPOINTS; i++) {
+        obs_data_t *bp = obs_data_array_item(breakpoints, i);
+        const long long min_width = obs_data_get_int(bp, "min_width");
+        if (min_width <= 0) {
+            blog(LOG_WARNING, "[Design Overlay] Layout '%s': breakpoint %zu has no min_width", path, i);
+            obs_data_release(bp);
+            continue;
+        }
+        entries[entry_count].min_width = (uint32_t)min_width;
+        entries[entry_count].items = bp;
+        entry_count++;
+    }
+    qsort(entries + 1, entry_count - 1, sizeof(entries[0]), compare_breakpoints);
+    
+    // Each breakpoint is stored whole (top level plus its own items) so a lookup is one range
+    struct layout_breakpoint table[LAYOUT_MAX_BREAKPOINTS];
+    memset(table, 0, sizeof(table));
+    for (size_t i = 0; i < entry_count; i++) {
+        table[i].min_width = entries[i].min_width;
+        table[i].first_line = (uint32_t)c.lines.num;
+        compile_items(&c, root);
+        if (i > 0) compile_items(&c, entries[i].items);
+        table[i].line_count = (uint32_t)c.lines.num - table[i].first_line;
+    }
+    
+    if (c.truncated) {
+        blog(LOG_WARNING, "[Design Overlay] Layout '%s' exceeds %d lines and was truncated", path,
+             LAYOUT_MAX_LINES);
+    }
+    
+    struct layout_cache_header header;
+    memset(&header, 0, sizeof(header));
+    header.magic = LAYOUT_CACHE_MAGIC;
+    header.version = LAYOUT_CACHE_VERSION;
+    header.source_hash = source_hash;
+    header.reference_width = (uint32_t)c.ref_w;
+    header.reference_height = (uint32_t)c.ref_h;
+    header.breakpoint_count = (uint32_t)entry_count;
+    header.line_count = (uint32_t)c.lines.num;
+    
+    const size_t table_size = sizeof(struct layout_breakpoint) * entry_count;
+    const size_t lines_size = sizeof(struct overlay_line) * c.lines.num;
+    *size = sizeof(header) + table_size + lines_size;
+    
+    uint8_t *data = bmalloc(*size);
+    memcpy(data, &header, sizeof(header));
+    memcpy(data + sizeof(header), table, table_size);
+    if (lines_size) memcpy(data + sizeof(header) + table_size, c.lines.lines, lines_size);
+    
+    for (size_t i = 1; i < entry_count; i++) obs_data_release(entries[i].items);
+    obs_data_array_release(breakpoints);
+    obs_data_release(c.palette);
+    obs_data_release(root);
+    overlay_prims_free(&c.lines);
+    return data;
+}
+
+// Written under a temporary name and renamed, so sources still mapping the old
+// cache keep their pages and nobody ever maps a half-written file
+static void write_cache(const char *cache_path, const void *data, size_t size)
+{
+    struct dstr temp_path;
+    dstr_init_copy(&temp_path, cache_path);
+    dstr_cat(&temp_path, ".tmp");
+    
+    FILE *file = os_fopen(temp_path.array, "wb");
+    bool ok = file && fwrite(data, 1, size, file) == size;
+    if (file && fclose(file) != 0) ok = false;
+    
+    if (ok && os_rename(temp_path.array, cache_path) != 0) ok = false;
+    if (!ok) {
+        os_unlink(temp_path.array);
+        blog(LOG_DEBUG, "[Design Overlay] Could not write layout cache '%s'", cache_path);
+    }
+    
+    dstr_free(&temp_path);
+}
+
+static void free_layout(struct layout_file *layout)
+{
+    if (layout->mapped) {
+        unmap_file(layout->data, layout->size);
+    } else {
+        bfree(layout->data);
+    }
+    bfree(layout->path);
+    bfree(layout);
+}
+
+static struct layout_file *load_layout(const char *path, const char *text, uint64_t source_hash)
+{
+    struct layout_file *layout = bzalloc(sizeof(struct layout_file));
+    layout->path = bstrdup(path);
+    layout->source_hash = source_hash;
+    layout->refs = 1;
+    
+    struct dstr cache_path;
+    dstr_init_copy(&cache_path, path);
+    dstr_cat(&cache_path, LAYOUT_CACHE_SUFFIX);
+    
+    const uint64_t start_ns = os_gettime_ns();
+    const char *origin = "cache";
+    
+    layout->data = map_file(cache_path.array, &layout->size);
+    layout->mapped = layout->data != NULL;
+    
+    if (!layout->mapped || !attach_cache(layout)) {
+        if (layout->mapped) unmap_file(layout->data, layout->size);
+        layout->mapped = false;
+        
+        layout->data = compile_layout(path, text, source_hash, &layout->size);
+        if (!layout->data || !attach_cache(layout)) {
+            dstr_free(&cache_path);
+            free_layout(layout);
+            return NULL;
+        }
+        
+        write_cache(cache_path.array, layout->data, layout->size);
+        origin = "source";
+    }
+    
+    blog(LOG_INFO, "[Design Overlay] Loaded layout '%s' from %s: %u lines, %u breakpoint(s) in %.2f ms",
+         path, origin, layout->header->line_count, layout->header->breakpoint_count - 1,
+         (double)(os_gettime_ns() - start_ns) / 1000000.0);
+    
+    dstr_free(&cache_path);
+    return layout;
+}
+
+// ============================================================================
+// Public interface
+// ============================================================================
+
+struct layout_file *layout_file_acquire(const char *path)
+{
+    if (!path || !*path) return NULL;
+    
+    // The text is needed anyway to know whether the cache is current
+    char *text = os_quick_read_utf8_file(path);
+    if (!text) {
+        blog(LOG_WARNING, "[Design Overlay] Cannot read layout '%s'", path);
+        return NULL;
+    }
+    
+    const uint64_t source_hash = hash_text(text);
+    
+    pthread_mutex_lock(&registry_mutex);
+    
+    struct layout_file *layout = registry_head;
+    while (layout && (layout->source_hash != source_hash || strcmp(layout->path, path) != 0)) {
+        layout = layout->next;
+    }
+    
+    if (layout) {
+        layout->refs++;
+    } else {
+        layout = load_layout(path, text, source_hash);
+        if (layout) {
+            layout->next = registry_head;
+            registry_head = layout;
+        }
+    }
+    
+    pthread_mutex_unlock(&registry_mutex);
+    bfree(text);
+    return layout;
+}
+
+void layout_file_addref(struct layout_file *layout)
+{
+    if (!layout) return;
+    
+    pthread_mutex_lock(&registry_mutex);
+    layout->refs++;
+    pthread_mutex_unlock(&registry_mutex);
+}
+
+void layout_file_release(struct layout_file *layout)
+{
+    if (!layout) return;
+    
+    pthread_mutex_lock(&registry_mutex);
+    const bool last = --layout->refs == 0;
+    if (last) {
+        struct layout_file **link = &registry_head;
+        while (*link != layout) link = &(*link)->next;
+        *link = layout->next;
+    }
+    pthread_mutex_unlock(&registry_mutex);
+    
+    if (last) free_layout(layout);
+}
+
+const struct overlay_line *layout_file_lines(const struct layout_file *layout, uint32_t canvas_width,
+                                             size_t *count)
+{
+    // Sorted by min_width and entry 0 is 0, so the last match is the widest that fits
+    const struct layout_breakpoint *match = &layout->breakpoints[0];
+    for (uint32_t i = 1; i < layout->header->breakpoint_count; i++) {
+        if (layout->breakpoints[i].min_width <= canvas_width) match = &layout->breakpoints[i];
+    }
+    
+    *count = match->line_count;
+    return layout->lines + match->first_line;
+}
+
+void layout_file_reference_size(const struct layout_file *layout, uint32_t *width, uint32_t *height)
+{
+    *width = layout->header->reference_width;
+    *height = layout->header->reference_height;
+}
+
+uint64_t layout_file_id(const struct layout_file *layout)
+{
+    return layout->source_hash;
+}
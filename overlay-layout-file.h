@@ -0,0 +1,45 @@
+#pragma once
+
+// Declarative custom layouts.
+// A JSON layout file (guides, zones, grids and width breakpoints) is compiled
+// once into flat line arrays and cached as "<file>.bin" next to it. Later
+// loads map the binary directly as long as the JSON text is unchanged.
+//
+// {
+//     "reference_width": 1920, "reference_height": 1080,
+//     "colors": {"brand": "#00D4FF"},
+//     "guides": [{"x": 96}, {"y": 540, "color": "brand", "opacity": 0.5}],
+//     "zones": [{"x": 96, "y": 54, "width": 1728, "height": 972, "color": "#4CAF50"}],
+//     "grids": [{"columns": 12, "gutter": 24, "margin": 96}, {"spacing": 8, "color": "#400096FF"}],
+//     "breakpoints": [{"min_width": 3840, "guides": [...], "zones": [...], "grids": [...]}]
+// }
+//
+// Coordinates are reference canvas pixels. A breakpoint adds its items to the
+// top-level ones when the canvas is at least min_width pixels wide.
+
+#include "overlay-geometry.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct layout_file;
+
+// Loads (or shares an already loaded) layout, NULL if the file is missing or invalid.
+// Any thread; the file is re-read to detect edits, so call it from update, not per frame.
+struct layout_file *layout_file_acquire(const char *path);
+void layout_file_addref(struct layout_file *layout);
+void layout_file_release(struct layout_file *layout);
+
+// Lines of the breakpoint matching canvas_width, in reference pixels.
+// Valid until the layout is released.
+const struct overlay_line *layout_file_lines(const struct layout_file *layout, uint32_t canvas_width,
+                                             size_t *count);
+void layout_file_reference_size(const struct layout_file *layout, uint32_t *width, uint32_t *height);
+
+// Hash of the JSON text, identical for identical layouts
+uint64_t layout_file_id(const struct layout_file *layout);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,416 @@
+#include "overlay-palette.h"
+
+#include <util/bmem.h>
+#include <util/threading.h>
+#include <util/sse-intrin.h>
+#include <float.h>
+#include <string.h>
+
+// 4 bits per channel
+#define HISTOGRAM_BINS 4096
+#define MAX_PIXELS (PALETTE_MAX_SAMPLE * PALETTE_MAX_SAMPLE)
+#define MAX_ITERATIONS 12
+
+// Unused centroid slots sit far outside the RGB cube so they are never nearest
+#define UNUSED_CENTROID 1.0e9f
+
+struct centroids {
+    float r[PALETTE_MAX_COLORS];
+    float g[PALETTE_MAX_COLORS];
+    float b[PALETTE_MAX_COLORS];
+    float weight[PALETTE_MAX_COLORS];
+};
+
+struct overlay_palette {
+    pthread_t thread;
+    bool thread_created;
+    os_event_t *work_event;
+    volatile bool exiting;
+    volatile bool busy;
+
+    // Input frame, owned by the worker while busy
+    uint32_t width;
+    uint32_t height;
+    int colors;
+
+    // Arena, carved once in palette_create
+    void *arena;
+    uint8_t *frame;          // MAX_PIXELS RGBA pixels
+    uint32_t *bin_index;     // Quantized pixels
+    uint32_t *bin_count;     // HISTOGRAM_BINS entries
+    uint32_t *bin_sum;       // HISTOGRAM_BINS x RGB channel sums
+    float *point_r;          // Occupied bins, mean color and pixel count
+    float *point_g;
+    float *point_b;
+    float *point_weight;
+    uint8_t *assignment;
+
+    // Published results
+    pthread_mutex_t result_mutex;
+    struct palette_swatch swatches[PALETTE_MAX_COLORS];
+    size_t swatch_count;
+    uint64_t generation;
+};
+
+// ============================================================================
+// Arena
+// ============================================================================
+
+static size_t align16(size_t size)
+{
+    return (size + 15) & ~(size_t)15;
+}
+
+static void *arena_take(uint8_t **cursor, size_t size)
+{
+    void *block = *cursor;
+    *cursor += align16(size);
+    return block;
+}
+
+static bool arena_init(struct overlay_palette *p)
+{
+    const size_t frame = align16((size_t)MAX_PIXELS * 4);
+    const size_t index = align16(sizeof(uint32_t) * MAX_PIXELS);
+    const size_t bins = align16(sizeof(uint32_t) * HISTOGRAM_BINS);
+    const size_t sums = align16(sizeof(uint32_t) * HISTOGRAM_BINS * 3);
+    const size_t points = align16(sizeof(float) * HISTOGRAM_BINS);
+    const size_t assignment = align16(HISTOGRAM_BINS);
+    
+    // Blocks are padded to 16 bytes so each starts aligned like the arena itself
+    p->arena = bmalloc(frame + index + bins + sums + points * 4 + assignment);
+    if (!p->arena) return false;
+    
+    uint8_t *cursor = p->arena;
+    p->frame = arena_take(&cursor, frame);
+    p->bin_index = arena_take(&cursor, index);
+    p->bin_count = arena_take(&cursor, bins);
+    p->bin_sum = arena_take(&cursor, sums);
+    p->point_r = arena_take(&cursor, points);
+    p->point_g = arena_take(&cursor, points);
+    p->point_b = arena_take(&cursor, points);
+    p->point_weight = arena_take(&cursor, points);
+    p->assignment = arena_take(&cursor, assignment);
+    return true;
+}
+
+// ============================================================================
+// Histogram
+// ============================================================================
+
+// index = rrrrggggbbbb from the high nibbles, 4 pixels per iteration
+static void quantize_pixels(const uint8_t *rgba, uint32_t *index, size_t count)
+{
+    const __m128i r_mask = _mm_set1_epi32(0xF0);
+    const __m128i b_mask = _mm_set1_epi32(0x0F);
+    size_t i = 0;
+    
+    for (; i + 4 <= count; i += 4) {
+        const __m128i px = _mm_loadu_si128((const __m128i *)(rgba + i * 4));
+        const __m128i r = _mm_slli_epi32(_mm_and_si128(px, r_mask), 4);
+        const __m128i g = _mm_and_si128(_mm_srli_epi32(px, 8), r_mask);
+        const __m128i b = _mm_and_si128(_mm_srli_epi32(px, 20), b_mask);
+        _mm_storeu_si128((__m128i *)(index + i), _mm_or_si128(_mm_or_si128(r, g), b));
+    }
+    
+    for (; i < count; i++) {
+        const uint8_t *px = rgba + i * 4;
+        index[i] = ((uint32_t)(px[0] & 0xF0) << 4) | (px[1] & 0xF0) | (px[2] >> 4);
+    }
+}
+
+// Fills the point arrays with the occupied bins, returns their number
+static size_t build_histogram(struct overlay_palette *p)
+{
+    const size_t count = (size_t)p->width * p->height;
+    
+    quantize_pixels(p->frame, p->bin_index, count);
+    
+    memset(p->bin_count, 0, sizeof(uint32_t) * HISTOGRAM_BINS);
+    memset(p->bin_sum, 0, sizeof(uint32_t) * HISTOGRAM_BINS * 3);
+    
+    // Scatter has no SSE form; channel sums keep the bin means exact
+    for (size_t i = 0; i < count; i++) {
+        const uint32_t bin = p->bin_index[i];
+        const uint8_t *px = p->frame + i * 4;
+        uint32_t *sum = p->bin_sum + bin * 3;
+        
+        p->bin_count[bin]++;
+        sum[0] += px[0];
+        sum[1] += px[1];
+        sum[2] += px[2];
+    }
+    
+    size_t points = 0;
+    for (uint32_t bin = 0; bin < HISTOGRAM_BINS; bin++) {
+        const uint32_t n = p->bin_count[bin];
+        if (!n) continue;
+        
+        const float inv = 1.0f / (float)n;
+        p->point_r[points] = (float)p->bin_sum[bin * 3] * inv;
+        p->point_g[points] = (float)p->bin_sum[bin * 3 + 1] * inv;
+        p->point_b[points] = (float)p->bin_sum[bin * 3 + 2] * inv;
+        p->point_weight[points] = (float)n;
+        points++;
+    }
+    
+    return points;
+}
+
+// ============================================================================
+// Clustering
+// ============================================================================
+
+// Nearest centroid, comparing all PALETTE_MAX_COLORS slots four at a time
+static int nearest_centroid(const struct centroids *c, float r, float g, float b, float *distance)
+{
+    const __m128 vr = _mm_set1_ps(r);
+    const __m128 vg = _mm_set1_ps(g);
+    const __m128 vb = _mm_set1_ps(b);
+    float d[PALETTE_MAX_COLORS];
+    
+    for (int i = 0; i < PALETTE_MAX_COLORS; i += 4) {
+        const __m128 dr = _mm_sub_ps(_mm_loadu_ps(c->r + i), vr);
+        const __m128 dg = _mm_sub_ps(_mm_loadu_ps(c->g + i), vg);
+        const __m128 db = _mm_sub_ps(_mm_loadu_ps(c->b + i), vb);
+        const __m128 sum = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dr, dr), _mm_mul_ps(dg, dg)),
+                                      _mm_mul_ps(db, db));
+        _mm_storeu_ps(d + i, sum);
+    }
+    
+    int best = 0;
+    for (int i = 1; i < PALETTE_MAX_COLORS; i++) {
+        if (d[i] < d[best]) best = i;
+    }
+    
+    if (distance) *distance = d[best];
+    return best;
+}
+
+// Deterministic seeding: the most common bin, then repeatedly the bin with the
+// largest weighted distance to the seeds so far
+static int seed_centroids(const struct overlay_palette *p, size_t points, int k, struct centroids *c)
+{
+    for (int i = 0; i < PALETTE_MAX_COLORS; i++) {
+        c->r[i] = c->g[i] = c->b[i] = UNUSED_CENTROID;
+        c->weight[i] = 0.0f;
+    }
+    
+    size_t first = 0;
+    for (size_t i = 1; i < points; i++) {
+        if (p->point_weight[i] > p->point_weight[first]) first = i;
+    }
+    c->r[0] = p->point_r[first];
+    c->g[0] = p->point_g[first];
+    c->b[0] = p->point_b[first];
+    
+    int seeds = 1;
+    for (; seeds < k; seeds++) {
+        size_t best = 0;
+        float best_score = 0.0f;
+        
+        for (size_t i = 0; i < points; i++) {
+            float distance;
+            nearest_centroid(c, p->point_r[i], p->point_g[i], p->point_b[i], &distance);
+            
+            const float score = distance * p->point_weight[i];
+            if (score > best_score) {
+                best_score = score;
+                best = i;
+            }
+        }
+        
+        // Fewer distinct colors than requested
+        if (best_score <= 0.0f) break;
+        
+        c->r[seeds] = p->point_r[best];
+        c->g[seeds] = p->point_g[best];
+        c->b[seeds] = p->point_b[best];
+    }
+    
+    return seeds;
+}
+
+static void cluster(struct overlay_palette *p, size_t points, int k, struct centroids *c)
+{
+    memset(p->assignment, 0xFF, points);
+    
+    for (int iteration = 0; iteration < MAX_ITERATIONS; iteration++) {
+        float sum_r[PALETTE_MAX_COLORS] = {0};
+        float sum_g[PALETTE_MAX_COLORS] = {0};
+        float sum_b[PALETTE_MAX_COLORS] = {0};
+        float weight[PALETTE_MAX_COLORS] = {0};
+        bool changed = false;
+        
+        for (size_t i = 0; i < points; i++) {
+            const int nearest = nearest_centroid(c, p->point_r[i], p->point_g[i], p->point_b[i], NULL);
+            const float w = p->point_weight[i];
+            
+            if (p->assignment[i] != (uint8_t)nearest) {
+                p->assignment[i] = (uint8_t)nearest;
+                changed = true;
+            }
+            
+            sum_r[nearest] += p->point_r[i] * w;
+            sum_g[nearest] += p->point_g[i] * w;
+            sum_b[nearest] += p->point_b[i] * w;
+            weight[nearest] += w;
+        }
+        
+        // Clusters that lost all their points keep their old centroid
+        for (int i = 0; i < k; i++) {
+            c->weight[i] = weight[i];
+            if (weight[i] <= 0.0f) continue;
+            
+            c->r[i] = sum_r[i] / weight[i];
+            c->g[i] = sum_g[i] / weight[i];
+            c->b[i] = sum_b[i] / weight[i];
+        }
+        
+        if (!changed) break;
+    }
+}
+
+static uint32_t to_channel(float value)
+{
+    if (value <= 0.0f) return 0;
+    if (value >= 255.0f) return 255;
+    return (uint32_t)(value + 0.5f);
+}
+
+static void extract_palette(struct overlay_palette *p)
+{
+    struct palette_swatch swatches[PALETTE_MAX_COLORS];
+    size_t count = 0;
+    
+    const size_t points = build_histogram(p);
+    if (points) {
+        struct centroids c;
+        const int k = seed_centroids(p, points, p->colors, &c);
+        cluster(p, points, k, &c);
+        
+        const float total = (float)p->width * (float)p->height;
+        for (int i = 0; i < k; i++) {
+            if (c.weight[i] <= 0.0f) continue;
+            
+            struct palette_swatch *swatch = &swatches[count++];
+            swatch->color = (to_channel(c.r[i]) << 16) | (to_channel(c.g[i]) << 8) | to_channel(c.b[i]);
+            swatch->share = c.weight[i] / total;
+        }
+        
+        // Most common first (at most PALETTE_MAX_COLORS entries)
+        for (size_t i = 1; i < count; i++) {
+            const struct palette_swatch swatch = swatches[i];
+            size_t j = i;
+            for (; j > 0 && swatches[j - 1].share < swatch.share; j--) {
+                swatches[j] = swatches[j - 1];
+            }
+            swatches[j] = swatch;
+        }
+    }
+    
+    pthread_mutex_lock(&p->result_mutex);
+    memcpy(p->swatches, swatches, sizeof(struct palette_swatch) * count);
+    p->swatch_count = count;
+    p->generation++;
+    pthread_mutex_unlock(&p->result_mutex);
+}
+
+static void *palette_thread(void *param)
+{
+    struct overlay_palette *p = param;
+    os_set_thread_name("design-overlay: palette");
+    
+    while (os_event_wait(p->work_event) == 0) {
+        if (os_atomic_load_bool(&p->exiting)) break;
+        
+        extract_palette(p);
+        os_atomic_set_bool(&p->busy, false);
+    }
+    
+    return NULL;
+}
+
+// ============================================================================
+// Public interface
+// ============================================================================
+
+struct overlay_palette *palette_create(void)
+{
+    struct overlay_palette *p = bzalloc(sizeof(struct overlay_palette));
+    
+    if (!arena_init(p)) {
+        bfree(p);
+        return NULL;
+    }
+    
+    if (pthread_mutex_init(&p->result_mutex, NULL) != 0) {
+        bfree(p->arena);
+        bfree(p);
+        return NULL;
+    }
+    
+    if (os_event_init(&p->work_event, OS_EVENT_TYPE_AUTO) != 0) {
+        pthread_mutex_destroy(&p->result_mutex);
+        bfree(p->arena);
+        bfree(p);
+        return NULL;
+    }
+    
+    if (pthread_create(&p->thread, NULL, palette_thread, p) != 0) {
+        palette_destroy(p);
+        return NULL;
+    }
+    
+    p->thread_created = true;
+    return p;
+}
+
+void palette_destroy(struct overlay_palette *p)
+{
+    if (!p) return;
+    
+    if (p->thread_created) {
+        os_atomic_set_bool(&p->exiting, true);
+        os_event_signal(p->work_event);
+        pthread_join(p->thread, NULL);
+    }
+    
+    os_event_destroy(p->work_event);
+    pthread_mutex_destroy(&p->result_mutex);
+    
+    bfree(p->arena);
+    bfree(p);
+}
+
+bool palette_submit(struct overlay_palette *p, const uint8_t *data, uint32_t linesize,
+                    uint32_t width, uint32_t height, int colors)
+{
+    if (!p || !width || !height) return false;
+    if (width > PALETTE_MAX_SAMPLE || height > PALETTE_MAX_SAMPLE) return false;
+    if (os_atomic_load_bool(&p->busy)) return false;
+    
+    for (uint32_t y = 0; y < height; y++) {
+        memcpy(p->frame + (size_t)y * width * 4, data + (size_t)y * linesize, (size_t)width * 4);
+    }
+    
+    p->width = width;
+    p->height = height;
+    p->colors = colors < 1 ? 1 : colors > PALETTE_MAX_COLORS ? PALETTE_MAX_COLORS : colors;
+    
+    os_atomic_set_bool(&p->busy, true);
+    os_event_signal(p->work_event);
+    return true;
+}
+
+uint64_t palette_get_swatches(struct overlay_palette *p, struct palette_swatch *swatches,
+                              size_t *count)
+{
+    pthread_mutex_lock(&p->result_mutex);
+    memcpy(swatches, p->swatches, sizeof(struct palette_swatch) * p->swatch_count);
+    *count = p->swatch_count;
+    const uint64_t generation = p->generation;
+    pthread_mutex_unlock(&p->result_mutex);
+    
+    return generation;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+// Dominant-color extraction for color-accuracy checks.
+// Downscaled canvas frames are quantized into a 12-bit histogram and the
+// occupied bins are clustered with weighted k-means on a worker thread.
+// All working memory is allocated once, frames larger than
+// PALETTE_MAX_SAMPLE on either side are rejected.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PALETTE_MAX_COLORS 8
+#define PALETTE_MAX_SAMPLE 256  // Longest side of a submitted frame
+
+struct palette_swatch {
+    uint32_t color;  // 0x00RRGGBB
+    float share;     // Fraction of the sampled pixels, 0-1
+};
+
+struct overlay_palette;
+
+struct overlay_palette *palette_create(void);
+void palette_destroy(struct overlay_palette *palette);
+
+// Copies an RGBA frame for the worker. Returns false, dropping the frame,
+// while the previous one is still being quantized.
+bool palette_submit(struct overlay_palette *palette, const uint8_t *data, uint32_t linesize,
+                    uint32_t width, uint32_t height, int colors);
+
+// Copies the latest swatches, most common first; returns the result generation (0 = none yet)
+uint64_t palette_get_swatches(struct overlay_palette *palette, struct palette_swatch *swatches,
+                              size_t *count);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,153 @@
+#include "overlay-raster.h"
+#include "overlay-text.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// Image buffer
+// ============================================================================
+
+bool overlay_image_init(struct overlay_image *image, uint32_t width, uint32_t height)
+{
+    memset(image, 0, sizeof(*image));
+    if (!width || !height) return false;
+    
+    image->pixels = calloc((size_t)width * height, 4);
+    if (!image->pixels) return false;
+    
+    image->width = width;
+    image->height = height;
+    image->linesize = width * 4;
+    return true;
+}
+
+void overlay_image_free(struct overlay_image *image)
+{
+    free(image->pixels);
+    memset(image, 0, sizeof(*image));
+}
+
+void overlay_image_clear(struct overlay_image *image, uint32_t color)
+{
+    const uint8_t rgba[4] = {
+        (uint8_t)((color >> 16) & 0xFF),
+        (uint8_t)((color >> 8) & 0xFF),
+        (uint8_t)(color & 0xFF),
+        (uint8_t)((color >> 24) & 0xFF),
+    };
+    
+    for (uint32_t y = 0; y < image->height; y++) {
+        uint8_t *row = image->pixels + (size_t)y * image->linesize;
+        for (uint32_t x = 0; x < image->width; x++) {
+            memcpy(row + x * 4, rgba, 4);
+        }
+    }
+}
+
+// ============================================================================
+// Rasterization
+// ============================================================================
+
+// Straight-alpha source-over, same result as GS_BLEND_SRCALPHA/INVSRCALPHA
+static void blend_pixel(uint8_t *dst, uint32_t color)
+{
+    const uint32_t sa = color >> 24;
+    if (!sa) return;
+    
+    const uint32_t src[3] = {(color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF};
+    const uint32_t da = (dst[3] * (255 - sa) + 127) / 255;
+    const uint32_t out_a = sa + da;
+    
+    for (int c = 0; c < 3; c++) {
+        dst[c] = (uint8_t)((src[c] * sa + dst[c] * da + out_a / 2) / out_a);
+    }
+    dst[3] = (uint8_t)out_a;
+}
+
+// Lights every pixel whose center lies on the major-axis span [min, max),
+// which is the diamond-exit behavior of GS_LINES for axis-aligned lines
+void overlay_raster_line(struct overlay_image *image, const struct overlay_line *line)
+{
+    const float dx = line->x2 - line->x1;
+    const float dy = line->y2 - line->y1;
+    const bool x_major = fabsf(dx) >= fabsf(dy);
+    
+    const float major_1 = x_major ? line->x1 : line->y1;
+    const float major_2 = x_major ? line->x2 : line->y2;
+    const float minor_1 = x_major ? line->y1 : line->x1;
+    const float span = major_2 - major_1;
+    if (span == 0.0f) return;
+    
+    const float slope = (x_major ? dy : dx) / span;
+    const int major_limit = (int)(x_major ? image->width : image->height);
+    const int minor_limit = (int)(x_major ? image->height : image->width);
+    
+    int first = (int)ceilf(fminf(major_1, major_2) - 0.5f);
+    int last = (int)ceilf(fmaxf(major_1, major_2) - 0.5f) - 1;
+    if (first < 0) first = 0;
+    if (last >= major_limit) last = major_limit - 1;
+    
+    for (int i = first; i <= last; i++) {
+        const float center = (float)i + 0.5f;
+        const int minor = (int)floorf(minor_1 + (center - major_1) * slope);
+        if (minor < 0 || minor >= minor_limit) continue;
+        
+        const int x = x_major ? i : minor;
+        const int y = x_major ? minor : i;
+        blend_pixel(image->pixels + (size_t)y * image->linesize + (size_t)x * 4, line->color);
+    }
+}
+
+static void fill_rect(struct overlay_image *image, float x, float y, float w, float h, uint32_t color)
+{
+    // Pixel centers inside the rectangle, like the GPU quad
+    const int x0 = (int)fmaxf(0.0f, ceilf(x - 0.5f));
+    const int y0 = (int)fmaxf(0.0f, ceilf(y - 0.5f));
+    const int x1 = (int)fminf((float)image->width, ceilf(x + w - 0.5f));
+    const int y1 = (int)fminf((float)image->height, ceilf(y + h - 0.5f));
+    
+    for (int py = y0; py < y1; py++) {
+        uint8_t *row = image->pixels + (size_t)py * image->linesize;
+        for (int px = x0; px < x1; px++) blend_pixel(row + (size_t)px * 4, color);
+    }
+}
+
+// Same glyphs and shadow as text_layout_label, one block per font pixel
+void overlay_raster_label(struct overlay_image *image, const struct overlay_label *label)
+{
+    const float scale = label->scale;
+    const uint32_t shadow = ((uint32_t)((label->color >> 24) * 0.6f) << 24);
+    const float origin = text_origin_x(label);
+    
+    for (int pass = 0; pass < 2; pass++) {
+        const float offset = pass == 0 ? scale : 0.0f;
+        const uint32_t color = pass == 0 ? shadow : label->color;
+        float x = origin + offset;
+        
+        for (const char *p = label->text; *p; p++, x += TEXT_ADVANCE * scale) {
+            const uint8_t *glyph = text_glyph(*p);
+            for (int row = 0; row < TEXT_GLYPH_HEIGHT; row++) {
+                for (int col = 0; col < TEXT_GLYPH_WIDTH; col++) {
+                    if (!(glyph[row] & (0x10 >> col))) continue;
+                    fill_rect(image, x + col * scale, label->y + offset + row * scale, scale, scale, color);
+                }
+            }
+        }
+    }
+}
+
+void overlay_raster_prims(struct overlay_image *image, const struct overlay_prim_list *list)
+{
+    if (!image->pixels) return;
+    
+    for (size_t i = 0; i < list->num; i++) {
+        overlay_raster_line(image, &list->lines[i]);
+    }
+    
+    // Labels draw after all lines, like the GPU path
+    for (size_t i = 0; i < list->label_num; i++) {
+        overlay_raster_label(image, &list->labels[i]);
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+// CPU reference rasterizer for overlay primitives.
+// Renders an overlay_prim_list into an RGBA8 buffer with the same pixel rules
+// as the GPU path, without a graphics context.
+
+#include "overlay-geometry.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct overlay_image {
+    uint8_t *pixels;    // RGBA8, straight alpha
+    uint32_t width;
+    uint32_t height;
+    uint32_t linesize;  // Bytes per row
+};
+
+bool overlay_image_init(struct overlay_image *image, uint32_t width, uint32_t height);
+void overlay_image_free(struct overlay_image *image);
+void overlay_image_clear(struct overlay_image *image, uint32_t color);  // 0xAARRGGBB
+
+void overlay_raster_line(struct overlay_image *image, const struct overlay_line *line);
+void overlay_raster_label(struct overlay_image *image, const struct overlay_label *label);
+void overlay_raster_prims(struct overlay_image *image, const struct overlay_prim_list *list);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,120 @@
+#include "overlay-reference.h"
+
+#include <graphics/image-file.h>
+#include <util/bmem.h>
+#include <util/platform.h>
+#include <util/threading.h>
+#include <sys/stat.h>
+#include <string.h>
+
+struct reference_image {
+    struct reference_image *next;
+    char *path;
+    int64_t modified;  // File version the image was decoded from
+    int64_t size;
+    long refs;         // Protected by registry_mutex
+    
+    gs_image_file_t image;
+    bool uploaded;     // Graphics thread only
+};
+
+static pthread_mutex_t registry_mutex = PTHREAD_MUTEX_INITIALIZER;
+static struct reference_image *registry_head = NULL;
+
+static void free_image(struct reference_image *image)
+{
+    // The texture, if uploaded, belongs to the graphics context
+    obs_enter_graphics();
+    gs_image_file_free(&image->image);
+    obs_leave_graphics();
+    
+    bfree(image->path);
+    bfree(image);
+}
+
+// ============================================================================
+// Public interface
+// ============================================================================
+
+struct reference_image *reference_image_acquire(const char *path)
+{
+    if (!path || !*path) return NULL;
+    
+    struct stat st;
+    if (os_stat(path, &st) != 0) {
+        blog(LOG_WARNING, "[Design Overlay] Cannot read reference image '%s'", path);
+        return NULL;
+    }
+    
+    const int64_t modified = (int64_t)st.st_mtime;
+    const int64_t size = (int64_t)st.st_size;
+    
+    pthread_mutex_lock(&registry_mutex);
+    
+    struct reference_image *image = registry_head;
+    while (image && (image->modified != modified || image->size != size || strcmp(image->path, path) != 0)) {
+        image = image->next;
+    }
+    
+    if (image) {
+        image->refs++;
+    } else {
+        image = bzalloc(sizeof(struct reference_image));
+        gs_image_file_init(&image->image, path);
+        
+        if (image->image.loaded) {
+            image->path = bstrdup(path);
+            image->modified = modified;
+            image->size = size;
+            image->refs = 1;
+            image->next = registry_head;
+            registry_head = image;
+            
+            blog(LOG_INFO, "[Design Overlay] Loaded reference image '%s' (%ux%u)", path, image->image.cx,
+                 image->image.cy);
+        } else {
+            blog(LOG_WARNING, "[Design Overlay] '%s' is not a supported image", path);
+            gs_image_file_free(&image->image);
+            bfree(image);
+            image = NULL;
+        }
+    }
+    
+    pthread_mutex_unlock(&registry_mutex);
+    return image;
+}
+
+void reference_image_addref(struct reference_image *image)
+{
+    if (!image) return;
+    
+    pthread_mutex_lock(&registry_mutex);
+    image->refs++;
+    pthread_mutex_unlock(&registry_mutex);
+}
+
+void reference_image_release(struct reference_image *image)
+{
+    if (!image) return;
+    
+    pthread_mutex_lock(&registry_mutex);
+    const bool last = --image->refs == 0;
+    if (last) {
+        struct reference_image **link = &registry_head;
+        while (*link != image) link = &(*link)->next;
+        *link = image->next;
+    }
+    pthread_mutex_unlock(&registry_mutex);
+    
+    if (last) free_image(image);
+}
+
+gs_texture_t *reference_image_texture(struct reference_image *image)
+{
+    if (!image->uploaded) {
+        gs_image_file_init_texture(&image->image);
+        image->uploaded = true;
+    }
+    
+    return image->image.texture;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+// Reference mockups for the diff mode.
+// Images are decoded once per file version and shared between instances;
+// the texture is uploaded on first use by the graphics thread.
+
+#include <obs.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct reference_image;
+
+// Loads (or shares an already loaded) image, NULL if the file is missing or not an image.
+// Any thread; the file is checked for changes, so call it from update, not per frame.
+struct reference_image *reference_image_acquire(const char *path);
+void reference_image_addref(struct reference_image *image);
+void reference_image_release(struct reference_image *image);
+
+// Graphics thread. NULL if the upload failed.
+gs_texture_t *reference_image_texture(struct reference_image *image);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,268 @@
+#include "overlay-shm.h"
+
+#include <obs.h>
+#include <util/bmem.h>
+#include <util/platform.h>
+#include <util/threading.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#define SHM_NAME_MAX      31  // macOS PSHMNAMLEN, the shortest limit
+#define SHM_NAME_ATTEMPTS 8   // Suffixes tried when the name is already taken
+
+// Payload compared to skip redundant writes: everything after the write bookkeeping
+#define SHM_PAYLOAD_OFFSET offsetof(struct overlay_shm_layout, canvas_width)
+#define SHM_PAYLOAD_SIZE   (sizeof(struct overlay_shm_layout) - SHM_PAYLOAD_OFFSET)
+
+struct overlay_shm {
+    char name[SHM_NAME_MAX + 1];
+    struct overlay_shm_layout *view;  // Shared with readers
+
+    pthread_mutex_t mutex;            // Serializes writers
+    struct overlay_shm_layout staged; // Last written contents
+
+#ifdef _WIN32
+    HANDLE mapping;
+#endif
+};
+
+// ============================================================================
+// Region
+// ============================================================================
+
+// "/design-overlay-<name>[-n]", cut to SHM_NAME_MAX bytes
+static void make_name(char *dst, const char *source_name, int attempt)
+{
+    char suffix[12] = "";  // Room for any int, so the compiler can see it fits
+    if (attempt > 0) snprintf(suffix, sizeof(suffix), "-%d", attempt + 1);
+    
+    static const char prefix[] = "/design-overlay-";
+    const size_t limit = SHM_NAME_MAX - strlen(suffix);
+    size_t len = sizeof(prefix) - 1;
+    memcpy(dst, prefix, len);
+    
+    for (const char *c = source_name ? source_name : ""; *c && len < limit; c++) {
+        const bool keep = (*c >= 'a' && *c <= 'z') || (*c >= 'A' && *c <= 'Z') ||
+                          (*c >= '0' && *c <= '9') || *c == '-' || *c == '_';
+        dst[len++] = keep ? *c : '_';
+    }
+    
+    strcpy(dst + len, suffix);
+}
+
+// Creates a new region, false if the name is in use or the platform refuses
+static bool open_region(struct overlay_shm *shm)
+{
+    const size_t size = sizeof(struct overlay_shm_layout);
+    
+#ifdef _WIN32
+    char local_name[SHM_NAME_MAX + 8];
+    snprintf(local_name, sizeof(local_name), "Local\\%s", shm->name + 1);
+    
+    wchar_t *wname = NULL;
+    if (!os_utf8_to_wcs_ptr(local_name, 0, &wname)) return false;
+    
+    HANDLE mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, (DWORD)size, wname);
+    const DWORD error = GetLastError();
+    bfree(wname);
+    if (!mapping) return false;
+    if (error == ERROR_ALREADY_EXISTS) {
+        CloseHandle(mapping);
+        return false;
+    }
+    
+    shm->view = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size);
+    if (!shm->view) {
+        CloseHandle(mapping);
+        return false;
+    }
+    shm->mapping = mapping;
+    return true;
+#else
+    const int fd = shm_open(shm->name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) return false;
+    
+    void *view = MAP_FAILED;
+    if (ftruncate(fd, (off_t)size) == 0) {
+        view = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    
+    if (view == MAP_FAILED) {
+        shm_unlink(shm->name);
+        return false;
+    }
+    shm->view = view;
+    return true;
+#endif
+}
+
+static void close_region(struct overlay_shm *shm)
+{
+#ifdef _WIN32
+    UnmapViewOfFile(shm->view);
+    CloseHandle(shm->mapping);
+#else
+    munmap(shm->view, sizeof(struct overlay_shm_layout));
+    shm_unlink(shm->name);
+#endif
+}
+
+// ============================================================================
+// Seqlock writer
+// ============================================================================
+
+static inline void store_fence(void)
+{
+#ifdef _MSC_VER
+    MemoryBarrier();
+#else
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+#endif
+}
+
+// Caller holds the mutex and has updated shm->staged
+static void write_staged(struct overlay_shm *shm)
+{
+    struct overlay_shm_layout *view = shm->view;
+    const uint32_t sequence = view->sequence;
+    
+    shm->staged.update_count++;
+    shm->staged.timestamp_ns = os_gettime_ns();
+    
+    view->sequence = sequence + 1;
+    store_fence();  // Odd sequence becomes visible before any payload byte
+    
+    const size_t offset = offsetof(struct overlay_shm_layout, update_count);
+    memcpy((uint8_t *)view + offset, (const uint8_t *)&shm->staged + offset,
+           sizeof(struct overlay_shm_layout) - offset);
+    
+    store_fence();  // Payload becomes visible before the even sequence
+    view->sequence = sequence + 2;
+}
+
+// Writes next if its payload differs from the staged one
+static void commit(struct overlay_shm *shm, const struct overlay_shm_layout *next)
+{
+    if (memcmp((const uint8_t *)next + SHM_PAYLOAD_OFFSET,
+               (const uint8_t *)&shm->staged + SHM_PAYLOAD_OFFSET, SHM_PAYLOAD_SIZE) == 0) {
+        return;
+    }
+    
+    memcpy((uint8_t *)&shm->staged + SHM_PAYLOAD_OFFSET, (const uint8_t *)next + SHM_PAYLOAD_OFFSET,
+           SHM_PAYLOAD_SIZE);
+    write_staged(shm);
+}
+
+// ============================================================================
+// Public interface
+// ============================================================================
+
+struct overlay_shm *overlay_shm_create(const char *source_name)
+{
+    struct overlay_shm *shm = bzalloc(sizeof(struct overlay_shm));
+    
+    bool opened = false;
+    for (int attempt = 0; attempt < SHM_NAME_ATTEMPTS && !opened; attempt++) {
+        make_name(shm->name, source_name, attempt);
+        opened = open_region(shm);
+    }
+    
+    if (!opened) {
+        blog(LOG_WARNING, "[Design Overlay] Cannot create shared layout region for '%s'",
+             source_name ? source_name : "");
+        bfree(shm);
+        return NULL;
+    }
+    
+    pthread_mutex_init(&shm->mutex, NULL);
+    
+    // Header and an empty, even-sequenced payload; readers skip a zero magic
+    shm->staged.magic = OVERLAY_SHM_MAGIC;
+    shm->staged.version = OVERLAY_SHM_VERSION;
+    shm->staged.size = sizeof(struct overlay_shm_layout);
+    shm->staged.picked_color = -1;
+    memcpy(shm->view, &shm->staged, sizeof(struct overlay_shm_layout));
+    
+    blog(LOG_INFO, "[Design Overlay] Sharing layout of '%s' as '%s'", source_name ? source_name : "",
+         shm->name);
+    return shm;
+}
+
+void overlay_shm_destroy(struct overlay_shm *shm)
+{
+    if (!shm) return;
+    
+    close_region(shm);
+    pthread_mutex_destroy(&shm->mutex);
+    bfree(shm);
+}
+
+void overlay_shm_publish_layout(struct overlay_shm *shm, const struct overlay_params *params,
+                                const struct overlay_layout *layout)
+{
+    if (!shm) return;
+    
+    pthread_mutex_lock(&shm->mutex);
+    
+    struct overlay_shm_layout next = shm->staged;
+    next.canvas_width = params->canvas_width;
+    next.canvas_height = params->canvas_height;
+    next.material_grid_size = params->material_grid_size;
+    
+    const int columns = layout->columns < OVERLAY_SHM_MAX_COLUMNS ? layout->columns : OVERLAY_SHM_MAX_COLUMNS;
+    next.column_count = columns;
+    next.container_x = layout->container_x;
+    next.container_w = layout->container_w;
+    next.column_w = layout->column_w;
+    next.gutter = layout->gutter;
+    memset(next.column_left, 0, sizeof(next.column_left));
+    memset(next.column_right, 0, sizeof(next.column_right));
+    for (int i = 0; i < columns; i++) {
+        next.column_left[i] = layout->container_x + (float)i * (layout->column_w + layout->gutter);
+        next.column_right[i] = next.column_left[i] + layout->column_w;
+    }
+    
+    next.safe_x = layout->safe_x;
+    next.safe_y = layout->safe_y;
+    next.safe_w = layout->safe_w;
+    next.safe_h = layout->safe_h;
+    memcpy(next.thirds, layout->thirds, sizeof(next.thirds));
+    next.center_x = layout->center_x;
+    next.center_y = layout->center_y;
+    
+    commit(shm, &next);
+    pthread_mutex_unlock(&shm->mutex);
+}
+
+void overlay_shm_publish_colors(struct overlay_shm *shm, long picked_color,
+                                const struct palette_swatch *swatches, size_t swatch_count)
+{
+    if (!shm) return;
+    if (swatch_count > PALETTE_MAX_COLORS) swatch_count = PALETTE_MAX_COLORS;
+    
+    pthread_mutex_lock(&shm->mutex);
+    
+    struct overlay_shm_layout next = shm->staged;
+    next.picked_color = (int32_t)picked_color;
+    next.swatch_count = (uint32_t)swatch_count;
+    memset(next.swatch_colors, 0, sizeof(next.swatch_colors));
+    memset(next.swatch_shares, 0, sizeof(next.swatch_shares));
+    for (size_t i = 0; i < swatch_count; i++) {
+        next.swatch_colors[i] = swatches[i].color;
+        next.swatch_shares[i] = swatches[i].share;
+    }
+    
+    commit(shm, &next);
+    pthread_mutex_unlock(&shm->mutex);
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+// Live layout for external tools.
+// Each overlay with "publish_layout" turned on publishes its computed layout
+// and sampled colors in a small shared-memory region named
+// "design-overlay-<source name>" (POSIX shm_open
+// name "/design-overlay-<name>", Windows "Local\design-overlay-<name>"; any
+// character outside [A-Za-z0-9_-] becomes '_', the name is cut to 31 bytes).
+// The region is rewritten only when a value actually changes.
+//
+// Readers follow the seqlock protocol, no locks are shared:
+//
+//     do {
+//         seq = atomic_load_acquire(&shm->sequence);
+//         if (seq & 1) continue;              // writer active
+//         copy = *shm;
+//         atomic_thread_fence(acquire);
+//     } while (atomic_load_relaxed(&shm->sequence) != seq);
+//
+// and then check magic, version and size before using the copy.
+
+#include "overlay-geometry.h"
+#include "overlay-palette.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OVERLAY_SHM_MAGIC       0x4F4C4453  // "SDLO" in little-endian memory order
+#define OVERLAY_SHM_VERSION     1
+#define OVERLAY_SHM_MAX_COLUMNS 24
+
+// Little-endian, naturally aligned, no padding. Positions are canvas pixels.
+struct overlay_shm_layout {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;                // sizeof(struct overlay_shm_layout)
+    volatile uint32_t sequence;   // Odd while a write is in progress
+    uint64_t update_count;        // Completed writes
+    uint64_t timestamp_ns;        // os_gettime_ns() of the last write
+
+    uint32_t canvas_width;
+    uint32_t canvas_height;
+    int32_t material_grid_size;
+
+    // Bootstrap container and column edges
+    int32_t column_count;
+    float container_x;
+    float container_w;
+    float column_w;
+    float gutter;
+    float column_left[OVERLAY_SHM_MAX_COLUMNS];
+    float column_right[OVERLAY_SHM_MAX_COLUMNS];
+
+    float safe_x;
+    float safe_y;
+    float safe_w;
+    float safe_h;
+    float thirds[4];              // x1, x2, y1, y2
+    float center_x;
+    float center_y;
+
+    // Sampled colors, 0x00RRGGBB
+    int32_t picked_color;         // -1 when the color picker has no sample
+    uint32_t swatch_count;
+    uint32_t swatch_colors[PALETTE_MAX_COLORS];
+    float swatch_shares[PALETTE_MAX_COLORS];
+};
+
+struct overlay_shm;
+
+// Creates the region for a source, NULL (logged) if the platform refuses
+struct overlay_shm *overlay_shm_create(const char *source_name);
+void overlay_shm_destroy(struct overlay_shm *shm);
+
+// Any thread, writers are serialized. Unchanged values are not rewritten.
+void overlay_shm_publish_layout(struct overlay_shm *shm, const struct overlay_params *params,
+                                const struct overlay_layout *layout);
+void overlay_shm_publish_colors(struct overlay_shm *shm, long picked_color,
+                                const struct palette_swatch *swatches, size_t swatch_count);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,44 @@
+#pragma once
+
+// Embedded 5x7 bitmap font for overlay labels.
+// The printable ASCII glyphs are baked into one small coverage atlas at load
+// time; labels become textured quads for the GPU or are blitted directly by
+// the CPU rasterizer. Nothing here depends on libobs.
+
+#include "overlay-geometry.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TEXT_GLYPH_WIDTH   5
+#define TEXT_GLYPH_HEIGHT  7
+#define TEXT_ADVANCE       6   // Glyph plus one column of spacing, in font pixels
+
+// 16 x 6 cells of 6 x 8 texels, one byte of coverage per texel
+#define TEXT_ATLAS_COLUMNS 16
+#define TEXT_ATLAS_WIDTH   (TEXT_ATLAS_COLUMNS * (TEXT_GLYPH_WIDTH + 1))
+#define TEXT_ATLAS_HEIGHT  (6 * (TEXT_GLYPH_HEIGHT + 1))
+
+struct text_quad {
+    float x0, y0, x1, y1;
+    float u0, v0, u1, v1;
+    uint32_t color;  // 0xAARRGGBB
+};
+
+// Fills TEXT_ATLAS_WIDTH * TEXT_ATLAS_HEIGHT bytes (0 or 255)
+void text_atlas_fill(uint8_t *pixels);
+
+// Seven rows, bit 4 is the leftmost pixel. Characters outside printable ASCII map to '?'.
+const uint8_t *text_glyph(char c);
+
+// Left edge of the text after alignment, in canvas pixels
+float text_origin_x(const struct overlay_label *label);
+
+// Two quads per visible character, drop shadow first. Returns the number
+// written; out needs room for 2 * strlen(label->text) quads.
+size_t text_layout_label(const struct overlay_label *label, struct text_quad *out);
+
+#ifdef __cplusplus
+}
+#endif
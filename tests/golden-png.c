@@ -0,0 +1,650 @@
+#include "golden-png.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define WINDOW_SIZE 32768
+#define HASH_BITS   15
+#define MAX_CHAIN   16   // Candidates compared per position; overlays are mostly long runs
+#define MIN_MATCH   3
+#define MAX_MATCH   258
+
+static const uint8_t png_signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+static const uint16_t length_base[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27,
+    31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258,
+};
+static const uint8_t length_extra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+    2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0,
+};
+static const uint16_t distance_base[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129,
+    193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577,
+};
+static const uint8_t distance_extra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6,
+    6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13,
+};
+
+// ============================================================================
+// Byte buffer and checksums
+// ============================================================================
+
+struct buffer {
+    uint8_t *data;
+    size_t size;
+    size_t capacity;
+};
+
+static bool buffer_reserve(struct buffer *buffer, size_t extra)
+{
+    if (buffer->size + extra <= buffer->capacity) return true;
+    
+    size_t capacity = buffer->capacity ? buffer->capacity : 4096;
+    while (capacity < buffer->size + extra) capacity *= 2;
+    
+    uint8_t *data = realloc(buffer->data, capacity);
+    if (!data) return false;
+    
+    buffer->data = data;
+    buffer->capacity = capacity;
+    return true;
+}
+
+static bool buffer_put(struct buffer *buffer, const void *data, size_t size)
+{
+    if (!buffer_reserve(buffer, size)) return false;
+    
+    memcpy(buffer->data + buffer->size, data, size);
+    buffer->size += size;
+    return true;
+}
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t size)
+{
+    static uint32_t table[256];
+    static bool table_ready = false;
+    
+    if (!table_ready) {
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[n] = c;
+        }
+        table_ready = true;
+    }
+    
+    for (size_t i = 0; i < size; i++) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+static uint32_t adler32(const uint8_t *data, size_t size)
+{
+    uint32_t a = 1;
+    uint32_t b = 0;
+    
+    while (size > 0) {
+        // Longest run whose sums cannot overflow before the reduction
+        const size_t n = size < 5552 ? size : 5552;
+        for (size_t i = 0; i < n; i++) {
+            a += data[i];
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+        data += n;
+        size -= n;
+    }
+    return (b << 16) | a;
+}
+
+static uint32_t read_u32_be(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static void write_u32_be(uint8_t *p, uint32_t value)
+{
+    p[0] = (uint8_t)(value >> 24);
+    p[1] = (uint8_t)(value >> 16);
+    p[2] = (uint8_t)(value >> 8);
+    p[3] = (uint8_t)value;
+}
+
+// ============================================================================
+// Deflate (fixed Huffman codes, greedy LZ77)
+// ============================================================================
+
+struct bit_writer {
+    struct buffer *out;
+    uint32_t bits;
+    int count;
+    bool ok;
+};
+
+// Least significant bit first, as deflate packs everything but Huffman codes
+static void put_bits(struct bit_writer *w, uint32_t value, int count)
+{
+    w->bits |= value << w->count;
+    w->count += count;
+    
+    while (w->count >= 8) {
+        const uint8_t byte = (uint8_t)w->bits;
+        w->ok = buffer_put(w->out, &byte, 1) && w->ok;
+        w->bits >>= 8;
+        w->count -= 8;
+    }
+}
+
+// Huffman codes are packed starting with their most significant bit
+static void put_code(struct bit_writer *w, uint32_t code, int length)
+{
+    uint32_t reversed = 0;
+    for (int i = 0; i < length; i++) {
+        reversed = (reversed << 1) | (code & 1);
+        code >>= 1;
+    }
+    put_bits(w, reversed, length);
+}
+
+static void put_symbol(struct bit_writer *w, int symbol)
+{
+    if (symbol < 144) {
+        put_code(w, 0x30 + (uint32_t)symbol, 8);
+    } else if (symbol < 256) {
+        put_code(w, 0x190 + (uint32_t)(symbol - 144), 9);
+    } else if (symbol < 280) {
+        put_code(w, (uint32_t)(symbol - 256), 7);
+    } else {
+        put_code(w, 0xC0 + (uint32_t)(symbol - 280), 8);
+    }
+}
+
+static void put_match(struct bit_writer *w, int length, int distance)
+{
+    int code = 28;
+    while (length_base[code] > length) code--;
+    put_symbol(w, 257 + code);
+    put_bits(w, (uint32_t)(length - length_base[code]), length_extra[code]);
+    
+    code = 29;
+    while (distance_base[code] > distance) code--;
+    put_code(w, (uint32_t)code, 5);
+    put_bits(w, (uint32_t)(distance - distance_base[code]), distance_extra[code]);
+}
+
+static uint32_t hash3(const uint8_t *p)
+{
+    const uint32_t value = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16);
+    return (value * 2654435761u) >> (32 - HASH_BITS);
+}
+
+static bool deflate_fixed(struct buffer *out, const uint8_t *data, size_t size)
+{
+    int32_t *head = malloc(sizeof(int32_t) << HASH_BITS);
+    int32_t *prev = malloc(sizeof(int32_t) * WINDOW_SIZE);
+    if (!head || !prev) {
+        free(head);
+        free(prev);
+        return false;
+    }
+    memset(head, 0xFF, sizeof(int32_t) << HASH_BITS);  // -1: empty
+    
+    struct bit_writer w = {out, 0, 0, true};
+    put_bits(&w, 1, 1);  // Final block
+    put_bits(&w, 1, 2);  // Fixed Huffman codes
+    
+    size_t pos = 0;
+    while (pos < size) {
+        const size_t limit = size - pos < MAX_MATCH ? size - pos : MAX_MATCH;
+        size_t best_length = 0;
+        size_t best_distance = 0;
+        
+        if (limit >= MIN_MATCH) {
+            int32_t candidate = head[hash3(data + pos)];
+            for (int chain = 0; candidate >= 0 && chain < MAX_CHAIN; chain++) {
+                const size_t distance = pos - (size_t)candidate;
+                if (distance >= WINDOW_SIZE) break;
+                
+                size_t length = 0;
+                while (length < limit && data[(size_t)candidate + length] == data[pos + length]) length++;
+                if (length > best_length) {
+                    best_length = length;
+                    best_distance = distance;
+                    if (length == limit) break;
+                }
+                
+                const int32_t next = prev[candidate & (WINDOW_SIZE - 1)];
+                if (next >= candidate) break;  // Slot reused by a newer position
+                candidate = next;
+            }
+        }
+        
+        const size_t advance = best_length >= MIN_MATCH ? best_length : 1;
+        if (best_length >= MIN_MATCH) {
+            put_match(&w, (int)best_length, (int)best_distance);
+        } else {
+            put_symbol(&w, data[pos]);
+        }
+        
+        for (size_t end = pos + advance; pos < end; pos++) {
+            if (size - pos < MIN_MATCH) continue;
+            const uint32_t hash = hash3(data + pos);
+            prev[pos & (WINDOW_SIZE - 1)] = head[hash];
+            head[hash] = (int32_t)pos;
+        }
+    }
+    
+    put_symbol(&w, 256);
+    if (w.count) put_bits(&w, 0, 8 - w.count);
+    
+    free(head);
+    free(prev);
+    return w.ok;
+}
+
+// ============================================================================
+// Inflate
+// ============================================================================
+
+struct bit_reader {
+    const uint8_t *data;
+    size_t size;
+    size_t pos;
+    uint32_t bits;
+    int count;
+    bool overrun;
+};
+
+static uint32_t get_bits(struct bit_reader *r, int count)
+{
+    while (r->count < count) {
+        if (r->pos >= r->size) {
+            r->overrun = true;
+            return 0;
+        }
+        r->bits |= (uint32_t)r->data[r->pos++] << r->count;
+        r->count += 8;
+    }
+    
+    const uint32_t value = r->bits & ((1u << count) - 1);
+    r->bits >>= count;
+    r->count -= count;
+    return value;
+}
+
+// Canonical code: symbol counts per length and the symbols sorted by code
+struct huffman {
+    uint16_t counts[16];
+    uint16_t symbols[288];
+};
+
+static void huffman_build(struct huffman *h, const uint8_t *lengths, int count)
+{
+    uint16_t offsets[16];
+    
+    memset(h->counts, 0, sizeof(h->counts));
+    for (int i = 0; i < count; i++) h->counts[lengths[i]]++;
+    h->counts[0] = 0;
+    
+    offsets[1] = 0;
+    for (int len = 1; len < 15; len++) offsets[len + 1] = offsets[len] + h->counts[len];
+    for (int i = 0; i < count; i++) {
+        if (lengths[i]) h->symbols[offsets[lengths[i]]++] = (uint16_t)i;
+    }
+}
+
+// One bit at a time; fast enough for test images
+static int huffman_decode(struct bit_reader *r, const struct huffman *h)
+{
+    int code = 0;
+    int first = 0;
+    int index = 0;
+    
+    for (int len = 1; len < 16; len++) {
+        code |= (int)get_bits(r, 1);
+        const int count = h->counts[len];
+        if (code - first < count) return h->symbols[index + code - first];
+        
+        index += count;
+        first = (first + count) << 1;
+        code <<= 1;
+    }
+    return -1;
+}
+
+static void fixed_tables(struct huffman *literals, struct huffman *distances)
+{
+    uint8_t lengths[288];
+    
+    for (int i = 0; i < 144; i++) lengths[i] = 8;
+    for (int i = 144; i < 256; i++) lengths[i] = 9;
+    for (int i = 256; i < 280; i++) lengths[i] = 7;
+    for (int i = 280; i < 288; i++) lengths[i] = 8;
+    huffman_build(literals, lengths, 288);
+    
+    for (int i = 0; i < 30; i++) lengths[i] = 5;
+    huffman_build(distances, lengths, 30);
+}
+
+static bool dynamic_tables(struct bit_reader *r, struct huffman *literals, struct huffman *distances)
+{
+    static const uint8_t order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+    
+    const int literal_count = (int)get_bits(r, 5) + 257;
+    const int distance_count = (int)get_bits(r, 5) + 1;
+    const int length_count = (int)get_bits(r, 4) + 4;
+    if (literal_count > 286 || distance_count > 30) return false;
+    
+    uint8_t lengths[320];
+    memset(lengths, 0, sizeof(lengths));
+    for (int i = 0; i < length_count; i++) lengths[order[i]] = (uint8_t)get_bits(r, 3);
+    
+    struct huffman code_lengths;
+    huffman_build(&code_lengths, lengths, 19);
+    
+    memset(lengths, 0, sizeof(lengths));
+    const int total = literal_count + distance_count;
+    int index = 0;
+    while (index < total) {
+        const int symbol = huffman_decode(r, &code_lengths);
+        if (symbol < 0 || r->overrun) return false;
+        
+        if (symbol < 16) {
+            lengths[index++] = (uint8_t)symbol;
+            continue;
+        }
+        
+        uint8_t value = 0;
+        int repeat;
+        if (symbol == 16) {
+            if (index == 0) return false;
+            value = lengths[index - 1];
+            repeat = 3 + (int)get_bits(r, 2);
+        } else if (symbol == 17) {
+            repeat = 3 + (int)get_bits(r, 3);
+        } else {
+            repeat = 11 + (int)get_bits(r, 7);
+        }
+        if (index + repeat > total) return false;
+        while (repeat-- > 0) lengths[index++] = value;
+    }
+    
+    huffman_build(literals, lengths, literal_count);
+    huffman_build(distances, lengths + literal_count, distance_count);
+    return true;
+}
+
+static bool inflate_block(struct bit_reader *r, struct buffer *out, const struct huffman *literals,
+                          const struct huffman *distances)
+{
+    for (;;) {
+        const int symbol = huffman_decode(r, literals);
+        if (symbol < 0 || r->overrun) return false;
+        
+        if (symbol < 256) {
+            const uint8_t byte = (uint8_t)symbol;
+            if (!buffer_put(out, &byte, 1)) return false;
+            continue;
+        }
+        if (symbol == 256) return true;
+        
+        const int length_code = symbol - 257;
+        if (length_code >= 29) return false;
+        const size_t length = length_base[length_code] + get_bits(r, length_extra[length_code]);
+        
+        const int distance_code = huffman_decode(r, distances);
+        if (distance_code < 0 || distance_code >= 30) return false;
+        const size_t distance = distance_base[distance_code] + get_bits(r, distance_extra[distance_code]);
+        if (distance > out->size || !buffer_reserve(out, length)) return false;
+        
+        // Byte by byte: the source may overlap the bytes being written
+        for (size_t i = 0; i < length; i++) {
+            out->data[out->size] = out->data[out->size - distance];
+            out->size++;
+        }
+    }
+}
+
+static bool inflate_stream(struct bit_reader *r, struct buffer *out)
+{
+    bool last;
+    do {
+        last = get_bits(r, 1) != 0;
+        const uint32_t type = get_bits(r, 2);
+        
+        if (type == 0) {
+            // Stored: the rest of the current byte is padding
+            r->bits = 0;
+            r->count = 0;
+            if (r->pos + 4 > r->size) return false;
+            
+            const uint32_t length = r->data[r->pos] | ((uint32_t)r->data[r->pos + 1] << 8);
+            const uint32_t complement = r->data[r->pos + 2] | ((uint32_t)r->data[r->pos + 3] << 8);
+            r->pos += 4;
+            if ((length ^ 0xFFFF) != complement || r->pos + length > r->size) return false;
+            if (!buffer_put(out, r->data + r->pos, length)) return false;
+            r->pos += length;
+        } else if (type == 1 || type == 2) {
+            struct huffman literals;
+            struct huffman distances;
+            if (type == 1) {
+                fixed_tables(&literals, &distances);
+            } else if (!dynamic_tables(r, &literals, &distances)) {
+                return false;
+            }
+            if (!inflate_block(r, out, &literals, &distances)) return false;
+        } else {
+            return false;
+        }
+    } while (!last);
+    
+    return !r->overrun;
+}
+
+// ============================================================================
+// PNG
+// ============================================================================
+
+static bool write_chunk(FILE *file, const char *type, const uint8_t *data, uint32_t size)
+{
+    uint8_t header[8];
+    write_u32_be(header, size);
+    memcpy(header + 4, type, 4);
+    
+    uint32_t crc = crc32_update(0xFFFFFFFFu, header + 4, 4);
+    if (size) crc = crc32_update(crc, data, size);
+    
+    uint8_t trailer[4];
+    write_u32_be(trailer, crc ^ 0xFFFFFFFFu);
+    
+    return fwrite(header, 1, 8, file) == 8 && (!size || fwrite(data, 1, size, file) == size) &&
+           fwrite(trailer, 1, 4, file) == 4;
+}
+
+bool golden_png_write(const char *path, const uint8_t *pixels, uint32_t width, uint32_t height)
+{
+    // Up filter on every row: rows equal to the one above become zero runs
+    const size_t stride = (size_t)width * 4;
+    const size_t filtered_size = (stride + 1) * height;
+    uint8_t *filtered = malloc(filtered_size);
+    if (!filtered) return false;
+    
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t *row = pixels + (size_t)y * stride;
+        uint8_t *dst = filtered + (size_t)y * (stride + 1);
+        dst[0] = 2;
+        for (size_t i = 0; i < stride; i++) dst[1 + i] = (uint8_t)(row[i] - (y ? row[i - stride] : 0));
+    }
+    
+    struct buffer zlib = {NULL, 0, 0};
+    static const uint8_t zlib_header[2] = {0x78, 0x01};
+    uint8_t adler[4];
+    write_u32_be(adler, adler32(filtered, filtered_size));
+    
+    bool ok = buffer_put(&zlib, zlib_header, sizeof(zlib_header)) &&
+              deflate_fixed(&zlib, filtered, filtered_size) && buffer_put(&zlib, adler, sizeof(adler));
+    free(filtered);
+    
+    uint8_t ihdr[13];
+    write_u32_be(ihdr, width);
+    write_u32_be(ihdr + 4, height);
+    ihdr[8] = 8;   // Bit depth
+    ihdr[9] = 6;   // RGBA
+    ihdr[10] = 0;  // Deflate
+    ihdr[11] = 0;  // Adaptive filtering
+    ihdr[12] = 0;  // Not interlaced
+    
+    FILE *file = ok ? fopen(path, "wb") : NULL;
+    if (file) {
+        ok = fwrite(png_signature, 1, sizeof(png_signature), file) == sizeof(png_signature) &&
+             write_chunk(file, "IHDR", ihdr, sizeof(ihdr)) &&
+             write_chunk(file, "IDAT", zlib.data, (uint32_t)zlib.size) && write_chunk(file, "IEND", NULL, 0);
+        ok = fclose(file) == 0 && ok;
+    } else {
+        ok = false;
+    }
+    
+    free(zlib.data);
+    return ok;
+}
+
+static uint8_t *read_file(const char *path, size_t *size)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file) return NULL;
+    
+    struct buffer contents = {NULL, 0, 0};
+    uint8_t chunk[65536];
+    size_t n;
+    bool ok = true;
+    while (ok && (n = fread(chunk, 1, sizeof(chunk), file)) > 0) ok = buffer_put(&contents, chunk, n);
+    fclose(file);
+    
+    if (!ok) {
+        free(contents.data);
+        return NULL;
+    }
+    *size = contents.size;
+    return contents.data;
+}
+
+static int paeth(int a, int b, int c)
+{
+    const int p = a + b - c;
+    const int pa = abs(p - a);
+    const int pb = abs(p - b);
+    const int pc = abs(p - c);
+    if (pa <= pb && pa <= pc) return a;
+    return pb <= pc ? b : c;
+}
+
+static bool unfilter(const uint8_t *data, size_t size, uint8_t *pixels, uint32_t width, uint32_t height)
+{
+    const size_t stride = (size_t)width * 4;
+    if (size < (stride + 1) * height) return false;
+    
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t filter = data[(size_t)y * (stride + 1)];
+        const uint8_t *src = data + (size_t)y * (stride + 1) + 1;
+        uint8_t *row = pixels + (size_t)y * stride;
+        const uint8_t *up = y ? row - stride : NULL;
+        
+        for (size_t i = 0; i < stride; i++) {
+            const int a = i >= 4 ? row[i - 4] : 0;
+            const int b = up ? up[i] : 0;
+            const int c = up && i >= 4 ? up[i - 4] : 0;
+            int predictor;
+            switch (filter) {
+                case 0:
+                    predictor = 0;
+                    break;
+                case 1:
+                    predictor = a;
+                    break;
+                case 2:
+                    predictor = b;
+                    break;
+                case 3:
+                    predictor = (a + b) / 2;
+                    break;
+                case 4:
+                    predictor = paeth(a, b, c);
+                    break;
+                default:
+                    return false;
+            }
+            row[i] = (uint8_t)(src[i] + predictor);
+        }
+    }
+    return true;
+}
+
+uint8_t *golden_png_read(const char *path, uint32_t *width, uint32_t *height)
+{
+    size_t size = 0;
+    uint8_t *file = read_file(path, &size);
+    if (!file) return NULL;
+    
+    struct buffer idat = {NULL, 0, 0};
+    struct buffer raw = {NULL, 0, 0};
+    uint8_t *pixels = NULL;
+    uint32_t w = 0;
+    uint32_t h = 0;
+    bool header_ok = false;
+    bool ok = size >= sizeof(png_signature) && memcmp(file, png_signature, sizeof(png_signature)) == 0;
+    
+    // Chunks: length, type, data, CRC over type and data
+    size_t pos = sizeof(png_signature);
+    while (ok && pos + 12 <= size) {
+        const uint32_t length = read_u32_be(file + pos);
+        const uint8_t *type = file + pos + 4;
+        const uint8_t *data = file + pos + 8;
+        if (length > size - pos - 12) {
+            ok = false;
+            break;
+        }
+        if ((crc32_update(0xFFFFFFFFu, type, (size_t)length + 4) ^ 0xFFFFFFFFu) != read_u32_be(data + length)) {
+            ok = false;
+            break;
+        }
+        
+        if (memcmp(type, "IHDR", 4) == 0 && length == 13) {
+            w = read_u32_be(data);
+            h = read_u32_be(data + 4);
+            header_ok = data[8] == 8 && data[9] == 6 && data[10] == 0 && data[11] == 0 && data[12] == 0;
+        } else if (memcmp(type, "IDAT", 4) == 0) {
+            ok = buffer_put(&idat, data, length);
+        } else if (memcmp(type, "IEND", 4) == 0) {
+            break;
+        }
+        pos += (size_t)length + 12;
+    }
+    
+    // zlib: deflate, no preset dictionary, header check bits
+    ok = ok && header_ok && w && h && idat.size >= 6 && (idat.data[0] & 0x0F) == 8 &&
+         !(idat.data[1] & 0x20) && ((idat.data[0] << 8) | idat.data[1]) % 31 == 0;
+    if (ok) {
+        struct bit_reader reader = {idat.data + 2, idat.size - 6, 0, 0, 0, false};
+        ok = inflate_stream(&reader, &raw) && adler32(raw.data, raw.size) == read_u32_be(idat.data + idat.size - 4);
+    }
+    if (ok) {
+        pixels = malloc((size_t)w * h * 4);
+        ok = pixels && unfilter(raw.data, raw.size, pixels, w, h);
+    }
+    
+    free(file);
+    free(idat.data);
+    free(raw.data);
+    
+    if (!ok) {
+        free(pixels);
+        return NULL;
+    }
+    *width = w;
+    *height = h;
+    return pixels;
+}
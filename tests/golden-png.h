@@ -0,0 +1,22 @@
+#pragma once
+
+// Minimal PNG codec for the golden images: 8-bit RGBA, not interlaced.
+// The writer deflates with the fixed Huffman codes, which keeps mostly
+// transparent 4K overlays at a few hundred kilobytes; the reader inflates any
+// zlib stream, so goldens re-saved by other tools still load.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+bool golden_png_write(const char *path, const uint8_t *pixels, uint32_t width, uint32_t height);
+
+// Tightly packed RGBA8 pixels (free() them), NULL if the file is missing or unsupported
+uint8_t *golden_png_read(const char *path, uint32_t *width, uint32_t *height);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,253 @@
+// Golden-image tests for the overlay geometry and the CPU rasterizer.
+// Every case builds one layer (or safe-zone preset) with the plugin defaults at
+// 1080p and 4K, rasterizes it and compares the result with
+// <golden dir>/<case>-<size>.png. Nothing here links against libobs.
+//
+//     overlay-golden-tests [--update] <golden dir> [<case>-<size> ...]
+//
+// --update rewrites the goldens instead of comparing. A failing case writes its
+// output next to the working directory as <case>-<size>.actual.png.
+
+#include "golden-png.h"
+#include "overlay-geometry.h"
+#include "overlay-raster.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Per-channel difference tolerated for float rounding across compilers
+#define GOLDEN_TOLERANCE 2
+
+#define ALL_LAYERS ((1u << OVERLAY_LAYER_COUNT) - 1)
+
+struct golden_case {
+    const char *name;
+    uint32_t layers;
+    int safe_zone_type;  // 0 mobile, 1 desktop, 2 broadcast, 3 custom
+    int grid_lod;
+    bool grid_halfway;
+};
+
+struct golden_size {
+    const char *name;
+    uint32_t width;
+    uint32_t height;
+};
+
+static const struct golden_case golden_cases[] = {
+    {"center_guides", OVERLAY_LAYER_BIT(OVERLAY_LAYER_CENTER_GUIDES), 1, 0, false},
+    {"rule_of_thirds", OVERLAY_LAYER_BIT(OVERLAY_LAYER_RULE_OF_THIRDS), 1, 0, false},
+    {"material_grid", OVERLAY_LAYER_BIT(OVERLAY_LAYER_MATERIAL_GRID), 1, 0, false},
+    {"material_grid_lod4", OVERLAY_LAYER_BIT(OVERLAY_LAYER_MATERIAL_GRID), 1, 4, false},
+    {"material_grid_lod4_halfway", OVERLAY_LAYER_BIT(OVERLAY_LAYER_MATERIAL_GRID), 1, 4, true},
+    {"bootstrap_grid", OVERLAY_LAYER_BIT(OVERLAY_LAYER_BOOTSTRAP_GRID), 1, 0, false},
+    {"custom_layout", OVERLAY_LAYER_BIT(OVERLAY_LAYER_CUSTOM), 1, 0, false},
+    {"crosshair", OVERLAY_LAYER_BIT(OVERLAY_LAYER_CROSSHAIR), 1, 0, false},
+    {"branding", OVERLAY_LAYER_BIT(OVERLAY_LAYER_BRANDING), 1, 0, false},
+    {"safe_zone_mobile", OVERLAY_LAYER_BIT(OVERLAY_LAYER_SAFE_ZONES), 0, 0, false},
+    {"safe_zone_desktop", OVERLAY_LAYER_BIT(OVERLAY_LAYER_SAFE_ZONES), 1, 0, false},
+    {"safe_zone_broadcast", OVERLAY_LAYER_BIT(OVERLAY_LAYER_SAFE_ZONES), 2, 0, false},
+    {"safe_zone_custom", OVERLAY_LAYER_BIT(OVERLAY_LAYER_SAFE_ZONES), 3, 0, false},
+    {"all_layers", ALL_LAYERS, 1, 0, false},
+};
+
+static const struct golden_size golden_sizes[] = {
+    {"1080p", 1920, 1080},
+    {"2160p", 3840, 2160},
+};
+
+// A small custom layout in 1920x1080 reference pixels: margins, a header band
+// and a lower-third box
+static const struct overlay_line custom_lines[] = {
+    {96.0f, 0.0f, 96.0f, 1080.0f, 0xB300BCD4},
+    {1824.0f, 0.0f, 1824.0f, 1080.0f, 0xB300BCD4},
+    {0.0f, 120.0f, 1920.0f, 120.0f, 0xB3E91E63},
+    {192.0f, 780.0f, 1200.0f, 780.0f, 0xB3FFC107},
+    {1200.0f, 780.0f, 1200.0f, 960.0f, 0xB3FFC107},
+    {1200.0f, 960.0f, 192.0f, 960.0f, 0xB3FFC107},
+    {192.0f, 960.0f, 192.0f, 780.0f, 0xB3FFC107},
+};
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+
+// Same values as design_overlay_get_defaults()
+static void default_params(struct overlay_params *params, const struct golden_case *gc,
+                           const struct golden_size *size)
+{
+    memset(params, 0, sizeof(*params));
+    params->canvas_width = size->width;
+    params->canvas_height = size->height;
+    params->material_grid_size = 8;
+    params->grid_lod = gc->grid_lod;
+    params->grid_halfway = gc->grid_halfway;
+    params->bootstrap_columns = 12;
+    params->bootstrap_gutter = 30.0f;
+    params->safe_zone_type = gc->safe_zone_type;
+    params->custom_safe_zone_percent = 0.85f;
+    params->grid_opacity = 0.30f;
+    params->safe_zone_opacity = 0.70f;
+    params->crosshair_opacity = 0.90f;
+    params->grid_color = COLOR_GRID_BLUE;
+    params->safe_zone_color = COLOR_SAFE_ORANGE;
+    params->measurement_labels = true;
+    
+    params->custom_layout_id = 1;
+    params->custom_lines = custom_lines;
+    params->custom_line_count = sizeof(custom_lines) / sizeof(custom_lines[0]);
+    params->custom_scale_x = (float)size->width / 1920.0f;
+    params->custom_scale_y = (float)size->height / 1080.0f;
+}
+
+static bool render_case(struct overlay_image *image, const struct golden_case *gc, const struct golden_size *size,
+                        double *build_ms, double *raster_ms)
+{
+    struct overlay_params params;
+    default_params(&params, gc, size);
+    
+    if (!overlay_image_init(image, size->width, size->height)) return false;
+    overlay_image_clear(image, 0);
+    
+    struct overlay_prim_list prims;
+    overlay_prims_init(&prims);
+    
+    double start = now_ms();
+    geometry_build(&prims, &params, gc->layers, 0);
+    *build_ms = now_ms() - start;
+    
+    start = now_ms();
+    overlay_raster_prims(image, &prims);
+    *raster_ms = now_ms() - start;
+    
+    overlay_prims_free(&prims);
+    return true;
+}
+
+static bool compare_images(const struct overlay_image *image, const uint8_t *golden, uint32_t width,
+                           uint32_t height, const char *id)
+{
+    if (width != image->width || height != image->height) {
+        fprintf(stderr, "%s: golden is %ux%u, rendered %ux%u\n", id, width, height, image->width, image->height);
+        return false;
+    }
+    
+    size_t mismatches = 0;
+    uint32_t first_x = 0;
+    uint32_t first_y = 0;
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t *row = image->pixels + (size_t)y * image->linesize;
+        const uint8_t *expected = golden + (size_t)y * width * 4;
+        for (uint32_t x = 0; x < width * 4; x++) {
+            if (abs((int)row[x] - (int)expected[x]) <= GOLDEN_TOLERANCE) continue;
+            if (!mismatches) {
+                first_x = x / 4;
+                first_y = y;
+            }
+            mismatches++;
+            x |= 3;  // Count pixels, not channels
+        }
+    }
+    
+    if (mismatches) {
+        fprintf(stderr, "%s: %zu pixels differ, first at (%u, %u)\n", id, mismatches, first_x, first_y);
+        return false;
+    }
+    return true;
+}
+
+static bool run_case(const struct golden_case *gc, const struct golden_size *size, const char *golden_dir,
+                     bool update)
+{
+    char id[64];
+    char path[1024];
+    snprintf(id, sizeof(id), "%s-%s", gc->name, size->name);
+    snprintf(path, sizeof(path), "%s/%s.png", golden_dir, id);
+    
+    struct overlay_image image;
+    double build_ms = 0.0;
+    double raster_ms = 0.0;
+    if (!render_case(&image, gc, size, &build_ms, &raster_ms)) {
+        fprintf(stderr, "%s: out of memory\n", id);
+        return false;
+    }
+    
+    bool ok;
+    if (update) {
+        ok = golden_png_write(path, image.pixels, image.width, image.height);
+        if (!ok) fprintf(stderr, "%s: cannot write '%s'\n", id, path);
+    } else {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint8_t *golden = golden_png_read(path, &width, &height);
+        if (golden) {
+            ok = compare_images(&image, golden, width, height, id);
+            free(golden);
+        } else {
+            fprintf(stderr, "%s: cannot read '%s' (run with --update to create it)\n", id, path);
+            ok = false;
+        }
+        
+        if (!ok) {
+            char actual[128];
+            snprintf(actual, sizeof(actual), "%s.actual.png", id);
+            golden_png_write(actual, image.pixels, image.width, image.height);
+        }
+    }
+    
+    printf("%-32s build %8.3f ms  raster %8.3f ms  %s\n", id, build_ms, raster_ms,
+           ok ? (update ? "updated" : "ok") : "FAILED");
+    
+    overlay_image_free(&image);
+    return ok;
+}
+
+static bool selected(const char *id, int argc, char **argv, int first)
+{
+    if (first >= argc) return true;
+    
+    for (int i = first; i < argc; i++) {
+        if (strcmp(argv[i], id) == 0) return true;
+    }
+    return false;
+}
+
+int main(int argc, char **argv)
+{
+    int arg = 1;
+    bool update = false;
+    if (arg < argc && strcmp(argv[arg], "--update") == 0) {
+        update = true;
+        arg++;
+    }
+    if (arg >= argc) {
+        fprintf(stderr, "usage: %s [--update] <golden dir> [<case>-<size> ...]\n", argv[0]);
+        return 2;
+    }
+    const char *golden_dir = argv[arg++];
+    
+    int run = 0;
+    int failed = 0;
+    for (size_t c = 0; c < sizeof(golden_cases) / sizeof(golden_cases[0]); c++) {
+        for (size_t s = 0; s < sizeof(golden_sizes) / sizeof(golden_sizes[0]); s++) {
+            char id[64];
+            snprintf(id, sizeof(id), "%s-%s", golden_cases[c].name, golden_sizes[s].name);
+            if (!selected(id, argc, argv, arg)) continue;
+            
+            run++;
+            if (!run_case(&golden_cases[c], &golden_sizes[s], golden_dir, update)) failed++;
+        }
+    }
+    
+    if (!run) {
+        fprintf(stderr, "no matching cases\n");
+        return 2;
+    }
+    printf("%d of %d cases passed\n", run - failed, run);
+    return failed ? 1 : 0;
+}